@@ -0,0 +1,191 @@
+/*
+ User: Redskaber
+ Date: 2024/1/25
+ Time: 10:32
+*/
+#include "banker_admission.h"
+
+
+/**
+ * @brief Grants a BankProConBlock its whole remaining need if the available resources cover it.
+ *
+ * This function compares the Need row of the BankProConBlock with the Available vector of the dense BankerState, O(m).
+ * If every needed resource is available, the need is moved to the assigned resources and subtracted from the available resources.
+ * The BankProConBlock then holds its maximum claim and never waits again, so it can always finish and the state stays safe;
+ * no full safety check is needed.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param bankProConBlock Pointer to the BankProConBlock to be admitted.
+ * @return Boolean value indicating whether the BankProConBlock was admitted.
+ */
+_Bool admitBankProConBlock(Banker *banker, BankProConBlock *bankProConBlock) {
+
+    BankerState *state = banker->state;
+    const int32_t *needRow = bankerStateRow(state, needMatrix, bankProConBlock->row);
+    for (int j = 0; j < state->columns; ++j) {
+        if (needRow[j] > state->available[j]) {
+            return false;
+        }
+    }
+
+    int types = banker->state->columns;
+    int *available[types];
+    indexBaseAllocateArr(banker->availableResource, types, available);
+    BaseAllocateArr *needResource = bankProConBlock->resource->needResource;
+    for (int i = 0; i < needResource->member; ++i) {
+        int *number = available[needResource->array[i]->type];
+        if (number != NULL) {
+            *number -= needResource->array[i]->number;
+        }
+        bankProConBlock->resource->assignedResource->array[i]->number += needResource->array[i]->number;
+        needResource->array[i]->number = 0;
+    }
+    syncBankProConBlockToBanker(banker, bankProConBlock);
+    return true;
+}
+
+/**
+ * @brief Returns every resource assigned to a BankProConBlock to the available resources.
+ *
+ * After the release the need of the BankProConBlock is its maximum claim again.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param bankProConBlock Pointer to the BankProConBlock releasing its resources.
+ */
+void releaseBankProConBlock(Banker *banker, BankProConBlock *bankProConBlock) {
+
+    int types = banker->state->columns;
+    int *available[types];
+    indexBaseAllocateArr(banker->availableResource, types, available);
+
+    AllocatorResource *resource = bankProConBlock->resource;
+    for (int i = 0; i < resource->assignedResource->member; ++i) {
+        int *number = available[resource->assignedResource->array[i]->type];
+        if (number != NULL) {
+            *number += resource->assignedResource->array[i]->number;
+        }
+        resource->assignedResource->array[i]->number = 0;
+        resource->needResource->array[i]->number = resource->maxResource->array[i]->number;
+    }
+    syncBankProConBlockToBanker(banker, bankProConBlock);
+}
+
+// 当前线程挂接的银行家准入检查
+static _Thread_local ScheduleAdmission bankerAdmission;
+
+
+/**
+ * @brief Finds the BankProConBlock of a dispatched ProConBlock.
+ *
+ * Several BankProConBlocks may share a p_id, so the one whose base is the ProConBlock is looked for.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param proConBlock Pointer to the dispatched ProConBlock.
+ * @return Pointer to the BankProConBlock, NULL if the ProConBlock does not belong to the Banker.
+ */
+static BankProConBlock *findDispatchedBankProConBlock(Banker *banker, ProConBlock *proConBlock) {
+
+    BankProConBlock *bankProConBlock = getProcess(banker->index, proConBlock->p_id);
+    while (bankProConBlock != NULL && bankProConBlock->base != proConBlock) {
+        bankProConBlock = nextProcess(banker->index, proConBlock->p_id, bankProConBlock);
+    }
+    return bankProConBlock;
+}
+
+/**
+ * @brief Admission check of the dispatch path, see attachScheduleBanker.
+ *
+ * A BankProConBlock whose Need row is already zero holds its whole claim from an earlier slice and runs without touching the Banker;
+ * otherwise it is admitted through admitBankProConBlock. ProConBlocks that do not belong to the Banker always run.
+ */
+static _Bool admitDispatchedBankProConBlock(void *context, ProConBlock *proConBlock) {
+
+    Banker *banker = context;
+    BankProConBlock *bankProConBlock = findDispatchedBankProConBlock(banker, proConBlock);
+    if (bankProConBlock == NULL) {
+        return true;
+    }
+    const int32_t *needRow = bankerStateRow(banker->state, needMatrix, bankProConBlock->row);
+    for (int j = 0; j < banker->state->columns; ++j) {
+        if (needRow[j] != 0) {
+            return admitBankProConBlock(banker, bankProConBlock);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Release of the dispatch path: a finished ProConBlock returns every resource it was admitted with.
+ */
+static void releaseDispatchedBankProConBlock(void *context, ProConBlock *proConBlock) {
+
+    Banker *banker = context;
+    BankProConBlock *bankProConBlock = findDispatchedBankProConBlock(banker, proConBlock);
+    if (bankProConBlock != NULL) {
+        releaseBankProConBlock(banker, bankProConBlock);
+    }
+}
+
+/**
+ * @brief Attaches a Banker as the ScheduleAdmission of the calling thread.
+ *
+ * While a Banker is attached, every slice dispatched by executeOver or runningProConBlockTask is admitted through it:
+ * the first slice of a BankProConBlock is granted its whole remaining need if the available resources cover it, later slices run directly,
+ * and the resources are released when the ProConBlock finishes. A refused ProConBlock is requeued by the scheduling function.
+ * The BankProConBlocks stay in the Banker after they finished; the caller removes them.
+ *
+ * @param banker Pointer to the Banker to be attached, NULL to stop checking.
+ */
+void attachScheduleBanker(Banker *banker) {
+
+    if (banker == NULL) {
+        attachScheduleAdmission(NULL);
+        return;
+    }
+    bankerAdmission.admit = admitDispatchedBankProConBlock;
+    bankerAdmission.release = releaseDispatchedBankProConBlock;
+    bankerAdmission.context = banker;
+    attachScheduleAdmission(&bankerAdmission);
+}
+
+/**
+ * @brief Dispatches the ProConBlocks of a ProConBlockLink with a scheduling policy, admitting every slice through the Banker.
+ *
+ * This function attaches the Banker (attachScheduleBanker) and runs the policy with runningProConBlockFromLink, so the admission check
+ * happens where the policy dispatches: executeOver retries refused ProConBlocks after every release, round robin rotates them,
+ * priority aging holds them back until a ProConBlock finishes. Every ProConBlock must belong to a BankProConBlock of the Banker.
+ * Afterwards the finished ProConBlocks are removed from the ProConBlockLink and from the Banker.
+ *
+ * ProConBlocks that could never be admitted (the state is unsafe) stay blocked in the ProConBlockLink and in the Banker.
+ *
+ * @param banker Pointer to the Banker structure owning the BankProConBlocks.
+ * @param proConBlockLink Pointer to the ProConBlockLink of ready ProConBlocks.
+ * @param proSortFunc Function pointer to the sorting function of the policy. If NULL, defaults to firstComeFirstServe.
+ * @param proExeFunc Function pointer to the execution function of the policy. If NULL, defaults to executeOver.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @return Boolean value indicating whether every ProConBlock was admitted and executed.
+ */
+_Bool bankerAdmissionScheduling(
+        Banker *banker,
+        ProConBlockLink *proConBlockLink,
+        void (*proSortFunc)(ProConBlockLink *sortLink),
+        void (*proExeFunc)(ProConBlockLink *exeLink),
+        SystemResource *systemResource
+) {
+    attachScheduleBanker(banker);
+    runningProConBlockFromLink(proConBlockLink, proSortFunc, proExeFunc);
+    attachScheduleBanker(NULL);
+
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        ProConBlock *aftProConBlock = proConBlock->aftProConBlock;
+        if (proConBlock->p_state != blocked) {
+            BankProConBlock *bankProConBlock = findDispatchedBankProConBlock(banker, proConBlock);
+            assert(bankProConBlock != NULL);
+            detachProConBlockFromLink(proConBlockLink, proConBlock);
+            removeBankProConBlockFromBanker(banker, bankProConBlock, systemResource);
+        }
+        proConBlock = aftProConBlock;
+    }
+    return proConBlockLink->headProConBlock->aftProConBlock == NULL;
+}
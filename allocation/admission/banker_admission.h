@@ -0,0 +1,46 @@
+/*
+ User: Redskaber
+ Date: 2024/1/25
+ Time: 10:32
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_BANKER_ADMISSION_H
+#define OPERATORSYSTEM_BANKER_ADMISSION_H
+/*
+ * 资源感知的进程准入(调度 + 银行家)
+        任何调度策略排好顺序后, 派发一个 BankProConBlock 之前先问银行家:
+            need <= available   准入: 一次性把剩余需求 need 全部分配给它, 运行到结束, 归还全部资源;
+            否则                 推迟: 进程标记为 blocked 不运行, 由调度函数重新排队, 有进程归还资源后重试。
+
+        为什么不用每次派发都做 O(n²m) 的安全性检查:
+            准入的进程拿到了自己的全部最大需求, 不会再等待任何资源, 一定能运行结束并归还资源;
+            所以 "need <= available 就整体分配" 永远不会让已准入的进程死锁, 原来安全的状态分配后仍然安全
+            (把它放到原安全序列的最前面即可)。每次准入只需比较一行 need 与 available, O(m)。
+
+        最后仍无法准入的进程说明系统处于不安全状态, 它们以 blocked 状态留在就绪链中, 交给调用者处理。
+
+        准入检查挂在派发路径上: attachScheduleBanker 把银行家作为当前线程的 ScheduleAdmission 挂接,
+        executeOver / runningProConBlockTask 每次派发前检查, 所以 FCFS / SJN / 优先级 / 时间片轮转 / 老化 / 分组公平调度都经过银行家;
+        第一次派发时整体分配(之后 need 为 0, 后续时间片直接放行), 运行结束时归还。被拒绝的进程由各调度函数重新排队。
+        不属于银行家的进程不受限制。
+ */
+
+#include "../banker.h"
+#include "../../process/stats/schedule_stats.h"
+
+
+extern _Bool admitBankProConBlock(Banker *banker, BankProConBlock *bankProConBlock);
+
+extern void releaseBankProConBlock(Banker *banker, BankProConBlock *bankProConBlock);
+
+extern void attachScheduleBanker(Banker *banker);
+
+extern _Bool bankerAdmissionScheduling(
+        Banker *banker,
+        ProConBlockLink *proConBlockLink,
+        void (*proSortFunc)(ProConBlockLink *sortLink),
+        void (*proExeFunc)(ProConBlockLink *exeLink),
+        SystemResource *systemResource
+);
+
+#endif //OPERATORSYSTEM_BANKER_ADMISSION_H
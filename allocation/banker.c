@@ -4,18 +4,7 @@
  Time: 15:13
 */
 #include "banker.h"
-
-static void initHashMap(HashMap *map, BaseAllocateArr *availableResource);
-
-static _Bool canBeAllocated(BaseAllocateArr *needResource, BaseAllocateArr *availableResource);
-
-static BankProConBlock *deepCopyBankProConBlock(BankProConBlock *bankProConBlock, SystemResource *systemResource);
-
-static void deepCopyAllocatorResource(
-        AllocatorResource *destResource,
-        AllocatorResource *sourceResource,
-        SystemResource *systemResource
-);
+#include "sorted/sorted_safety.h"
 
 
 /**
@@ -144,6 +133,7 @@ BankProConBlock *initBankProConBlock(
     assert(newBankProConBlock != NULL);
     newBankProConBlock->base = initProConBlock(p_id, p_name, p_total_time, p_priority, callBack, allocator);
     newBankProConBlock->resource = initAllocatorResource(allocator);
+    newBankProConBlock->row = -1;
 
     return newBankProConBlock;
 }
@@ -164,6 +154,7 @@ BankProConBlock *initBankProConBlockUsed(ProConBlock *proConBlock, Allocator *al
     assert(newBankProConBlock != NULL);
     newBankProConBlock->base = proConBlock;
     newBankProConBlock->resource = initAllocatorResource(allocator);
+    newBankProConBlock->row = -1;
 
     return newBankProConBlock;
 }
@@ -206,8 +197,11 @@ void destroyBankProConBlock(BankProConBlock *bankProConBlock, Allocator *allocat
  *
  * This function allocates memory for a new Banker structure and initializes its fields.
  * It sets the size to 0 and the maxSize to BANKER_INIT_ARRAY_MEMBER.
- * It also allocates memory for the array of BankProConBlock pointers and initializes the availableResource array.
- * The availableResource array is initialized with the provided availableResourceArr 2D array.
+ * It also allocates memory for the array of BankProConBlock pointers, creates the p_id index and initializes the availableResource array.
+ * The availableResource array is initialized with the provided availableResourceArr 2D array and copied into the Available vector of the dense BankerState.
+ * The dense BankerState has a column for every built-in type and every registered type up to the highest one in availableResourceArr,
+ * so a Banker of a few registered types does not pay for every type ever registered. Processes may only use types within these columns;
+ * a type a process needs but the system does not offer yet is listed in availableResourceArr with 0.
  *
  * @param availableResourceArr 2D array of available resources.
  * @param rows Number of rows in the availableResourceArr array.
@@ -230,9 +224,20 @@ Banker *initBanker(
     size_t initSize = newBanker->maxSize * sizeof(BankProConBlock *);
     newBanker->array = systemResource->memory->allocate(systemResource->memory, initSize);
     assert(newBanker->array != NULL);
+    newBanker->index = createHashMapProcess(newBanker->maxSize);
+    newBanker->workspace = NULL;
 
     newBanker->availableResource = initBaseAllocateArr(systemResource->memory, newBanker->maxSize);
 
+    // the columns cover the built-in types and every type up to the highest one in the available resources
+    int types = RESOURCE_TYPE_BUILTIN;
+    for (int i = 0; i < rows; ++i) {
+        int type = (int) availableResourceArr[i][0];
+        assert(type < resourceTypeCount());
+        types = type + 1 > types ? type + 1 : types;
+    }
+    newBanker->state = initBankerState(bankerStateColumns(types), systemResource->memory);
+
     if (rows > 0) {
         initResourceArr(
                 newBanker->availableResource, rows,
@@ -240,6 +245,7 @@ Banker *initBanker(
                 systemResource->memory
         );
     }
+    loadBankerStateAvailable(newBanker->state, newBanker->availableResource);
     return newBanker;
 }
 
@@ -249,7 +255,7 @@ Banker *initBanker(
  * This function deallocates the memory used by the Banker structure.
  * It first checks if the Banker pointer is not NULL.
  * If it is not NULL, it iterates over the array of BankProConBlock pointers and destroys each BankProConBlock.
- * It then deallocates the memory used by the array of BankProConBlock pointers and the availableResource array in the Banker structure.
+ * It then deallocates the memory used by the array of BankProConBlock pointers, the p_id index, the dense BankerState, the BankerWorkspace and the availableResource array in the Banker structure.
  * Finally, it deallocates the memory used by the Banker structure itself and sets the Banker pointer to NULL.
  *
  * @param banker Pointer to the Banker structure to be destroyed.
@@ -265,6 +271,10 @@ void destroyBanker(Banker *banker, SystemResource *systemResource) {
             size_t arrSize = sizeof(BankProConBlock *) * banker->maxSize;
             systemResource->memory->deallocate(systemResource->memory, banker->array, arrSize);
         }
+        destroyHashMapProcess(banker->index);
+        destroyBankerState(banker->state, systemResource->memory);
+        destroyBankerSafetyCache(bankerSafetyCacheOf(banker), systemResource->memory);
+        destroyBankerWorkspace(banker->workspace, systemResource->memory);
         destroyBaseAllocateArr(banker->availableResource, systemResource->memory);
         systemResource->memory->deallocate(systemResource->memory, banker, sizeof(Banker));
         banker = NULL;
@@ -304,7 +314,10 @@ static _Bool upCapacityBankerProConBlockArr(Banker *banker, SystemResource *syst
  *
  * This function adds a BankProConBlock to the array of BankProConBlock pointers in the Banker structure.
  * If the size of the array is equal to or greater than its maximum size, the function increases the capacity of the array.
- * The BankProConBlock is then added to the end of the array and the size of the array is incremented.
+ * The BankProConBlock is then added to the end of the array, registered in the p_id index and the size of the array is incremented.
+ * Its resources are appended as a new row of the dense BankerState and the BankerWorkspace, created with the first process, grows with the rows if needed.
+ * The Available vector is reloaded because pushProConBlockArrToBanker
+ * takes the assigned resources from the available resources before pushing.
  *
  * @param banker Pointer to the Banker structure to which the BankProConBlock is to be added.
  * @param bankProConBlock Pointer to the BankProConBlock to be added.
@@ -314,62 +327,89 @@ void pushProConBlockToBanker(Banker *banker, BankProConBlock *bankProConBlock, S
     if (banker->size >= banker->maxSize) {
         assert(upCapacityBankerProConBlockArr(banker, systemResource) == true);
     }
+    bankProConBlock->row = banker->size;
     banker->array[banker->size++] = bankProConBlock;
+    appendProcess(banker->index, bankProConBlock->base->p_id, bankProConBlock);
+    _Bool fresh = leaveBankerSafetyHash(bankerSafetyCacheOf(banker), banker->state, -1);
+    pushBankerStateRow(banker->state, bankProConBlock->resource, systemResource->memory);
+    if (banker->workspace == NULL) {
+        banker->workspace = initBankerWorkspace(banker->state->columns, systemResource->memory);
+    }
+    reserveBankerWorkspace(banker->workspace, banker->size, systemResource->memory);
+    pushBankerWitnessRow(banker->workspace, bankProConBlock->row);
+    loadBankerStateAvailable(banker->state, banker->availableResource);
+    enterBankerSafetyHash(bankerSafetyCacheOf(banker), banker->state, bankProConBlock->row, fresh);
+}
+
+/**
+ * @brief Copies the resources of a BankProConBlock and the available resources of the Banker into the dense BankerState.
+ *
+ * Every change of the BaseAllocateArr cells of a BankProConBlock or of the available resources must be followed by this call, O(m).
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param bankProConBlock Pointer to the BankProConBlock whose resources have changed.
+ */
+void syncBankProConBlockToBanker(Banker *banker, BankProConBlock *bankProConBlock) {
+    _Bool fresh = leaveBankerSafetyHash(bankerSafetyCacheOf(banker), banker->state, bankProConBlock->row);
+    loadBankerStateRow(banker->state, bankProConBlock->row, bankProConBlock->resource);
+    loadBankerStateAvailable(banker->state, banker->availableResource);
+    enterBankerSafetyHash(bankerSafetyCacheOf(banker), banker->state, bankProConBlock->row, fresh);
+}
+
+/**
+ * @brief Finds a BankProConBlock in the Banker structure by its process ID.
+ *
+ * This function looks the process ID up in the p_id index of the Banker instead of scanning the array of BankProConBlock pointers.
+ *
+ * @param banker Pointer to the Banker structure to be searched.
+ * @param p_id The process ID of the BankProConBlock.
+ * @return Pointer to the BankProConBlock if found, NULL otherwise.
+ */
+BankProConBlock *findBankProConBlockFromBanker(Banker *banker, int p_id) {
+    return getProcess(banker->index, p_id);
 }
 
 /**
  * @brief Removes a BankProConBlock from the Banker structure and destroys it.
  *
- * This function removes a BankProConBlock from the array of BankProConBlock pointers in the Banker structure.
- * It first finds the index of the BankProConBlock in the array. If the BankProConBlock is not found, the function returns without doing anything.
- * Otherwise, it shifts all BankProConBlocks after the removed one to fill the gap left by the removed BankProConBlock.
- * It then decrements the size of the array and destroys the removed BankProConBlock.
+ * This function finds the BankProConBlock by its row, so a BankProConBlock that is not in the Banker is left alone.
+ * The last BankProConBlock of the array moves into the freed place, and the dense BankerState moves its last row the same way (swap-remove),
+ * so nothing else is shifted. The safe sequence witness keeps the order of the remaining processes.
+ * It then removes the BankProConBlock from the p_id index and destroys it. Apart from destroying the BankProConBlock, the removal is O(m).
  *
  * @param banker Pointer to the Banker structure from which the BankProConBlock is to be removed.
  * @param bankProConBlock Pointer to the BankProConBlock to be removed.
  * @param systemResource Pointer to the SystemResource structure used for memory management.
  */
 void removeBankProConBlockFromBanker(Banker *banker, BankProConBlock *bankProConBlock, SystemResource *systemResource) {
-    int index = -1;
-    for (int i = 0; i < banker->size; ++i) {
-        if (banker->array[i] == bankProConBlock) {
-            index = i;
-            break;
-        }
-    }
-    if (index == -1) {
+    int index = bankProConBlock->row;
+    if (index < 0 || index >= banker->size || banker->array[index] != bankProConBlock) {
         return;
     }
 
-    for (int i = index; i < banker->size - 1; ++i) {
-        banker->array[i] = banker->array[i + 1];
-    }
+    int last = banker->size - 1;
+    banker->array[index] = banker->array[last];
+    banker->array[index]->row = index;
+    banker->array[last] = NULL;
     banker->size -= 1;
-    destroyBankProConBlock(bankProConBlock, systemResource->memory);
-}
-
-/**
- * @brief Initializes a HashMapResource with the available resources.
- *
- * This function iterates over the available resources and inserts each one into the HashMapResource.
- * The resource type is used as the key and the address of the quantity of the resource is used as the value.
- *
- * @param mapResource Pointer to the HashMapResource to be initialized.
- * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
- */
-static void initHashMapResource(HashMapResource *mapResource, BaseAllocateArr *availableResource) {
-    for (int i = 0; i < availableResource->member; ++i) {
-        char *key = resourceTypeToString(availableResource->array[i]->type);
-        int *value = &availableResource->array[i]->number;
-        insertResource(mapResource, key, value);
+    removeBankerWitnessRow(banker->workspace, index, last);
+    BankerSafetyCache *cache = bankerSafetyCacheOf(banker);
+    _Bool fresh = leaveBankerSafetyHash(cache, banker->state, index);
+    if (fresh && index != last) {
+        toggleBankerSafetyRow(cache, banker->state, last);
     }
+    removeBankerStateRow(banker->state, index);
+    enterBankerSafetyHash(cache, banker->state, index != last ? index : -1, fresh);
+    removeProcessValue(banker->index, bankProConBlock->base->p_id, bankProConBlock);
+    bankProConBlock->row = -1;
+    destroyBankProConBlock(bankProConBlock, systemResource->memory);
 }
 
 /**
  * @brief Checks whether resources can be allocated.
  *
  * This function checks if the resources requested by a process can be allocated from the available resources.
- * It creates a HashMapResource from the available resources, where each resource type is a key and its quantity is the value.
+ * It indexes the available resources by resource type on the stack, so every requested resource is looked up in O(1) without allocating.
  * It then iterates over the requested resources. For each requested resource, it checks if the resource is available in sufficient quantity.
  * If the resource is available, it subtracts the requested quantity from the available quantity.
  * If the resource is not available in sufficient quantity, it rolls back the changes made to the available resources and returns false.
@@ -385,30 +425,22 @@ static _Bool whetherResourcesCanBeAllocated(
         ResourceType assignedResourceArr[rows][2],
         BaseAllocateArr *availableResource
 ) {
-    HashMapResource *mapResource = createHashMapResource(availableResource->member);
-    initHashMapResource(mapResource, availableResource);
+    int types = resourceTypeCount();
+    int *available[types];
+    indexBaseAllocateArr(availableResource, types, available);
 
-    char *key = NULL;
-    int *value = NULL;
-    _Bool flag = true;
     for (int i = 0; i < rows; ++i) {
-        key = resourceTypeToString(assignedResourceArr[i][0]);
-        value = getResource(mapResource, key);
+        int *value = available[assignedResourceArr[i][0]];
         if (value != NULL && assignedResourceArr[i][1] <= *value) {
             *value -= (int) assignedResourceArr[i][1];
         } else {
             for (int j = i - 1; j >= 0; --j) {
-                key = resourceTypeToString(assignedResourceArr[j][0]);
-                value = getResource(mapResource, key);
-                *value += (int) assignedResourceArr[j][1];
+                *available[assignedResourceArr[j][0]] += (int) assignedResourceArr[j][1];
             }
-            flag = false;
-            break;
+            return false;
         }
     }
-
-    destroyHashMapResource(mapResource);
-    return flag;
+    return true;
 }
 
 /**
@@ -460,23 +492,6 @@ void pushProConBlockArrToBanker(
     }
 }
 
-/**
- * @brief Initializes a HashMap with the available resources.
- *
- * This function iterates over the available resources and inserts each one into the HashMap.
- * The resource type is used as the key and the quantity of the resource is used as the value.
- *
- * @param map Pointer to the HashMap to be initialized.
- * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
- */
-static void initHashMap(HashMap *map, BaseAllocateArr *availableResource) {
-    for (int i = 0; i < availableResource->member; ++i) {
-        char *key = resourceTypeToString(availableResource->array[i]->type);
-        int value = availableResource->array[i]->number;
-        insert(map, key, value);
-    }
-}
-
 /**
  * @brief Initializes an array of BaseAllocateArr structures with requested resources.
  *
@@ -508,116 +523,54 @@ initRequestResourceArr(int mp, int mr, ResourceType requestResource[mp][mr][2],
     return requestResourceArr;
 }
 
-/**
- * @brief Checks whether resources can be allocated.
- *
- * This function checks if the resources requested by a process can be allocated from the available resources.
- * It creates a HashMap from the available resources, where each resource type is a key and its quantity is the value.
- * It then iterates over the requested resources. For each requested resource, it checks if the resource is available in sufficient quantity.
- * If the resource is available, it increments a counter.
- * If all requested resources can be allocated (i.e., the counter equals the number of requested resources), it returns true.
- * Otherwise, it returns false.
- *
- * @param needResource Pointer to the BaseAllocateArr structure representing the requested resources.
- * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
- * @return Boolean value indicating whether the resources can be allocated.
- */
-static _Bool canBeAllocated(BaseAllocateArr *needResource, BaseAllocateArr *availableResource) {
-    HashMap *map = createHashMap(availableResource->member);
-    initHashMap(map, availableResource);
-
-    int counter = 0;
-    for (int i = 0; i < needResource->member; ++i) {
-        char *key = resourceTypeToString(needResource->array[i]->type);
-        int resource = get(map, key);
-        if (resource != -1 && needResource->array[i]->number <= resource) {
-            counter += 1;
-        }
-    }
-    destroyHashMap(map);
-    return counter == needResource->member;
-}
-
-/**
- * @brief Simulates the allocation of resources to a process.
- *
- * This function simulates the allocation of resources to a process during its execution.
- * It creates a HashMapResource from the available resources, where each resource type is a key and its quantity is the value.
- * It then iterates over the needed resources of the process. For each needed resource, it checks if the resource is available.
- * If the resource is available, it adds the needed quantity to the assigned resources of the process.
- * After all resources have been allocated, it destroys the HashMapResource.
- *
- * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
- * @param processResource Pointer to the AllocatorResource structure representing the resources of the process.
- */
-static void
-simulatedAllocatedResourceToProcess(BaseAllocateArr *availableResource, AllocatorResource *processResource) {
-    HashMapResource *mapResource = createHashMapResource(availableResource->member);
-    initHashMapResource(mapResource, availableResource);
-    for (int i = 0; i < processResource->needResource->member; ++i) {
-        char *key = resourceTypeToString(processResource->needResource->array[i]->type);
-        int *value = getResource(mapResource, key);
-        *value += processResource->assignedResource->array[i]->number;
-    }
-    destroyHashMapResource(mapResource);
-}
-
 /**
  * @brief Simulates the request of resources by a process.
  *
  * This function simulates the request of resources by a process during its execution.
- * It creates a HashMapResource from the available resources, where each resource type is a key and its quantity is the value.
- * It then iterates over the needed resources of the process. For each needed resource, it checks if the resource is available.
- * If the resource is available, it subtracts the needed quantity from the available resources and adds it to the assigned resources of the process.
+ * It indexes the available resources by resource type on the stack, so it does not allocate.
+ * It then iterates over the needed resources of the process, subtracts the needed quantity from the available resources and adds it to the assigned resources of the process.
  * It also subtracts the needed quantity from the needed resources of the process.
- * After all resources have been requested, it destroys the HashMapResource.
  *
  * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
  * @param processResource Pointer to the AllocatorResource structure representing the resources of the process.
  */
 static void
 simulatedRequestResourceToProcess(BaseAllocateArr *availableResource, AllocatorResource *processResource) {
-    HashMapResource *mapResource = createHashMapResource(availableResource->member);
-    initHashMapResource(mapResource, availableResource);
+    int types = resourceTypeCount();
+    int *available[types];
+    indexBaseAllocateArr(availableResource, types, available);
     for (int i = 0; i < processResource->needResource->member; ++i) {
-        // check if the requested resources can be allocated
-        char *key = resourceTypeToString(processResource->needResource->array[i]->type);
-        int *value = getResource(mapResource, key);
+        int *value = available[processResource->needResource->array[i]->type];
         *value -= processResource->needResource->array[i]->number;
         // add the requested resources to the assigned resources and div need Resource
         processResource->assignedResource->array[i]->number += processResource->needResource->array[i]->number;
         processResource->needResource->array[i]->number -= processResource->needResource->array[i]->number;
     }
-    destroyHashMapResource(mapResource);
 }
 
 /**
  * @brief Simulates the release of resources by a process.
  *
  * This function simulates the release of resources by a process after it has finished executing.
- * It creates a HashMapResource from the available resources, where each resource type is a key and its quantity is the value.
- * It then iterates over the maximum resources of the process. For each resource, it checks if the resource is available.
- * If the resource is available, it adds the quantity of the resource to the available resources and subtracts it from the assigned resources of the process.
+ * It indexes the available resources by resource type on the stack, so it does not allocate.
+ * It then iterates over the maximum resources of the process, adds the quantity of each resource to the available resources and subtracts it from the assigned resources of the process.
  * It also adds the quantity of the resource to the needed resources of the process.
- * After all resources have been released, it destroys the HashMapResource.
  *
  * @param availableResource Pointer to the BaseAllocateArr structure representing the available resources.
  * @param processResource Pointer to the AllocatorResource structure representing the resources of the process.
  */
 static void
 simulatedReleaseResourceToProcess(BaseAllocateArr *availableResource, AllocatorResource *processResource) {
-    HashMapResource *mapResource = createHashMapResource(availableResource->member);
-    initHashMapResource(mapResource, availableResource);
+    int types = resourceTypeCount();
+    int *available[types];
+    indexBaseAllocateArr(availableResource, types, available);
     for (int i = 0; i < processResource->maxResource->member; ++i) {
-        // check if the requested resources can be allocated
-        char *key = resourceTypeToString(processResource->maxResource->array[i]->type);
-        int *value = getResource(mapResource, key);
+        int *value = available[processResource->maxResource->array[i]->type];
         *value += processResource->maxResource->array[i]->number;
         // div the requested resources to the assigned resources and add need Resource
         processResource->assignedResource->array[i]->number -= processResource->maxResource->array[i]->number;
         processResource->needResource->array[i]->number += processResource->maxResource->array[i]->number;
     }
-    destroyHashMapResource(mapResource);
 }
 
 /**
@@ -665,34 +618,82 @@ static void displaySafeSequence(int size, BankProConBlock *safeSequence[size]) {
 /**
  * @brief Saves the safe sequence of processes to the orderExecute array.
  *
- * This function copies the safe sequence of processes from the safeSequence array to the orderExecute array.
+ * This function maps the safe sequence of rows kept in the BankerWorkspace to the BankProConBlocks of the Banker and stores them in the orderExecute array.
  * The safe sequence is a sequence of processes that can finish without leading to a deadlock.
  * If the orderExecute array is NULL, the function returns without doing anything.
- * Otherwise, it first sets all elements of the orderExecute array to 0.
- * It then iterates over the safeSequence array and copies each process to the corresponding position in the orderExecute array.
  *
- * @param size The number of processes in the safeSequence and orderExecute arrays.
+ * @param banker Pointer to the Banker structure whose BankProConBlocks form the sequence.
  * @param orderExecute Pointer to the array where the safe sequence will be stored.
- * @param safeSequence Array of pointers to the BankProConBlock structures representing the safe sequence of processes.
+ * @param sequence Array of the rows of the safe sequence.
  */
 static void
-saveSafeSequenceToOrderExecute(int size, BankProConBlock *(*orderExecute)[size], BankProConBlock *safeSequence[size]) {
+saveSafeSequenceToOrderExecute(Banker *banker, BankProConBlock *(*orderExecute)[banker->size], const int *sequence) {
     if (orderExecute == NULL)
         return;
 
-    memset(orderExecute, 0, size * sizeof(int));
-    for (int i = 0; i < size; ++i) {
-        (*orderExecute)[i] = safeSequence[i];
+    for (int i = 0; i < banker->size; ++i) {
+        (*orderExecute)[i] = banker->array[sequence[i]];
+    }
+}
+
+/**
+ * @brief Searches a safe sequence with passes of the vectorized candidate scan.
+ *
+ * Each pass finds every unfinished process whose Need row fits into Work with one sequential sweep of the Need matrix;
+ * work only grows, so all of them finish and return their Allocation rows before the next pass.
+ * The safe sequence is left in the sequence buffer of the BankerWorkspace.
+ *
+ * @param banker Pointer to the Banker structure representing the system state.
+ * @return Boolean value indicating whether a safe sequence was found.
+ */
+static _Bool scanSafeSequence(Banker *banker) {
+    BankerState *state = banker->state;
+    BankerWorkspace *workspace = banker->workspace;
+    resetBankerWorkspace(workspace, state);
+
+    int32_t *work = workspace->work;
+    int count = 0;
+    while (count < banker->size) {
+        // find every unfinished process whose need fits into work in one sweep of the Need matrix
+        int found = scanRunnableRows(state->needMatrix, state->columns, banker->size, work,
+                                     workspace->finish, workspace->runnable);
+        // If no process was found, the system is not in a safe state.
+        if (found == 0) {
+            return false;
+        }
+        // work only grows, so every process found by the sweep can finish: return their allocations in row order
+        for (int word = 0; word < bankerWorkspaceWords(banker->size); ++word) {
+            uint64_t bits = workspace->runnable[word];
+            while (bits != 0) {
+                int i = word * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, i);
+                for (int j = 0; j < state->columns; ++j) {
+                    work[j] += allocationRow[j];
+                }
+                finishBankerWorkspaceRow(workspace, i);
+                workspace->sequence[count++] = i;
+            }
+        }
     }
+    return true;
 }
 
 /**
  * @brief Checks if the system is in a safe state by simulating resource allocation.
  *
  * This function simulates the allocation of resources to processes to check if the system is in a safe state.
- * It uses the Banker's algorithm to avoid deadlock. The function creates a deep copy of the available resources and
- * an array to keep track of the finished processes. It then tries to find a sequence of processes that can finish
- * without leading to a deadlock. If such a sequence is found, the system is in a safe state.
+ * It uses the Banker's algorithm to avoid deadlock. The Work vector, the Finish bitmap and the safe sequence live in the BankerWorkspace of the Banker,
+ * which is reserved whenever a process is pushed, so the check itself does no heap allocation.
+ *
+ * The last safe sequence found is kept in the BankerWorkspace as a witness. A grant or release changes few rows, so the witness is replayed first,
+ * in O(n · m); if every process of it still fits in turn, the system is safe and the witness is the safe sequence.
+ * Only when the witness breaks is a sequence searched from scratch: a process whose Need row fits into Work finishes and returns its Allocation row to Work.
+ * Below BANKER_SORTED_SAFETY_ROWS processes the search is scanSafeSequence; from there on, where the number of passes can make it quadratic,
+ * checkResourceSecuritySorted is used instead. A sequence found this way becomes the new witness.
+ *
+ * With enableBankerSafetyCache the verdict of every check is remembered under the hash of the state; a state seen recently is answered
+ * from the cache before anything else, and its safe sequence becomes the witness.
  *
  * @param banker Pointer to the Banker structure representing the system state.
  * @param systemResource Pointer to the SystemResource structure used for memory management.
@@ -704,52 +705,67 @@ checkResourceSecurity(
         SystemResource *systemResource,
         BankProConBlock *(*orderExecute)[banker->size]
 ) {
-
-    BaseAllocateArr *availableResource = deepCopyBaseAllocateArr(
-            banker->availableResource,
-            systemResource->memory
-    );
-    _Bool finishArr[banker->size];
-    memset(finishArr, false, banker->size * sizeof(_Bool));
-
-    BankProConBlock *safeSequence[banker->size];
-    int count = 0;
-
-    _Bool flag = true;
-    while (count < banker->size) {
-
-        bool foundExecute = false;
-        for (int i = 0; i < banker->size; ++i) {
-            // find a process that has not been executed
-            if (finishArr[i] == true) {
-                continue;
-            }
-            // find a process that needs fewer resources than the available resources
-            if (canBeAllocated(banker->array[i]->resource->needResource, availableResource)) {
-                // Simulate the allocation of resources to the process
-                simulatedAllocatedResourceToProcess(
-                        availableResource,
-                        banker->array[i]->resource
-                );
-                // Mark the process as finished and add to safe sequence, mark found process
-                finishArr[i] = true;
-                safeSequence[count++] = banker->array[i];
-                foundExecute = true;
+    BankerState *state = banker->state;
+    BankerWorkspace *workspace = banker->workspace;
+    assert(state->rows == banker->size);
+    if (banker->size == 0) {
+        return true;
+    }
+    BankerSafetyCache *cache = workspace->cache;
+    uint64_t key = 0;
+    if (cache != NULL) {
+        key = loadBankerSafetyHash(cache, state);
+        BankerSafetyEntry *entry = findBankerSafety(cache, key);
+        if (entry != NULL) {
+            if (entry->safe == false) {
+                return false;
             }
+            saveBankerWitness(workspace, entry->sequence, entry->rows);
+            saveSafeSequenceToOrderExecute(banker, orderExecute, workspace->witness);
+            return true;
         }
-        // If no process was found, the system is not in a safe state.
-        if (foundExecute == false) {
-            flag = false;
-            break;
+    }
+    if (replayBankerWitness(workspace, state) == true) {
+        workspace->witnessHits += 1;
+        if (cache != NULL) {
+            saveBankerSafety(cache, key, true, workspace->witness, banker->size, systemResource->memory);
         }
+        saveSafeSequenceToOrderExecute(banker, orderExecute, workspace->witness);
+        return true;
     }
+    workspace->witnessMisses += 1;
 
-    if (flag == true) {
-        saveSafeSequenceToOrderExecute(banker->size, orderExecute, safeSequence);
+    _Bool safe = banker->size >= BANKER_SORTED_SAFETY_ROWS
+                 ? checkResourceSecuritySorted(banker, systemResource, NULL)
+                 : scanSafeSequence(banker);
+    if (cache != NULL) {
+        saveBankerSafety(cache, key, safe, workspace->sequence, banker->size, systemResource->memory);
+    }
+    if (safe == false) {
+        return false;
     }
-    destroyBaseAllocateArr(availableResource, systemResource->memory);
+    saveBankerWitness(workspace, workspace->sequence, banker->size);
+    saveSafeSequenceToOrderExecute(banker, orderExecute, workspace->witness);
+    return true;
+}
 
-    return flag;
+/**
+ * @brief Turns on the cache of safety check results of a Banker.
+ *
+ * From now on the Banker keeps an incremental hash of its dense state, and checkResourceSecurity answers a state it has seen recently
+ * from the cache, with the safe sequence it found then. Calling it again on a Banker with a cache does nothing.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param capacity The largest number of states remembered, for example BANKER_SAFETY_CACHE_SIZE.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ */
+void enableBankerSafetyCache(Banker *banker, int capacity, SystemResource *systemResource) {
+    if (banker->workspace == NULL) {
+        banker->workspace = initBankerWorkspace(banker->state->columns, systemResource->memory);
+    }
+    if (banker->workspace->cache == NULL) {
+        banker->workspace->cache = initBankerSafetyCache(capacity, systemResource->memory);
+    }
 }
 
 /**
@@ -820,12 +836,14 @@ void bankerResourceAllocatedAlgorithm(
             displaySafeSequence(banker->size, orderExecute);
             // request resource to allocated
             simulatedRequestResourceToProcess(banker->availableResource, safeBank->resource);
+            syncBankProConBlockToBanker(banker, safeBank);
             // used pcb execute algorithm execute pcb callback function
             if (safeBank->base->callback != NULL) {
                 safeBank->base->callback(safeBank->base);
             }
             // release resource to available
             simulatedReleaseResourceToProcess(banker->availableResource, safeBank->resource);
+            syncBankProConBlockToBanker(banker, safeBank);
             // banker remove safeBank and destroy safeBank
             removeBankProConBlockFromBanker(banker, safeBank, systemResource);
             destroyArr[i] = true;
@@ -845,66 +863,3 @@ void bankerResourceAllocatedAlgorithm(
     }
     destroyBanker(banker, systemResource);
 }
-
-/**
- * @brief Creates a deep copy of a BankProConBlock structure.
- *
- * This function creates a new BankProConBlock structure and initializes it with the values from the provided BankProConBlock.
- * It uses the initBankProConBlock function to create the new BankProConBlock with the process ID, name, total time, priority, and callback function from the provided BankProConBlock.
- * It then uses the deepCopyAllocatorResource function to create a deep copy of the AllocatorResource structure from the provided BankProConBlock and assigns it to the new BankProConBlock.
- *
- * @param bankProConBlock Pointer to the BankProConBlock structure to be copied.
- * @param systemResource Pointer to the SystemResource structure used for memory management.
- * @return Pointer to the newly created BankProConBlock structure.
- */
-static BankProConBlock *deepCopyBankProConBlock(BankProConBlock *bankProConBlock, SystemResource *systemResource) {
-    BankProConBlock *newBankProConBlock = initBankProConBlock(
-            bankProConBlock->base->p_id,
-            bankProConBlock->base->p_name,
-            bankProConBlock->base->p_total_time,
-            bankProConBlock->base->p_priority,
-            bankProConBlock->base->callback,
-            systemResource->memory
-    );
-    deepCopyAllocatorResource(
-            newBankProConBlock->resource,
-            bankProConBlock->resource,
-            systemResource
-    );
-    return newBankProConBlock;
-}
-
-/**
- * @brief Creates a deep copy of an AllocatorResource structure.
- *
- * This function creates a deep copy of the provided AllocatorResource structure.
- * It iterates over the maxResource, assignedResource, and needResource arrays in the source AllocatorResource structure.
- * For each resource in these arrays, it creates a copy of the resource and adds it to the corresponding array in the destination AllocatorResource structure.
- *
- * @param destResource Pointer to the AllocatorResource structure where the copied resources will be stored.
- * @param sourceResource Pointer to the AllocatorResource structure to be copied.
- * @param systemResource Pointer to the SystemResource structure used for memory management.
- */
-static void deepCopyAllocatorResource(
-        AllocatorResource *destResource,
-        AllocatorResource *sourceResource,
-        SystemResource *systemResource
-) {
-    for (int i = 0; i < sourceResource->maxResource->member; ++i) {
-        pushToResourceArrUsedBaseAllocate(
-                destResource->maxResource,
-                sourceResource->maxResource->array[i],
-                systemResource->memory
-        );
-        pushToResourceArrUsedBaseAllocate(
-                destResource->assignedResource,
-                sourceResource->assignedResource->array[i],
-                systemResource->memory
-        );
-        pushToResourceArrUsedBaseAllocate(
-                destResource->needResource,
-                sourceResource->needResource->array[i],
-                systemResource->memory
-        );
-    }
-}
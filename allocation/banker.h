@@ -31,24 +31,34 @@
  */
 #include <assert.h>
 #include "base/resource_allocate.h"
+#include "state/banker_state.h"
+#include "simd/banker_simd.h"
+#include "cache/safety_cache.h"
 #include "../allocator/systemResource.h"
 #include "../process/process_scheduling.h"
 #include "../tools/hashMap/hashMap.h"
 #include "../tools/hashMapResource/hashMapResource.h"
+#include "../tools/hashMapProcess/hashMapProcess.h"
 
 
 typedef struct BankProConBlock {
     ProConBlock *base;
     AllocatorResource *resource;
+    int row;                    // 在 Banker 数组与稠密状态中的行, -1 表示不在 Banker 中
 } BankProConBlock;
 
 typedef struct Banker {
     BankProConBlock **array;
     BaseAllocateArr *availableResource;
+    HashMapProcess *index;      // p_id -> BankProConBlock
+    BankerState *state;         // 稠密 Max / Allocation / Need / Available
+    BankerWorkspace *workspace; // 安全性检查的工作区
     int size;
     int maxSize;
 } Banker;
 
+#define bankerSafetyCacheOf(banker) ((banker)->workspace != NULL ? (banker)->workspace->cache : NULL)
+
 
 extern BankProConBlock *initBankProConBlock(
         int p_id,
@@ -89,6 +99,16 @@ extern void pushProConBlockToBanker(
         SystemResource *systemResource
 );
 
+extern BankProConBlock *findBankProConBlockFromBanker(Banker *banker, int p_id);
+
+extern void syncBankProConBlockToBanker(Banker *banker, BankProConBlock *bankProConBlock);
+
+extern void removeBankProConBlockFromBanker(
+        Banker *banker,
+        BankProConBlock *bankProConBlock,
+        SystemResource *systemResource
+);
+
 extern void pushProConBlockArrToBanker(
         Banker *banker,
         ProConBlock **pcbArr,
@@ -104,6 +124,8 @@ extern void bankerResourceAllocatedAlgorithm(
         SystemResource *systemResource
 );
 
+extern void enableBankerSafetyCache(Banker *banker, int capacity, SystemResource *systemResource);
+
 extern _Bool
 checkResourceSecurity(
         Banker *banker,
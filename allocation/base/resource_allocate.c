@@ -194,6 +194,25 @@ void displayBaseAllocateArr(BaseAllocateArr *baseAllocateArr) {
     printf_s("###################################\n");
 }
 
+/**
+ * @brief Indexes the cells of a BaseAllocateArr by resource type.
+ *
+ * The index lives in the caller's array, so looking a type up afterwards is O(1) without building a hash map.
+ * Its size only has to cover the types in the BaseAllocateArr, for example the columns of a Banker, not every registered type.
+ *
+ * @param baseAllocateArr Pointer to the BaseAllocateArr structure to be indexed.
+ * @param types The number of entries of index, above every type in the BaseAllocateArr.
+ * @param index Array filled with a pointer to the number of each ResourceType, NULL for types missing from the BaseAllocateArr.
+ */
+void indexBaseAllocateArr(BaseAllocateArr *baseAllocateArr, int types, int *index[types]) {
+    memset(index, 0, types * sizeof(int *));
+    for (int i = 0; i < baseAllocateArr->member; ++i) {
+        int type = (int) baseAllocateArr->array[i]->type;
+        assert(type < types);
+        index[type] = &baseAllocateArr->array[i]->number;
+    }
+}
+
 void displayResourceTypArr(int member, ResourceType resourceTypeArr[member][2]) {
     printf_s("###################################\n");
     for (int i = 0; i < member; ++i) {
@@ -10,8 +10,10 @@
 
 #include <stdbool.h>
 #include "../../allocator/memory/memory_allocator.h"
+#include "../registry/resource_registry.h"
 
 
+// 内置类型, 其它类型由 registerResourceType 在运行时分配编号
 typedef enum ResourceType {
     memory,
     cpu,
@@ -21,6 +23,8 @@ typedef enum ResourceType {
     file
 } ResourceType;
 
+#define RESOURCE_TYPE_BUILTIN (file + 1)
+
 typedef struct BaseAllocate {
     ResourceType type;
     int number;
@@ -40,15 +44,7 @@ typedef struct AllocatorResource {
     int size;
 } AllocatorResource;
 
-#define resourceTypeToString(type) _Generic((type), \
-    enum ResourceType:                              \
-        (type == memory) ? "memory":                \
-        (type == cpu) ? "cpu":                      \
-        (type == gpu) ? "gpu":                      \
-        (type == swap) ?"swap":                     \
-        (type == network) ? "network":              \
-        (type == file) ? "file":"Unknown"           \
-)
+#define resourceTypeToString(type) resourceTypeName((int) (type))
 
 
 extern BaseAllocate *initBaseAllocate(Allocator *allocator, ResourceType type, int number);
@@ -84,6 +80,8 @@ extern void pushToResourceArrUsedBaseAllocate(BaseAllocateArr *destArr, BaseAllo
 
 extern void displayBaseAllocateArr(BaseAllocateArr *baseAllocateArr);
 
+extern void indexBaseAllocateArr(BaseAllocateArr *baseAllocateArr, int types, int *index[types]);
+
 extern void displayResourceTypArr(int member, ResourceType resourceTypeArr[member][2]);
 
 extern AllocatorResource *initAllocatorResource(Allocator *allocator);
@@ -0,0 +1,280 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 15:40
+*/
+#include "safety_cache.h"
+
+
+/**
+ * @brief Unlinks an entry from the LRU list.
+ */
+static void unlinkBankerSafetyEntry(BankerSafetyCache *cache, int index) {
+    BankerSafetyEntry *entry = &cache->entries[index];
+    if (entry->prev >= 0) {
+        cache->entries[entry->prev].next = entry->next;
+    } else {
+        cache->head = entry->next;
+    }
+    if (entry->next >= 0) {
+        cache->entries[entry->next].prev = entry->prev;
+    } else {
+        cache->tail = entry->prev;
+    }
+}
+
+/**
+ * @brief Links an entry at the front of the LRU list, as the most recently used one.
+ */
+static void frontBankerSafetyEntry(BankerSafetyCache *cache, int index) {
+    BankerSafetyEntry *entry = &cache->entries[index];
+    entry->prev = -1;
+    entry->next = cache->head;
+    if (cache->head >= 0) {
+        cache->entries[cache->head].prev = index;
+    } else {
+        cache->tail = index;
+    }
+    cache->head = index;
+}
+
+/**
+ * @brief Removes an entry from the chain of its bucket.
+ */
+static void unchainBankerSafetyEntry(BankerSafetyCache *cache, int index) {
+    int *link = &cache->buckets[cache->entries[index].key & cache->bucketMask];
+    while (*link != index) {
+        link = &cache->entries[*link].chain;
+    }
+    *link = cache->entries[index].chain;
+}
+
+/**
+ * @brief Initializes an empty BankerSafetyCache.
+ *
+ * @param capacity The largest number of states remembered, at least 1.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created BankerSafetyCache structure.
+ */
+BankerSafetyCache *initBankerSafetyCache(int capacity, Allocator *allocator) {
+    assert(capacity > 0);
+    BankerSafetyCache *cache = allocator->allocate(allocator, sizeof(BankerSafetyCache));
+    assert(cache != NULL);
+    int buckets = 1;
+    while (buckets < 2 * capacity) {
+        buckets *= 2;
+    }
+    cache->entries = allocator->allocate(allocator, capacity * sizeof(BankerSafetyEntry));
+    cache->buckets = allocator->allocate(allocator, buckets * sizeof(int));
+    assert(cache->entries != NULL && cache->buckets != NULL);
+    for (int i = 0; i < buckets; ++i) {
+        cache->buckets[i] = -1;
+    }
+    cache->capacity = capacity;
+    cache->size = 0;
+    cache->bucketMask = buckets - 1;
+    cache->head = -1;
+    cache->tail = -1;
+    cache->hash = 0;
+    cache->hashVersion = 0;
+    cache->hashValid = false;
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->evictions = 0;
+    return cache;
+}
+
+/**
+ * @brief Destroys a BankerSafetyCache and the safe sequences it keeps.
+ *
+ * @param cache Pointer to the BankerSafetyCache structure to be destroyed, may be NULL.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyBankerSafetyCache(BankerSafetyCache *cache, Allocator *allocator) {
+    if (cache == NULL) {
+        return;
+    }
+    for (int i = 0; i < cache->size; ++i) {
+        allocator->deallocate(allocator, cache->entries[i].sequence, cache->entries[i].sequenceCapacity * sizeof(int));
+    }
+    allocator->deallocate(allocator, cache->buckets, (cache->bucketMask + 1) * sizeof(int));
+    allocator->deallocate(allocator, cache->entries, cache->capacity * sizeof(BankerSafetyEntry));
+    allocator->deallocate(allocator, cache, sizeof(BankerSafetyCache));
+}
+
+/**
+ * @brief Returns the Zobrist key of a cell with a value: its position and value mixed by splitmix64.
+ *
+ * @param matrix The matrix of the cell; the Available vector is row 0 of safety_available.
+ * @param row The row of the cell.
+ * @param column The column of the cell.
+ * @param value The value of the cell.
+ * @return The key of the cell, to be xor-ed into the hash of the state.
+ */
+uint64_t bankerSafetyCellKey(BankerSafetyMatrix matrix, int row, int column, int32_t value) {
+    uint64_t x = ((uint64_t) (uint32_t) row << 32 | (uint64_t) (uint32_t) column << 2 | (uint64_t) matrix)
+                 ^ (uint64_t) (uint32_t) value * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Updates the hash after a cell changed its value, O(1).
+ *
+ * @param cache Pointer to the BankerSafetyCache structure, with a fresh hash.
+ * @param matrix The matrix of the cell.
+ * @param row The row of the cell.
+ * @param column The column of the cell.
+ * @param from The value before the change.
+ * @param to The value after the change.
+ */
+void moveBankerSafetyCell(BankerSafetyCache *cache, BankerSafetyMatrix matrix, int row, int column, int32_t from, int32_t to) {
+    cache->hash ^= bankerSafetyCellKey(matrix, row, column, from) ^ bankerSafetyCellKey(matrix, row, column, to);
+}
+
+/**
+ * @brief Xors the Allocation and Max cells of a row into the hash, O(m): a row outside the hash enters it, a row inside leaves it.
+ */
+void toggleBankerSafetyRow(BankerSafetyCache *cache, BankerState *state, int row) {
+    const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+    const int32_t *maxRow = bankerStateRow(state, maxMatrix, row);
+    for (int j = 0; j < state->columns; ++j) {
+        cache->hash ^= bankerSafetyCellKey(safety_allocation, row, j, allocationRow[j])
+                       ^ bankerSafetyCellKey(safety_max, row, j, maxRow[j]);
+    }
+}
+
+/**
+ * @brief Xors the Available cells into the hash, O(m).
+ */
+void toggleBankerSafetyAvailable(BankerSafetyCache *cache, BankerState *state) {
+    for (int j = 0; j < state->columns; ++j) {
+        cache->hash ^= bankerSafetyCellKey(safety_available, 0, j, state->available[j]);
+    }
+}
+
+/**
+ * @brief Takes a row and the Available vector out of the hash before the Banker rewrites them.
+ *
+ * @param cache Pointer to the BankerSafetyCache structure, may be NULL.
+ * @param state Pointer to the BankerState about to change.
+ * @param row The row about to change, -1 for none.
+ * @return Whether the hash was fresh; only then is it updated, and enterBankerSafetyHash must get the result.
+ */
+_Bool leaveBankerSafetyHash(BankerSafetyCache *cache, BankerState *state, int row) {
+    if (!isBankerSafetyHashFresh(cache, state)) {
+        return false;
+    }
+    if (row >= 0) {
+        toggleBankerSafetyRow(cache, state, row);
+    }
+    toggleBankerSafetyAvailable(cache, state);
+    return true;
+}
+
+/**
+ * @brief Puts a row and the Available vector back into the hash after the Banker rewrote them, and follows the version of the state.
+ *
+ * @param cache Pointer to the BankerSafetyCache structure, may be NULL.
+ * @param state Pointer to the BankerState that changed.
+ * @param row The row that changed, -1 for none.
+ * @param fresh The result of leaveBankerSafetyHash.
+ */
+void enterBankerSafetyHash(BankerSafetyCache *cache, BankerState *state, int row, _Bool fresh) {
+    if (!fresh) {
+        return;
+    }
+    if (row >= 0) {
+        toggleBankerSafetyRow(cache, state, row);
+    }
+    toggleBankerSafetyAvailable(cache, state);
+    cache->hashVersion = state->version;
+}
+
+/**
+ * @brief Returns the hash of the state, recomputed from every cell if it does not describe this version, O(n · m).
+ *
+ * @param cache Pointer to the BankerSafetyCache structure.
+ * @param state Pointer to the BankerState.
+ * @return The hash of the state.
+ */
+uint64_t loadBankerSafetyHash(BankerSafetyCache *cache, BankerState *state) {
+    if (!isBankerSafetyHashFresh(cache, state)) {
+        cache->hash = 0;
+        toggleBankerSafetyAvailable(cache, state);
+        for (int i = 0; i < state->rows; ++i) {
+            toggleBankerSafetyRow(cache, state, i);
+        }
+        cache->hashVersion = state->version;
+        cache->hashValid = true;
+    }
+    return cache->hash;
+}
+
+/**
+ * @brief Looks a state up in the cache; a hit becomes the most recently used entry.
+ *
+ * @param cache Pointer to the BankerSafetyCache structure.
+ * @param key The hash of the state.
+ * @return Pointer to the entry of the state, NULL if it is not cached.
+ */
+BankerSafetyEntry *findBankerSafety(BankerSafetyCache *cache, uint64_t key) {
+    for (int index = cache->buckets[key & cache->bucketMask]; index >= 0; index = cache->entries[index].chain) {
+        if (cache->entries[index].key == key) {
+            unlinkBankerSafetyEntry(cache, index);
+            frontBankerSafetyEntry(cache, index);
+            cache->hits += 1;
+            return &cache->entries[index];
+        }
+    }
+    cache->misses += 1;
+    return NULL;
+}
+
+/**
+ * @brief Remembers the verdict and the safe sequence of a state, evicting the least recently used entry when the cache is full.
+ *
+ * @param cache Pointer to the BankerSafetyCache structure.
+ * @param key The hash of the state, not yet cached.
+ * @param safe Whether the state is safe.
+ * @param sequence The safe sequence (rows), ignored when the state is unsafe.
+ * @param rows The length of the safe sequence.
+ * @param allocator Pointer to the Allocator structure used for the safe sequence.
+ */
+void saveBankerSafety(BankerSafetyCache *cache, uint64_t key, _Bool safe, const int *sequence, int rows, Allocator *allocator) {
+    int index;
+    if (cache->size < cache->capacity) {
+        index = cache->size++;
+        cache->entries[index].sequence = NULL;
+        cache->entries[index].sequenceCapacity = 0;
+    } else {
+        index = cache->tail;
+        unlinkBankerSafetyEntry(cache, index);
+        unchainBankerSafetyEntry(cache, index);
+        cache->evictions += 1;
+    }
+    BankerSafetyEntry *entry = &cache->entries[index];
+    if (!safe) {
+        rows = 0;
+    }
+    if (rows > entry->sequenceCapacity) {
+        entry->sequence = allocator->reallocate(allocator, entry->sequence,
+                                                entry->sequenceCapacity * sizeof(int), rows * sizeof(int));
+        assert(entry->sequence != NULL);
+        entry->sequenceCapacity = rows;
+    }
+    if (rows > 0) {
+        memcpy(entry->sequence, sequence, rows * sizeof(int));
+    }
+    entry->key = key;
+    entry->safe = safe;
+    entry->rows = rows;
+    int *bucket = &cache->buckets[key & cache->bucketMask];
+    entry->chain = *bucket;
+    *bucket = index;
+    frontBankerSafetyEntry(cache, index);
+}
@@ -0,0 +1,92 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 15:40
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SAFETY_CACHE_H
+#define OPERATORSYSTEM_SAFETY_CACHE_H
+/*
+ * 安全性检查结果缓存(Zobrist 增量哈希 + LRU)
+        负载常在少数几个分配状态之间来回, 同一个状态的安全性检查每次都得到同样的结果。
+        状态的哈希是所有单元 (矩阵, 行, 列, 值) 的哈希值的异或:
+            Available、Allocation 和 Max 的每个单元都参与(Need = Max - Allocation 由它们决定);
+            单元的哈希值由位置和值经 splitmix64 混合得到, 不需要随机数表, 值的范围也不受限制。
+        异或可以逐个单元增量更新: 单元从 a 变为 b 时 hash ^= key(a) ^ key(b), O(1);
+        整行移入或移出(加入、移除、同步进程)就是把这一行的单元各异或一次, O(m)。
+
+        哈希记下它对应的 BankerState version。Banker 自己改动状态时(请求、释放、试探与回滚、加入、移除、同步)
+        增量更新并跟上 version; 别处改动了状态, 下次查询前按整个矩阵重算一次, O(n · m)。
+
+        缓存是一张按哈希索引的表, 最多 capacity 项, 满了淘汰最久没用过的一项(LRU, 双向链表):
+            每项保存结论和安全序列(行下标), 命中时直接返回, 安全序列同时成为新的见证。
+        64 位哈希相同而状态不同的概率可以忽略, 命中时不再比较整个状态。
+        缓存需要 enableBankerSafetyCache 打开, 没有打开时 Banker 不维护哈希。
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include "../state/banker_state.h"
+
+#define BANKER_SAFETY_CACHE_SIZE 64
+
+typedef enum BankerSafetyMatrix {
+    safety_available,
+    safety_allocation,
+    safety_max
+} BankerSafetyMatrix;
+
+typedef struct BankerSafetyEntry {
+    uint64_t key;               // 状态的哈希
+    _Bool safe;
+    int rows;                   // 安全序列的长度, 不安全时为 0
+    int *sequence;              // 安全序列(行下标)
+    int sequenceCapacity;
+    int prev;                   // LRU 链表, 靠前的最近用过
+    int next;
+    int chain;                  // 同一个桶中的下一项
+} BankerSafetyEntry;
+
+typedef struct BankerSafetyCache {
+    BankerSafetyEntry *entries;
+    int capacity;
+    int size;
+    int *buckets;               // 哈希 -> 第一项, -1 表示空
+    int bucketMask;
+    int head;                   // 最近用过的一项
+    int tail;                   // 最久没用过的一项, 先被淘汰
+    uint64_t hash;              // 当前状态的哈希
+    unsigned int hashVersion;   // 哈希对应的 BankerState version
+    _Bool hashValid;
+    long hits;
+    long misses;
+    long evictions;
+} BankerSafetyCache;
+
+#define isBankerSafetyHashFresh(cache, state) \
+    ((cache) != NULL && (cache)->hashValid && (cache)->hashVersion == (state)->version)
+
+
+extern BankerSafetyCache *initBankerSafetyCache(int capacity, Allocator *allocator);
+
+extern void destroyBankerSafetyCache(BankerSafetyCache *cache, Allocator *allocator);
+
+extern uint64_t bankerSafetyCellKey(BankerSafetyMatrix matrix, int row, int column, int32_t value);
+
+extern void moveBankerSafetyCell(BankerSafetyCache *cache, BankerSafetyMatrix matrix, int row, int column, int32_t from, int32_t to);
+
+extern void toggleBankerSafetyRow(BankerSafetyCache *cache, BankerState *state, int row);
+
+extern void toggleBankerSafetyAvailable(BankerSafetyCache *cache, BankerState *state);
+
+extern _Bool leaveBankerSafetyHash(BankerSafetyCache *cache, BankerState *state, int row);
+
+extern void enterBankerSafetyHash(BankerSafetyCache *cache, BankerState *state, int row, _Bool fresh);
+
+extern uint64_t loadBankerSafetyHash(BankerSafetyCache *cache, BankerState *state);
+
+extern BankerSafetyEntry *findBankerSafety(BankerSafetyCache *cache, uint64_t key);
+
+extern void saveBankerSafety(BankerSafetyCache *cache, uint64_t key, _Bool safe, const int *sequence, int rows, Allocator *allocator);
+
+#endif //OPERATORSYSTEM_SAFETY_CACHE_H
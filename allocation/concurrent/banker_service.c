@@ -0,0 +1,297 @@
+/*
+ User: Redskaber
+ Date: 2024/1/31
+ Time: 09:46
+*/
+#include "banker_service.h"
+
+
+/**
+ * @brief Starts a write to the snapshot: readers that overlap it will retry.
+ */
+static inline void beginBankerSnapshotWrite(BankerService *service) {
+    atomic_store_explicit(&service->sequence, atomic_load_explicit(&service->sequence, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @brief Ends a write to the snapshot: the sequence is even again and the new values are visible with it.
+ */
+static inline void endBankerSnapshotWrite(BankerService *service) {
+    atomic_store_explicit(&service->sequence, atomic_load_explicit(&service->sequence, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+/**
+ * @brief Copies the Available vector and a row of the Allocation matrix of the dense BankerState into the snapshot.
+ *
+ * Must be called between beginBankerSnapshotWrite and endBankerSnapshotWrite; a row of -1 only copies the Available vector.
+ */
+static void publishBankerSnapshotRow(BankerService *service, int row) {
+    BankerState *state = service->banker->state;
+    for (int j = 0; j < service->columns; ++j) {
+        atomic_store_explicit(&service->available[j], state->available[j], memory_order_relaxed);
+    }
+    if (row >= 0) {
+        const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+        _Atomic int32_t *snapshotRow = service->allocation + (size_t) row * service->columns;
+        for (int j = 0; j < service->columns; ++j) {
+            atomic_store_explicit(&snapshotRow[j], allocationRow[j], memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Runs the requests collected in the group of the service with one requestResourcesBatch and hands the results to their tickets.
+ */
+static void flushBankerServiceGroup(BankerService *service, int *member) {
+    if (*member == 0) {
+        return;
+    }
+    requestResourcesBatch(service->banker, *member, service->group, service->systemResource);
+    for (int i = 0; i < *member; ++i) {
+        service->groupTickets[i]->request.result = service->group[i].result;
+    }
+    *member = 0;
+}
+
+/**
+ * @brief Processes a list of tickets in arrival order and publishes the rows they changed.
+ *
+ * Runs of requests go through requestResourcesBatch, so they share their safety checks; a release ends the run before it.
+ */
+static void commitBankerTickets(BankerService *service, BankerTicket *tickets) {
+    int member = 0;
+    long count = 0;
+    for (BankerTicket *ticket = tickets; ticket != NULL; ticket = ticket->next) {
+        count += 1;
+        if (ticket->operation == banker_service_release) {
+            flushBankerServiceGroup(service, &member);
+            ticket->request.result = releaseBankerRequest(service->banker, &ticket->request);
+            continue;
+        }
+        if (member == BANKER_SERVICE_GROUP) {
+            flushBankerServiceGroup(service, &member);
+        }
+        service->group[member] = ticket->request;
+        service->groupTickets[member++] = ticket;
+    }
+    flushBankerServiceGroup(service, &member);
+
+    beginBankerSnapshotWrite(service);
+    publishBankerSnapshotRow(service, -1);
+    for (BankerTicket *ticket = tickets; ticket != NULL; ticket = ticket->next) {
+        if (ticket->request.result == banker_request_granted) {
+            publishBankerSnapshotRow(service, findBankProConBlockFromBanker(service->banker, ticket->request.p_id)->row);
+        }
+    }
+    endBankerSnapshotWrite(service);
+    service->groups += 1;
+    service->tickets += count;
+}
+
+/**
+ * @brief The writer thread: takes the whole queue at once, commits it and wakes the submitters of that group.
+ */
+static void *bankerServiceWriter(void *arg) {
+    BankerService *service = arg;
+    pthread_mutex_lock(&service->mutex);
+    while (true) {
+        while (service->head == NULL && !service->stopping) {
+            pthread_cond_wait(&service->submitted, &service->mutex);
+        }
+        if (service->head == NULL) {
+            break;
+        }
+        BankerTicket *tickets = service->head;
+        service->head = NULL;
+        service->tail = NULL;
+        pthread_mutex_unlock(&service->mutex);
+
+        commitBankerTickets(service, tickets);
+
+        pthread_mutex_lock(&service->mutex);
+        // a ticket lives on the stack of its submitter: read next before it may return
+        while (tickets != NULL) {
+            BankerTicket *next = tickets->next;
+            tickets->done = true;
+            tickets = next;
+        }
+        pthread_cond_broadcast(&service->completed);
+    }
+    pthread_mutex_unlock(&service->mutex);
+    return NULL;
+}
+
+/**
+ * @brief Queues a ticket and waits until the writer has processed it.
+ */
+static BankerRequestResult submitBankerTicket(BankerService *service, BankerTicket *ticket) {
+    ticket->done = false;
+    ticket->next = NULL;
+    pthread_mutex_lock(&service->mutex);
+    assert(!service->stopping);
+    if (service->tail == NULL) {
+        service->head = ticket;
+        pthread_cond_signal(&service->submitted);
+    } else {
+        service->tail->next = ticket;
+    }
+    service->tail = ticket;
+    while (!ticket->done) {
+        pthread_cond_wait(&service->completed, &service->mutex);
+    }
+    pthread_mutex_unlock(&service->mutex);
+    return ticket->request.result;
+}
+
+/**
+ * @brief Starts a BankerService over a Banker.
+ *
+ * From now on only the writer thread of the service touches the Banker and the Allocator of the SystemResource,
+ * until destroyBankerService returns. The snapshot starts as a copy of the current state.
+ *
+ * @param banker Pointer to the Banker structure to be served.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @return Pointer to the newly created BankerService structure.
+ */
+BankerService *initBankerService(Banker *banker, SystemResource *systemResource) {
+    Allocator *allocator = systemResource->memory;
+    BankerService *service = allocator->allocate(allocator, sizeof(BankerService));
+    assert(service != NULL);
+    service->banker = banker;
+    service->systemResource = systemResource;
+    service->head = NULL;
+    service->tail = NULL;
+    service->stopping = false;
+    service->groups = 0;
+    service->tickets = 0;
+    service->rows = banker->size;
+    service->columns = banker->state->columns;
+    service->available = allocator->allocate(
+            allocator, (size_t) (service->rows + 1) * service->columns * sizeof(_Atomic int32_t));
+    assert(service->available != NULL);
+    service->allocation = service->available + service->columns;
+    atomic_init(&service->sequence, 0);
+    publishBankerSnapshotRow(service, -1);
+    for (int row = 0; row < service->rows; ++row) {
+        publishBankerSnapshotRow(service, row);
+    }
+
+    pthread_mutex_init(&service->mutex, NULL);
+    pthread_cond_init(&service->submitted, NULL);
+    pthread_cond_init(&service->completed, NULL);
+    int started = pthread_create(&service->writer, NULL, bankerServiceWriter, service);
+    assert(started == 0);
+    return service;
+}
+
+/**
+ * @brief Stops a BankerService: the tickets already queued are still processed, then the writer thread exits.
+ *
+ * No thread may submit to the service any more; afterwards the Banker belongs to the calling thread again.
+ *
+ * @param service Pointer to the BankerService structure to be destroyed.
+ */
+void destroyBankerService(BankerService *service) {
+    if (service == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&service->mutex);
+    service->stopping = true;
+    pthread_cond_signal(&service->submitted);
+    pthread_mutex_unlock(&service->mutex);
+    pthread_join(service->writer, NULL);
+
+    pthread_cond_destroy(&service->completed);
+    pthread_cond_destroy(&service->submitted);
+    pthread_mutex_destroy(&service->mutex);
+    Allocator *allocator = service->systemResource->memory;
+    allocator->deallocate(allocator, service->available,
+                          (size_t) (service->rows + 1) * service->columns * sizeof(_Atomic int32_t));
+    allocator->deallocate(allocator, service, sizeof(BankerService));
+}
+
+/**
+ * @brief Requests resources through a BankerService, from any thread.
+ *
+ * The request is queued and processed by the writer thread with the others of its group, exactly like requestResources;
+ * the calling thread sleeps until the result is known.
+ *
+ * @param service Pointer to the BankerService structure.
+ * @param p_id The process ID of the requesting process.
+ * @param rows The number of rows of the requestResourceArr array.
+ * @param requestResourceArr 2D array of requested resources, where each row contains a resource type and its requested quantity.
+ * @return The result of requestResources for the request.
+ */
+BankerRequestResult submitBankerRequest(
+        BankerService *service,
+        int p_id,
+        int rows,
+        ResourceType requestResourceArr[rows][2]
+) {
+    BankerTicket ticket;
+    initBankerRequest(&ticket.request, p_id, rows, requestResourceArr);
+    ticket.operation = banker_service_request;
+    return submitBankerTicket(service, &ticket);
+}
+
+/**
+ * @brief Releases resources through a BankerService, from any thread.
+ *
+ * @param service Pointer to the BankerService structure.
+ * @param p_id The process ID of the releasing process.
+ * @param rows The number of rows of the releaseResourceArr array.
+ * @param releaseResourceArr 2D array of released resources, where each row contains a resource type and its released quantity.
+ * @return The result of releaseResources for the release.
+ */
+BankerRequestResult submitBankerRelease(
+        BankerService *service,
+        int p_id,
+        int rows,
+        ResourceType releaseResourceArr[rows][2]
+) {
+    BankerTicket ticket;
+    initBankerRequest(&ticket.request, p_id, rows, releaseResourceArr);
+    ticket.operation = banker_service_release;
+    return submitBankerTicket(service, &ticket);
+}
+
+/**
+ * @brief Copies a consistent snapshot of the Available vector and, optionally, the Allocation matrix, without locking.
+ *
+ * The copy is repeated while the writer is publishing a group, so it always shows the state between two groups.
+ * Rows of the Allocation matrix are in the order of the Banker, which does not change while the service runs.
+ *
+ * @param service Pointer to the BankerService structure.
+ * @param available Array of service->columns entries to be filled with the Available vector, indexed by resource type.
+ * @param allocation Array of rows of service->columns entries to be filled with the Allocation matrix, one row per process of the Banker; may be NULL.
+ * @return The version of the snapshot; it grows by 2 with every published group.
+ */
+uint64_t snapshotBankerService(
+        BankerService *service,
+        int32_t available[service->columns],
+        int32_t (*allocation)[service->columns]
+) {
+    while (true) {
+        uint64_t before = atomic_load_explicit(&service->sequence, memory_order_acquire);
+        if (before & 1) {
+            sched_yield();
+            continue;
+        }
+        for (int j = 0; j < service->columns; ++j) {
+            available[j] = atomic_load_explicit(&service->available[j], memory_order_relaxed);
+        }
+        for (int row = 0; allocation != NULL && row < service->rows; ++row) {
+            const _Atomic int32_t *snapshotRow = service->allocation + (size_t) row * service->columns;
+            for (int j = 0; j < service->columns; ++j) {
+                allocation[row][j] = atomic_load_explicit(&snapshotRow[j], memory_order_relaxed);
+            }
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&service->sequence, memory_order_relaxed) == before) {
+            return before;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ User: Redskaber
+ Date: 2024/1/31
+ Time: 09:46
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_BANKER_SERVICE_H
+#define OPERATORSYSTEM_BANKER_SERVICE_H
+/*
+ * 多线程的银行家服务(单写者 + 组提交 + 顺序锁快照)
+        Banker、BaseAllocateArr 和 Allocator 都不加锁, 只能由一个线程使用。
+        BankerService 启动一个写者线程, 只有它修改 Banker:
+            1. 工作线程把请求/释放(BankerTicket, 放在调用者栈上)挂到待处理队列的尾部, 然后睡眠等待结果;
+            2. 写者一次取走整个队列(一组), 按到达顺序处理: 连续的请求交给 requestResourcesBatch, 整段共用安全性检查;
+               释放直接执行。结果与逐个串行处理完全相同, 不会出现不安全的分配;
+            3. 写者发布快照后一次唤醒这一组的所有等待者。
+        等待的线程越多, 每组越大, 每个请求分摊到的安全性检查和加锁次数越少。
+
+        读 Available / Allocation 不经过写者: 写者每组之后把 Available 和改动过的 Allocation 行写入快照,
+        用顺序锁(sequence 奇数表示正在写)保护; 读者无锁复制, 复制前后 sequence 相同且为偶数才算一致的快照, 否则重试。
+
+        服务运行期间 Banker 的进程集合固定: 只能在 initBankerService 之前或 destroyBankerService 之后加入、移除进程,
+        也不能由其它线程直接调用 Banker 或它的 Allocator。
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../request/banker_request.h"
+
+#define BANKER_SERVICE_GROUP 256
+
+typedef enum BankerServiceOperation {
+    banker_service_request,
+    banker_service_release
+} BankerServiceOperation;
+
+typedef struct BankerTicket {
+    BankerRequest request;
+    BankerServiceOperation operation;
+    _Bool done;                         // 由 mutex 保护
+    struct BankerTicket *next;
+} BankerTicket;
+
+typedef struct BankerService {
+    Banker *banker;
+    SystemResource *systemResource;
+    pthread_t writer;
+    pthread_mutex_t mutex;
+    pthread_cond_t submitted;           // 队列非空或要求停止
+    pthread_cond_t completed;           // 一组处理完毕
+    BankerTicket *head;                 // 待处理队列, 由 mutex 保护
+    BankerTicket *tail;
+    _Bool stopping;
+    BankerRequest group[BANKER_SERVICE_GROUP];
+    BankerTicket *groupTickets[BANKER_SERVICE_GROUP];
+    _Atomic uint64_t sequence;          // 顺序锁, 奇数表示写者正在更新快照
+    _Atomic int32_t *available;         // columns, 与 allocation 在同一块内存中
+    _Atomic int32_t *allocation;        // rows × columns
+    int rows;
+    int columns;                        // BankerState 的列数
+    long groups;                        // 写者处理的组数
+    long tickets;                       // 写者处理的请求/释放数
+} BankerService;
+
+
+extern BankerService *initBankerService(Banker *banker, SystemResource *systemResource);
+
+extern void destroyBankerService(BankerService *service);
+
+extern BankerRequestResult submitBankerRequest(
+        BankerService *service,
+        int p_id,
+        int rows,
+        ResourceType requestResourceArr[rows][2]
+);
+
+extern BankerRequestResult submitBankerRelease(
+        BankerService *service,
+        int p_id,
+        int rows,
+        ResourceType releaseResourceArr[rows][2]
+);
+
+extern uint64_t snapshotBankerService(
+        BankerService *service,
+        int32_t available[service->columns],
+        int32_t (*allocation)[service->columns]
+);
+
+#endif //OPERATORSYSTEM_BANKER_SERVICE_H
@@ -0,0 +1,522 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 15:20
+*/
+#include "deadlock_detector.h"
+
+
+/**
+ * @brief Returns the node of a p_id, or -1 if the process is not in the DeadlockDetector.
+ */
+static inline int deadlockNodeOf(DeadlockDetector *detector, int p_id) {
+    return (int) (intptr_t) getProcess(detector->index, p_id) - 1;
+}
+
+static int compareDeadlockKey(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static int compareDeadlockOrder(const void *a, const void *b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Packs the order and the node into a key whose order is the topological order.
+ */
+static inline uint64_t deadlockOrderKey(DeadlockDetector *detector, int node) {
+    return (uint64_t) (uint32_t) detector->nodes[node].order << 32 | (uint32_t) node;
+}
+
+/**
+ * @brief Appends a node to a list of nodes, doubling it when full.
+ */
+static void pushDeadlockList(int **list, int *size, int *capacity, int node, Allocator *allocator) {
+    if (*size >= *capacity) {
+        int grown = *capacity == 0 ? 4 : 2 * *capacity;
+        *list = allocator->reallocate(allocator, *list, *capacity * sizeof(int), grown * sizeof(int));
+        assert(*list != NULL);
+        *capacity = grown;
+    }
+    (*list)[(*size)++] = node;
+}
+
+/**
+ * @brief Removes a node from a list of nodes by moving the last entry into its place.
+ */
+static void removeDeadlockList(int *list, int *size, int node) {
+    for (int i = 0; i < *size; ++i) {
+        if (list[i] == node) {
+            list[i] = list[--*size];
+            return;
+        }
+    }
+}
+
+static void replaceDeadlockList(int *list, int size, int from, int to) {
+    for (int i = 0; i < size; ++i) {
+        if (list[i] == from) {
+            list[i] = to;
+        }
+    }
+}
+
+/**
+ * @brief Removes the wait edge from -> to from both lists.
+ */
+static void removeDeadlockEdge(DeadlockDetector *detector, int from, int to) {
+    removeDeadlockList(detector->nodes[from].out, &detector->nodes[from].outSize, to);
+    removeDeadlockList(detector->nodes[to].in, &detector->nodes[to].inSize, from);
+}
+
+/**
+ * @brief Returns the holding of a resource type of a node, or NULL if the node holds none of it.
+ */
+static DeadlockHolding *findDeadlockHolding(DeadlockNode *node, int type) {
+    for (int k = 0; k < node->holdingSize; ++k) {
+        if (node->holdings[k].type == type) {
+            return &node->holdings[k];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Removes the holding of a node from the holders of its resource type and from the node, O(1) apart from the holdings of the nodes.
+ */
+static void removeDeadlockHolding(DeadlockDetector *detector, int node, DeadlockHolding *holding) {
+    DeadlockHolders *holders = &detector->holders[holding->type];
+    int last = holders->nodes[--holders->size];
+    holders->nodes[holding->position] = last;
+    findDeadlockHolding(&detector->nodes[last], holding->type)->position = holding->position;
+    DeadlockNode *owner = &detector->nodes[node];
+    *holding = owner->holdings[--owner->holdingSize];
+}
+
+/**
+ * @brief Doubles the nodes and the search buffers of a DeadlockDetector.
+ */
+static void upCapacityDeadlockDetector(DeadlockDetector *detector, Allocator *allocator) {
+    int capacity = 2 * detector->capacity;
+    int old = detector->capacity;
+    detector->nodes = allocator->reallocate(allocator, detector->nodes, old * sizeof(DeadlockNode), capacity * sizeof(DeadlockNode));
+    detector->stack = allocator->reallocate(allocator, detector->stack, old * sizeof(int), capacity * sizeof(int));
+    detector->forward = allocator->reallocate(allocator, detector->forward, old * sizeof(int), capacity * sizeof(int));
+    detector->backward = allocator->reallocate(allocator, detector->backward, old * sizeof(int), capacity * sizeof(int));
+    detector->keys = allocator->reallocate(allocator, detector->keys, old * sizeof(uint64_t), capacity * sizeof(uint64_t));
+    detector->crossing = allocator->reallocate(allocator, detector->crossing, (old + 1) * sizeof(int), (capacity + 1) * sizeof(int));
+    assert(detector->nodes != NULL && detector->stack != NULL && detector->forward != NULL && detector->backward != NULL);
+    assert(detector->keys != NULL && detector->crossing != NULL);
+    detector->capacity = capacity;
+}
+
+/**
+ * @brief Initializes an empty DeadlockDetector.
+ *
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the initialized DeadlockDetector.
+ */
+DeadlockDetector *initDeadlockDetector(Allocator *allocator) {
+    DeadlockDetector *detector = allocator->allocate(allocator, sizeof(DeadlockDetector));
+    assert(detector != NULL);
+    int capacity = DEADLOCK_DETECTOR_INIT_SIZE;
+    detector->nodes = allocator->allocate(allocator, capacity * sizeof(DeadlockNode));
+    detector->stack = allocator->allocate(allocator, capacity * sizeof(int));
+    detector->forward = allocator->allocate(allocator, capacity * sizeof(int));
+    detector->backward = allocator->allocate(allocator, capacity * sizeof(int));
+    detector->keys = allocator->allocate(allocator, capacity * sizeof(uint64_t));
+    detector->crossing = allocator->allocate(allocator, (capacity + 1) * sizeof(int));
+    detector->index = createHashMapProcess(HASH_MAP_PROCESS_INIT_SIZE);
+    assert(detector->nodes != NULL && detector->index != NULL);
+    detector->holders = NULL;
+    detector->types = 0;
+    detector->size = 0;
+    detector->capacity = capacity;
+    detector->nextOrder = 0;
+    detector->epoch = 0;
+    detector->visited = 0;
+    return detector;
+}
+
+/**
+ * @brief Destroys a DeadlockDetector and the edges of every process in it.
+ *
+ * @param detector Pointer to the DeadlockDetector structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyDeadlockDetector(DeadlockDetector *detector, Allocator *allocator) {
+    if (detector == NULL) {
+        return;
+    }
+    for (int i = 0; i < detector->size; ++i) {
+        allocator->deallocate(allocator, detector->nodes[i].out, detector->nodes[i].outCapacity * sizeof(int));
+        allocator->deallocate(allocator, detector->nodes[i].in, detector->nodes[i].inCapacity * sizeof(int));
+        allocator->deallocate(allocator, detector->nodes[i].holdings, detector->nodes[i].holdingCapacity * sizeof(DeadlockHolding));
+    }
+    for (int type = 0; type < detector->types; ++type) {
+        allocator->deallocate(allocator, detector->holders[type].nodes, detector->holders[type].capacity * sizeof(int));
+    }
+    allocator->deallocate(allocator, detector->holders, detector->types * sizeof(DeadlockHolders));
+    int capacity = detector->capacity;
+    allocator->deallocate(allocator, detector->crossing, (capacity + 1) * sizeof(int));
+    allocator->deallocate(allocator, detector->keys, capacity * sizeof(uint64_t));
+    allocator->deallocate(allocator, detector->backward, capacity * sizeof(int));
+    allocator->deallocate(allocator, detector->forward, capacity * sizeof(int));
+    allocator->deallocate(allocator, detector->stack, capacity * sizeof(int));
+    allocator->deallocate(allocator, detector->nodes, capacity * sizeof(DeadlockNode));
+    destroyHashMapProcess(detector->index);
+    allocator->deallocate(allocator, detector, sizeof(DeadlockDetector));
+}
+
+/**
+ * @brief Adds a process to a DeadlockDetector, after every process already in it in the topological order, O(1).
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param p_id The process ID, not yet in the DeadlockDetector.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void pushProcessToDeadlockDetector(DeadlockDetector *detector, int p_id, Allocator *allocator) {
+    assert(deadlockNodeOf(detector, p_id) < 0);
+    if (detector->size >= detector->capacity) {
+        upCapacityDeadlockDetector(detector, allocator);
+    }
+    int i = detector->size++;
+    DeadlockNode *node = &detector->nodes[i];
+    memset(node, 0, sizeof(DeadlockNode));
+    node->p_id = p_id;
+    node->order = detector->nextOrder++;
+    insertProcess(detector->index, p_id, (void *) (intptr_t) (i + 1));
+}
+
+/**
+ * @brief Removes a process, its resources and every wait edge from or to it from a DeadlockDetector.
+ *
+ * Removing edges never breaks the topological order. The last node moves into the freed place (swap-remove),
+ * so apart from the edges of the two nodes the removal is O(1). A p_id that is not in the DeadlockDetector is ignored.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param p_id The process ID, for example the victim of a DeadlockReport.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void removeProcessFromDeadlockDetector(DeadlockDetector *detector, int p_id, Allocator *allocator) {
+    int i = deadlockNodeOf(detector, p_id);
+    if (i < 0) {
+        return;
+    }
+    DeadlockNode *node = &detector->nodes[i];
+    for (int k = 0; k < node->outSize; ++k) {
+        removeDeadlockList(detector->nodes[node->out[k]].in, &detector->nodes[node->out[k]].inSize, i);
+    }
+    for (int k = 0; k < node->inSize; ++k) {
+        removeDeadlockList(detector->nodes[node->in[k]].out, &detector->nodes[node->in[k]].outSize, i);
+    }
+    while (node->holdingSize > 0) {
+        removeDeadlockHolding(detector, i, &node->holdings[node->holdingSize - 1]);
+    }
+    allocator->deallocate(allocator, node->holdings, node->holdingCapacity * sizeof(DeadlockHolding));
+    allocator->deallocate(allocator, node->out, node->outCapacity * sizeof(int));
+    allocator->deallocate(allocator, node->in, node->inCapacity * sizeof(int));
+    removeProcess(detector->index, p_id);
+
+    int last = --detector->size;
+    if (i != last) {
+        *node = detector->nodes[last];
+        for (int k = 0; k < node->outSize; ++k) {
+            DeadlockNode *to = &detector->nodes[node->out[k]];
+            replaceDeadlockList(to->in, to->inSize, last, i);
+        }
+        for (int k = 0; k < node->inSize; ++k) {
+            DeadlockNode *from = &detector->nodes[node->in[k]];
+            replaceDeadlockList(from->out, from->outSize, last, i);
+        }
+        for (int k = 0; k < node->holdingSize; ++k) {
+            detector->holders[node->holdings[k].type].nodes[node->holdings[k].position] = i;
+        }
+        insertProcess(detector->index, node->p_id, (void *) (intptr_t) (i + 1));
+    }
+}
+
+/**
+ * @brief Records resources assigned to a process; the process becomes a holder of the resource type.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param p_id The process ID.
+ * @param resource Pointer to the BaseAllocate with the type and number assigned.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void holdDeadlockResource(DeadlockDetector *detector, int p_id, BaseAllocate *resource, Allocator *allocator) {
+    int i = deadlockNodeOf(detector, p_id);
+    assert(i >= 0 && resource->number >= 0);
+    if (resource->number == 0) {
+        return;
+    }
+    int type = resource->type;
+    if (type >= detector->types) {
+        int types = resourceTypeCount();
+        assert(type < types);
+        detector->holders = allocator->reallocate(allocator, detector->holders,
+                                                  detector->types * sizeof(DeadlockHolders), types * sizeof(DeadlockHolders));
+        assert(detector->holders != NULL);
+        memset(detector->holders + detector->types, 0, (types - detector->types) * sizeof(DeadlockHolders));
+        detector->types = types;
+    }
+    DeadlockNode *node = &detector->nodes[i];
+    node->heldTotal += resource->number;
+    DeadlockHolding *holding = findDeadlockHolding(node, type);
+    if (holding != NULL) {
+        holding->number += resource->number;
+        return;
+    }
+    if (node->holdingSize >= node->holdingCapacity) {
+        int grown = node->holdingCapacity == 0 ? 4 : 2 * node->holdingCapacity;
+        node->holdings = allocator->reallocate(allocator, node->holdings,
+                                               node->holdingCapacity * sizeof(DeadlockHolding), grown * sizeof(DeadlockHolding));
+        assert(node->holdings != NULL);
+        node->holdingCapacity = grown;
+    }
+    DeadlockHolders *holders = &detector->holders[type];
+    node->holdings[node->holdingSize++] = (DeadlockHolding) {type, resource->number, holders->size};
+    pushDeadlockList(&holders->nodes, &holders->size, &holders->capacity, i, allocator);
+}
+
+/**
+ * @brief Records resources returned by a process; once it holds none of the type it is no longer a holder.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param p_id The process ID.
+ * @param resource Pointer to the BaseAllocate with the type and number released, at most the number held.
+ */
+void releaseDeadlockResource(DeadlockDetector *detector, int p_id, BaseAllocate *resource) {
+    int i = deadlockNodeOf(detector, p_id);
+    assert(i >= 0 && resource->number >= 0);
+    if (resource->number == 0) {
+        return;
+    }
+    DeadlockNode *node = &detector->nodes[i];
+    DeadlockHolding *holding = findDeadlockHolding(node, resource->type);
+    assert(holding != NULL && resource->number <= holding->number);
+    holding->number -= resource->number;
+    node->heldTotal -= resource->number;
+    if (holding->number == 0) {
+        removeDeadlockHolding(detector, i, holding);
+    }
+}
+
+/**
+ * @brief Chooses the victim of the cycles closed by the edge waiter -> holder.
+ *
+ * The nodes marked by the forward search are the ones reachable from holder with an order up to the one of waiter.
+ * Those that also reach waiter form the region of every holder ⇝ waiter path. Sorted by order, a node of the region
+ * that no edge of the region jumps over lies on every path; removing it breaks every cycle.
+ * Among them the one holding the fewest resources is chosen, ties going to the node closest to waiter.
+ */
+static DeadlockReport chooseDeadlockVictim(DeadlockDetector *detector, int waiter, unsigned int forwardMark) {
+    DeadlockNode *nodes = detector->nodes;
+    unsigned int regionMark = ++detector->epoch;
+    int top = 0;
+    int region = 0;
+    nodes[waiter].mark = regionMark;
+    detector->stack[top++] = waiter;
+    while (top > 0) {
+        int w = detector->stack[--top];
+        detector->keys[region++] = deadlockOrderKey(detector, w);
+        detector->visited += 1;
+        for (int k = 0; k < nodes[w].inSize; ++k) {
+            int from = nodes[w].in[k];
+            if (nodes[from].mark == forwardMark) {
+                nodes[from].mark = regionMark;
+                detector->stack[top++] = from;
+            }
+        }
+    }
+    qsort(detector->keys, region, sizeof(uint64_t), compareDeadlockKey);
+    for (int p = 0; p < region; ++p) {
+        nodes[(uint32_t) detector->keys[p]].scratch = p;
+    }
+
+    int *crossing = detector->crossing;
+    memset(crossing, 0, (region + 1) * sizeof(int));
+    for (int p = 0; p < region; ++p) {
+        DeadlockNode *node = &nodes[(uint32_t) detector->keys[p]];
+        for (int k = 0; k < node->outSize; ++k) {
+            if (nodes[node->out[k]].mark == regionMark) {
+                crossing[p + 1] += 1;
+                crossing[nodes[node->out[k]].scratch] -= 1;
+            }
+        }
+    }
+    for (int p = 1; p < region; ++p) {
+        crossing[p] += crossing[p - 1];
+    }
+
+    DeadlockReport report = {true, -1, 0};
+    long victimCost = 0;
+    for (int p = region - 1; p >= 0; --p) {
+        if (crossing[p] != 0) {
+            continue;
+        }
+        DeadlockNode *node = &nodes[(uint32_t) detector->keys[p]];
+        long cost = node->heldTotal;
+        if (report.victim < 0 || cost < victimCost) {
+            report.victim = node->p_id;
+            victimCost = cost;
+        }
+        report.candidates += 1;
+    }
+    return report;
+}
+
+/**
+ * @brief Adds the wait edge waiter -> holder, keeping the graph acyclic and the order topological (Pearce–Kelly).
+ *
+ * @return 1 if the edge was added, 0 if it was already there, -1 if it would close a cycle; the report then names the victim.
+ */
+static int insertDeadlockEdge(DeadlockDetector *detector, int waiter, int holder, DeadlockReport *report, Allocator *allocator) {
+    DeadlockNode *nodes = detector->nodes;
+    for (int k = 0; k < nodes[waiter].outSize; ++k) {
+        if (nodes[waiter].out[k] == holder) {
+            return 0;
+        }
+    }
+
+    int lower = nodes[holder].order;
+    int upper = nodes[waiter].order;
+    if (lower < upper) {
+        // search forward from holder, through the nodes ordered no later than waiter
+        unsigned int forwardMark = ++detector->epoch;
+        int top = 0;
+        int forward = 0;
+        nodes[holder].mark = forwardMark;
+        detector->stack[top++] = holder;
+        while (top > 0) {
+            int w = detector->stack[--top];
+            detector->forward[forward++] = w;
+            detector->visited += 1;
+            for (int k = 0; k < nodes[w].outSize; ++k) {
+                int to = nodes[w].out[k];
+                if (nodes[to].mark != forwardMark && nodes[to].order <= upper) {
+                    nodes[to].mark = forwardMark;
+                    detector->stack[top++] = to;
+                }
+            }
+        }
+        if (nodes[waiter].mark == forwardMark) {
+            *report = chooseDeadlockVictim(detector, waiter, forwardMark);
+            return -1;
+        }
+
+        // search backward from waiter, through the nodes ordered after holder
+        unsigned int backwardMark = ++detector->epoch;
+        int backward = 0;
+        nodes[waiter].mark = backwardMark;
+        detector->stack[top++] = waiter;
+        while (top > 0) {
+            int w = detector->stack[--top];
+            detector->backward[backward++] = w;
+            detector->visited += 1;
+            for (int k = 0; k < nodes[w].inSize; ++k) {
+                int from = nodes[w].in[k];
+                if (nodes[from].mark != backwardMark && nodes[from].order > lower) {
+                    nodes[from].mark = backwardMark;
+                    detector->stack[top++] = from;
+                }
+            }
+        }
+
+        // the backward nodes take the smallest of their orders, the forward nodes the rest, each keeping its relative order
+        uint64_t *keys = detector->keys;
+        int *orders = detector->crossing;
+        for (int i = 0; i < backward; ++i) {
+            keys[i] = deadlockOrderKey(detector, detector->backward[i]);
+        }
+        for (int i = 0; i < forward; ++i) {
+            keys[backward + i] = deadlockOrderKey(detector, detector->forward[i]);
+        }
+        qsort(keys, backward, sizeof(uint64_t), compareDeadlockKey);
+        qsort(keys + backward, forward, sizeof(uint64_t), compareDeadlockKey);
+        for (int i = 0; i < backward + forward; ++i) {
+            orders[i] = (int) (keys[i] >> 32);
+        }
+        qsort(orders, backward + forward, sizeof(int), compareDeadlockOrder);
+        for (int i = 0; i < backward + forward; ++i) {
+            nodes[(uint32_t) keys[i]].order = orders[i];
+        }
+    }
+
+    pushDeadlockList(&nodes[waiter].out, &nodes[waiter].outSize, &nodes[waiter].outCapacity, holder, allocator);
+    pushDeadlockList(&nodes[holder].in, &nodes[holder].inSize, &nodes[holder].inCapacity, waiter, allocator);
+    return 1;
+}
+
+/**
+ * @brief Records that a process waits for a resource held by another process, and checks whether they are now deadlocked.
+ *
+ * If the order of the waiter is already before the one of the holder, this is O(1); otherwise only the nodes ordered between
+ * them are searched. An edge that would close a cycle is not added: the report names one process on every cycle it would close,
+ * the one holding the fewest resources. After removing it with removeProcessFromDeadlockDetector, the waiter can wait again.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param waiter The process ID of the waiting process.
+ * @param holder The process ID of the process holding the resource, not the waiter.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return The DeadlockReport, deadlocked is false when the wait was recorded.
+ */
+DeadlockReport waitForProcess(DeadlockDetector *detector, int waiter, int holder, Allocator *allocator) {
+    int from = deadlockNodeOf(detector, waiter);
+    int to = deadlockNodeOf(detector, holder);
+    assert(from >= 0 && to >= 0 && from != to);
+    DeadlockReport report = {false, -1, 0};
+    insertDeadlockEdge(detector, from, to, &report, allocator);
+    return report;
+}
+
+/**
+ * @brief Records that a process waits for a resource type, that is for every process holding it.
+ *
+ * Either every wait edge is added or, when one of them would close a cycle, none of the new ones.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param waiter The process ID of the waiting process.
+ * @param type The resource type waited for.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return The DeadlockReport, deadlocked is false when the wait was recorded.
+ */
+DeadlockReport waitForResource(DeadlockDetector *detector, int waiter, ResourceType type, Allocator *allocator) {
+    int from = deadlockNodeOf(detector, waiter);
+    assert(from >= 0);
+    DeadlockReport report = {false, -1, 0};
+    int before = detector->nodes[from].outSize;
+    // nobody ever held a type beyond the holders table
+    int holders = (int) type < detector->types ? detector->holders[type].size : 0;
+    for (int k = 0; k < holders; ++k) {
+        int to = detector->holders[type].nodes[k];
+        if (to != from && insertDeadlockEdge(detector, from, to, &report, allocator) < 0) {
+            // the new edges were appended to the out list of the waiter
+            while (detector->nodes[from].outSize > before) {
+                removeDeadlockEdge(detector, from, detector->nodes[from].out[detector->nodes[from].outSize - 1]);
+            }
+            break;
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Removes every wait edge of a process, for example after its request was served.
+ *
+ * @param detector Pointer to the DeadlockDetector structure.
+ * @param p_id The process ID.
+ */
+void clearDeadlockWaits(DeadlockDetector *detector, int p_id) {
+    int i = deadlockNodeOf(detector, p_id);
+    assert(i >= 0);
+    DeadlockNode *node = &detector->nodes[i];
+    for (int k = 0; k < node->outSize; ++k) {
+        removeDeadlockList(detector->nodes[node->out[k]].in, &detector->nodes[node->out[k]].inSize, i);
+    }
+    node->outSize = 0;
+}
@@ -0,0 +1,111 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 15:20
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_DEADLOCK_DETECTOR_H
+#define OPERATORSYSTEM_DEADLOCK_DETECTOR_H
+/*
+ * 死锁检测(等待图 + 增量拓扑序)
+        银行家算法是死锁避免, 要求进程事先声明最大需求 Max。声明不了 Max 的资源池只能检测:
+        进程 P 等待进程 Q 持有的资源, 就在等待图中加一条边 P -> Q, 图中出现环即死锁。
+
+        等待图始终保持无环, 并维护一个拓扑序 order(Pearce–Kelly 动态拓扑序):
+            加边 x -> y 时若 order[x] < order[y], 拓扑序仍然成立, O(1);
+            否则只在 order 位于 [order[y], order[x]] 之间的节点上搜索:
+                从 y 向前搜索(只走 order <= order[x] 的节点), 到达 x 说明成环, 死锁;
+                否则从 x 向后搜索(只走 order > order[y] 的节点), 把两次搜索到的节点重新分配它们原有的 order 值,
+                向后搜到的排在前面。
+            搜索只触及受影响的区域, 与整张图的大小无关。
+
+        成环的边不加入图中, 新产生的环都经过这条边, 即都由一条 y ⇝ x 的路径加上 x -> y 组成,
+        所以牺牲一个进程就够了(最小牺牲集合只有一个进程): 它必须位于所有 y ⇝ x 的路径上。
+        把这些路径上的节点按 order 排好, 没有任何边跨过的节点就是所有路径的必经点(x 与 y 总是);
+        在必经点中选持有资源最少的进程作为牺牲者, 相同时选等待者 x。
+        调用者移除牺牲者后重新等待即可。
+
+        等待资源类型(waitForResource)时向该类型的所有持有者加边(全部成功或全部不加)。
+        每种资源只有一个单位(锁、许可证)时等待图是精确的; 有多个单位时环只是死锁的必要条件。
+        进程只记录它持有的资源类型(稀疏), 持有者表按用到的资源类型编号增长, 运行时注册的类型同样适用。
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include "../base/resource_allocate.h"
+#include "../../tools/hashMapProcess/hashMapProcess.h"
+
+#define DEADLOCK_DETECTOR_INIT_SIZE 16
+
+typedef struct DeadlockHolding {
+    int type;
+    int number;
+    int position;                               // 在该类型持有者表中的位置
+} DeadlockHolding;
+
+typedef struct DeadlockHolders {
+    int *nodes;                                 // 持有该类资源的进程(节点下标)
+    int size;
+    int capacity;
+} DeadlockHolders;
+
+typedef struct DeadlockNode {
+    int p_id;
+    int order;                                  // 拓扑序中的位置, 等待者在被等待者之前
+    DeadlockHolding *holdings;                  // 持有的资源类型, 只记录数量大于 0 的
+    int holdingSize;
+    int holdingCapacity;
+    long heldTotal;                             // 持有的资源总数, 选牺牲者时比较
+    int *out;                                   // 等待的进程(节点下标)
+    int outSize;
+    int outCapacity;
+    int *in;                                    // 等待它的进程(节点下标)
+    int inSize;
+    int inCapacity;
+    unsigned int mark;                          // 搜索时的访问标记
+    int scratch;                                // 计算牺牲者时在区域中的位置
+} DeadlockNode;
+
+typedef struct DeadlockDetector {
+    DeadlockNode *nodes;
+    int size;
+    int capacity;
+    int nextOrder;                              // 新进程的 order, 排在所有进程之后
+    HashMapProcess *index;                      // p_id -> 节点下标 + 1
+    DeadlockHolders *holders;                   // 每类资源的持有者, 按资源类型编号下标
+    int types;                                  // holders 的长度, 随用到的最大资源类型增长
+    int *stack;                                 // 以下为搜索用的缓冲区, 与 nodes 同容量
+    int *forward;
+    int *backward;
+    uint64_t *keys;
+    int *crossing;
+    unsigned int epoch;
+    long visited;                               // 增量检查访问过的节点总数
+} DeadlockDetector;
+
+typedef struct DeadlockReport {
+    _Bool deadlocked;
+    int victim;                                 // 牺牲者的 p_id, 没有死锁时为 -1
+    int candidates;                             // 所有等待路径的必经点个数, 都可以作为牺牲者
+} DeadlockReport;
+
+
+extern DeadlockDetector *initDeadlockDetector(Allocator *allocator);
+
+extern void destroyDeadlockDetector(DeadlockDetector *detector, Allocator *allocator);
+
+extern void pushProcessToDeadlockDetector(DeadlockDetector *detector, int p_id, Allocator *allocator);
+
+extern void removeProcessFromDeadlockDetector(DeadlockDetector *detector, int p_id, Allocator *allocator);
+
+extern void holdDeadlockResource(DeadlockDetector *detector, int p_id, BaseAllocate *resource, Allocator *allocator);
+
+extern void releaseDeadlockResource(DeadlockDetector *detector, int p_id, BaseAllocate *resource);
+
+extern DeadlockReport waitForProcess(DeadlockDetector *detector, int waiter, int holder, Allocator *allocator);
+
+extern DeadlockReport waitForResource(DeadlockDetector *detector, int waiter, ResourceType type, Allocator *allocator);
+
+extern void clearDeadlockWaits(DeadlockDetector *detector, int p_id);
+
+#endif //OPERATORSYSTEM_DEADLOCK_DETECTOR_H
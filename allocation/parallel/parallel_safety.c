@@ -0,0 +1,225 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 09:15
+*/
+#include "parallel_safety.h"
+
+typedef struct ParallelSafetyRound ParallelSafetyRound;
+
+typedef struct ParallelSafetyTask {
+    ParallelSafetyRound *round;
+    int firstWord;                              // 本段的位图字 [firstWord, lastWord)
+    int lastWord;
+    int found;                                  // 本轮可运行的行数
+    int32_t *partial;                           // 本轮可运行行的 Allocation 之和, state->columns 列
+} ParallelSafetyTask;
+
+struct ParallelSafetyRound {
+    BankerState *state;
+    BankerWorkspace *workspace;
+    int rows;
+    pthread_mutex_t mutex;
+    pthread_cond_t started;
+    pthread_cond_t finished;
+    long generation;                            // 调用线程每开始一轮加一
+    int pending;                                // 本轮还没完成的线程数
+    _Bool stopping;
+};
+
+
+/**
+ * @brief Scans the rows of a task, marks the runnable ones finished and sums their Allocation rows.
+ */
+static void scanParallelSafetyTask(ParallelSafetyTask *task) {
+    ParallelSafetyRound *round = task->round;
+    BankerState *state = round->state;
+    BankerWorkspace *workspace = round->workspace;
+    int first = task->firstWord * 64;
+    int last = task->lastWord * 64 < round->rows ? task->lastWord * 64 : round->rows;
+
+    memset(task->partial, 0, state->columns * sizeof(int32_t));
+    task->found = 0;
+    if (first >= last) {
+        return;
+    }
+    task->found = scanRunnableRows(bankerStateRow(state, needMatrix, first), state->columns, last - first, workspace->work,
+                                   workspace->finish + task->firstWord, workspace->runnable + task->firstWord);
+    for (int word = task->firstWord; word < task->lastWord; ++word) {
+        uint64_t bits = workspace->runnable[word];
+        workspace->finish[word] |= bits;
+        while (bits != 0) {
+            int i = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, i);
+            for (int j = 0; j < state->columns; ++j) {
+                task->partial[j] += allocationRow[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Thread entry point of checkResourceSecurityParallel: scans its task once per round until the check stops.
+ *
+ * @param args Pointer to the ParallelSafetyTask of the thread.
+ * @return NULL.
+ */
+static void *parallelSafetyWorker(void *args) {
+    ParallelSafetyTask *task = args;
+    ParallelSafetyRound *round = task->round;
+    long generation = 0;
+    pthread_mutex_lock(&round->mutex);
+    while (true) {
+        while (round->generation == generation && !round->stopping) {
+            pthread_cond_wait(&round->started, &round->mutex);
+        }
+        if (round->stopping) {
+            break;
+        }
+        generation = round->generation;
+        pthread_mutex_unlock(&round->mutex);
+
+        scanParallelSafetyTask(task);
+
+        pthread_mutex_lock(&round->mutex);
+        if (--round->pending == 0) {
+            pthread_cond_signal(&round->finished);
+        }
+    }
+    pthread_mutex_unlock(&round->mutex);
+    return NULL;
+}
+
+/**
+ * @brief Runs one round: the started threads scan their tasks while the calling thread scans the others.
+ */
+static void runParallelSafetyRound(ParallelSafetyRound *round, int count, ParallelSafetyTask tasks[count], const _Bool started[count]) {
+    int threads = 0;
+    for (int t = 0; t < count; ++t) {
+        threads += started[t];
+    }
+    pthread_mutex_lock(&round->mutex);
+    round->generation += 1;
+    round->pending = threads;
+    pthread_cond_broadcast(&round->started);
+    pthread_mutex_unlock(&round->mutex);
+
+    for (int t = 0; t < count; ++t) {
+        if (!started[t]) {
+            scanParallelSafetyTask(&tasks[t]);
+        }
+    }
+
+    pthread_mutex_lock(&round->mutex);
+    while (round->pending > 0) {
+        pthread_cond_wait(&round->finished, &round->mutex);
+    }
+    pthread_mutex_unlock(&round->mutex);
+}
+
+/**
+ * @brief Checks if the system is in a safe state, with the rows of every pass scanned by several threads.
+ *
+ * This function gives the same verdict and the same safe sequence as the scan of checkResourceSecurity, whatever the number of workers.
+ * The words of the Finish bitmap are split into workers contiguous ranges. In every round each worker finds the runnable rows of its range
+ * with scanRunnableRows, marks them finished and sums their Allocation rows; the calling thread then appends the runnable rows to the
+ * safe sequence in row order and adds the partial sums to Work in range order. If a round finds nothing, the system is unsafe.
+ *
+ * The calling thread is the first worker; the others are started for the check and stopped before it returns.
+ * If a thread cannot be started, its range is scanned on the calling thread instead.
+ * The safe sequence is left in the sequence buffer of the BankerWorkspace and becomes the witness of checkResourceSecurity.
+ *
+ * @param banker Pointer to the Banker structure representing the system state.
+ * @param workers The number of threads scanning, at most PARALLEL_SAFETY_MAX_WORKERS.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @param orderExecute Pointer to the array where the safe sequence will be stored, may be NULL.
+ * @return Boolean value indicating whether the system is in a safe state.
+ */
+_Bool checkResourceSecurityParallel(
+        Banker *banker,
+        int workers,
+        SystemResource *systemResource,
+        BankProConBlock *(*orderExecute)[banker->size]
+) {
+    BankerState *state = banker->state;
+    BankerWorkspace *workspace = banker->workspace;
+    (void) systemResource;
+    assert(state->rows == banker->size);
+    assert(workers > 0 && workers <= PARALLEL_SAFETY_MAX_WORKERS);
+    int rows = banker->size;
+    if (rows == 0) {
+        return true;
+    }
+    resetBankerWorkspace(workspace, state);
+
+    int words = bankerWorkspaceWords(rows);
+    int count = workers < words ? workers : words;
+    ParallelSafetyRound round = {.state = state, .workspace = workspace, .rows = rows, .generation = 0, .pending = 0, .stopping = false};
+    pthread_mutex_init(&round.mutex, NULL);
+    pthread_cond_init(&round.started, NULL);
+    pthread_cond_init(&round.finished, NULL);
+
+    ParallelSafetyTask tasks[count];
+    int32_t partials[count][state->columns];
+    pthread_t threads[count];
+    _Bool started[count];
+    for (int t = 0; t < count; ++t) {
+        tasks[t].round = &round;
+        tasks[t].partial = partials[t];
+        tasks[t].firstWord = (int) ((long) words * t / count);
+        tasks[t].lastWord = (int) ((long) words * (t + 1) / count);
+        // the calling thread is the first worker
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, parallelSafetyWorker, &tasks[t]) == 0;
+    }
+
+    int32_t *work = workspace->work;
+    int finished = 0;
+    while (finished < rows) {
+        runParallelSafetyRound(&round, count, tasks, started);
+        int found = 0;
+        for (int t = 0; t < count; ++t) {
+            found += tasks[t].found;
+        }
+        // If no process was found, the system is not in a safe state.
+        if (found == 0) {
+            break;
+        }
+        for (int word = 0; word < words; ++word) {
+            uint64_t bits = workspace->runnable[word];
+            while (bits != 0) {
+                workspace->sequence[finished++] = word * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+            }
+        }
+        for (int t = 0; t < count; ++t) {
+            for (int j = 0; j < state->columns; ++j) {
+                work[j] += tasks[t].partial[j];
+            }
+        }
+    }
+
+    pthread_mutex_lock(&round.mutex);
+    round.stopping = true;
+    pthread_cond_broadcast(&round.started);
+    pthread_mutex_unlock(&round.mutex);
+    for (int t = 0; t < count; ++t) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    pthread_cond_destroy(&round.finished);
+    pthread_cond_destroy(&round.started);
+    pthread_mutex_destroy(&round.mutex);
+
+    if (finished < rows) {
+        return false;
+    }
+    saveBankerWitness(workspace, workspace->sequence, rows);
+    if (orderExecute != NULL) {
+        for (int i = 0; i < rows; ++i) {
+            (*orderExecute)[i] = banker->array[workspace->sequence[i]];
+        }
+    }
+    return true;
+}
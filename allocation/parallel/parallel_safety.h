@@ -0,0 +1,37 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 09:15
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_PARALLEL_SAFETY_H
+#define OPERATORSYSTEM_PARALLEL_SAFETY_H
+/*
+ * 多线程的安全性检查
+        与 scanSafeSequence 相同的逐轮扫描, 每轮把 Need 矩阵按 64 行一字的 Finish/Runnable 位图切成连续的段, 每个线程一段:
+            1. 各线程用 scanRunnableRows 找出本段所有 Need <= Work 的未完成行, 在本段的 Finish 位图上标记完成,
+               并把这些行的 Allocation 累加到自己的部分和;
+            2. 调用线程等所有段完成后, 按行号顺序把本轮可运行的行追加到安全序列, 再按段的顺序把部分和加到 Work;
+            3. 没有可运行的行则不安全, 全部完成则安全。
+        每段只写自己的位图字和部分和, 线程之间没有共享的可写状态; Work 只在两轮之间由调用线程修改。
+        整数加法与顺序无关, 安全序列按 (轮, 行号) 排列, 结果与线程数和线程的调度时机都无关,
+        与单线程的 scanSafeSequence 完全相同。
+
+        线程在一次检查开始时创建, 每轮用条件变量同步, 检查结束时退出; 行数很多(几十万以上)时才值得使用。
+ */
+
+#include <pthread.h>
+#include "../simd/banker_simd.h"
+#include "../banker.h"
+
+#define PARALLEL_SAFETY_MAX_WORKERS 64
+
+
+extern _Bool checkResourceSecurityParallel(
+        Banker *banker,
+        int workers,
+        SystemResource *systemResource,
+        BankProConBlock *(*orderExecute)[banker->size]
+);
+
+#endif //OPERATORSYSTEM_PARALLEL_SAFETY_H
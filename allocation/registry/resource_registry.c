@@ -0,0 +1,100 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 10:05
+*/
+#include "resource_registry.h"
+
+
+static const char *builtinNames[] = {"memory", "cpu", "gpu", "swap", "network", "file"};
+
+static pthread_once_t registryOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+static HashMap *registryIndex = NULL;
+static char **registryChunks[RESOURCE_REGISTRY_CHUNKS];
+static atomic_int registryCount = 0;
+
+
+/**
+ * @brief Stores the name of the next type; the caller holds the mutex.
+ */
+static int appendResourceType(const char *name) {
+    int type = atomic_load_explicit(&registryCount, memory_order_relaxed);
+    int chunk = type / RESOURCE_REGISTRY_CHUNK;
+    assert(chunk < RESOURCE_REGISTRY_CHUNKS);
+    if (registryChunks[chunk] == NULL) {
+        registryChunks[chunk] = calloc(RESOURCE_REGISTRY_CHUNK, sizeof(char *));
+        assert(registryChunks[chunk] != NULL);
+    }
+    registryChunks[chunk][type % RESOURCE_REGISTRY_CHUNK] = strdup(name);
+    insert(registryIndex, (char *) name, type);
+    // publish the name before the count
+    atomic_store_explicit(&registryCount, type + 1, memory_order_release);
+    return type;
+}
+
+/**
+ * @brief Registers the built-in types, so their numbers are the values of the ResourceType enum.
+ */
+static void initResourceRegistry(void) {
+    registryIndex = createHashMap(RESOURCE_REGISTRY_HASH_SIZE);
+    for (int i = 0; i < (int) (sizeof(builtinNames) / sizeof(builtinNames[0])); ++i) {
+        appendResourceType(builtinNames[i]);
+    }
+}
+
+/**
+ * @brief Registers a resource type by name and returns its number.
+ *
+ * Numbers are dense and given in registration order, after the built-in types. Registering a name twice returns the first number.
+ *
+ * @param name The name of the resource type, copied by the registry.
+ * @return The number of the resource type, to be used as a ResourceType.
+ */
+int registerResourceType(const char *name) {
+    pthread_once(&registryOnce, initResourceRegistry);
+    pthread_mutex_lock(&registryMutex);
+    int type = get(registryIndex, (char *) name);
+    if (type < 0) {
+        type = appendResourceType(name);
+    }
+    pthread_mutex_unlock(&registryMutex);
+    return type;
+}
+
+/**
+ * @brief Finds the number of a registered resource type.
+ *
+ * @param name The name of the resource type.
+ * @return The number of the resource type, -1 if it is not registered.
+ */
+int findResourceType(const char *name) {
+    pthread_once(&registryOnce, initResourceRegistry);
+    pthread_mutex_lock(&registryMutex);
+    int type = get(registryIndex, (char *) name);
+    pthread_mutex_unlock(&registryMutex);
+    return type;
+}
+
+/**
+ * @brief Returns the name of a resource type, O(1) and without locking.
+ *
+ * @param type The number of the resource type.
+ * @return The name, "Unknown" if the number is not registered.
+ */
+const char *resourceTypeName(int type) {
+    if (type < 0 || type >= resourceTypeCount()) {
+        return "Unknown";
+    }
+    return registryChunks[type / RESOURCE_REGISTRY_CHUNK][type % RESOURCE_REGISTRY_CHUNK];
+}
+
+/**
+ * @brief Returns the number of registered resource types; every registered number is below it.
+ *
+ * @return The number of registered resource types, at least the built-in ones.
+ */
+int resourceTypeCount(void) {
+    pthread_once(&registryOnce, initResourceRegistry);
+    return atomic_load_explicit(&registryCount, memory_order_acquire);
+}
@@ -0,0 +1,41 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 10:05
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_RESOURCE_REGISTRY_H
+#define OPERATORSYSTEM_RESOURCE_REGISTRY_H
+/*
+ * 资源类型注册表
+        ResourceType 只是一个稠密的整数编号: 内置的 memory, cpu, gpu, swap, network, file 是 0..5,
+        运行时用名字注册的新类型(许可证、数据库连接、GPU 切片……)依次得到 6, 7, 8, ...。
+        银行家与分配相关的结构都直接用编号做下标, 不再经过字符串和哈希表;
+        只有注册和按名字查找时才查一次 HashMap。
+
+        名字按块存放(每块 RESOURCE_REGISTRY_CHUNK 个), 块一旦分配就不再移动:
+        注册在互斥锁内进行, 类型个数用原子变量发布, 查名字和个数不加锁, 可以与注册并发。
+        Banker 创建时按当时已注册的类型数确定列数, 之后注册的类型只能用于之后创建的 Banker。
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../../tools/hashMap/hashMap.h"
+
+#define RESOURCE_REGISTRY_CHUNK 64
+#define RESOURCE_REGISTRY_CHUNKS 1024
+#define RESOURCE_REGISTRY_HASH_SIZE 1031
+
+
+extern int registerResourceType(const char *name);
+
+extern int findResourceType(const char *name);
+
+extern const char *resourceTypeName(int type);
+
+extern int resourceTypeCount(void);
+
+#endif //OPERATORSYSTEM_RESOURCE_REGISTRY_H
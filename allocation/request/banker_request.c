@@ -0,0 +1,391 @@
+/*
+ User: Redskaber
+ Date: 2024/1/30
+ Time: 10:18
+*/
+#include "banker_request.h"
+
+
+/**
+ * @brief Moves the resources of a request from Available to a row of Allocation in the dense BankerState, or back when sign is -1.
+ *
+ * The Need row changes by the opposite amount, so Max stays Allocation + Need. Only the columns of the request are touched.
+ */
+static void moveBankerStateResource(BankerState *state, int row, const BankerRequest *request, int32_t sign) {
+    int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+    int32_t *needRow = bankerStateRow(state, needMatrix, row);
+    for (int i = 0; i < request->member; ++i) {
+        ResourceType type = request->resource[i].type;
+        int32_t number = sign * request->resource[i].number;
+        if (number == 0) {
+            continue;
+        }
+        state->available[type] -= number;
+        allocationRow[type] += number;
+        needRow[type] -= number;
+    }
+}
+
+/**
+ * @brief Returns the number cell of a resource type in a BaseAllocateArr, NULL if the type is missing.
+ */
+static int *baseAllocateNumber(BaseAllocateArr *baseAllocateArr, ResourceType type) {
+    for (int i = 0; i < baseAllocateArr->member; ++i) {
+        if (baseAllocateArr->array[i]->type == type) {
+            return &baseAllocateArr->array[i]->number;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writes the resources of a request moved in the dense BankerState back to the BaseAllocateArr cells of the Banker and the BankProConBlock.
+ *
+ * Every resource type with a non-zero amount has a cell in the available resources and in the resources of the process,
+ * because the process could only hold or need it if it was there when the process was pushed.
+ */
+static void commitBankerStateResource(Banker *banker, BankProConBlock *bankProConBlock, const BankerRequest *request, int sign) {
+    for (int i = 0; i < request->member; ++i) {
+        ResourceType type = request->resource[i].type;
+        int number = sign * request->resource[i].number;
+        if (number == 0) {
+            continue;
+        }
+        int *available = baseAllocateNumber(banker->availableResource, type);
+        int *assigned = baseAllocateNumber(bankProConBlock->resource->assignedResource, type);
+        int *need = baseAllocateNumber(bankProConBlock->resource->needResource, type);
+        assert(available != NULL && assigned != NULL && need != NULL);
+        *available -= number;
+        *assigned += number;
+        *need -= number;
+    }
+}
+
+/**
+ * @brief Moves the Need of a request into or out of the aggregate bounds of the Banker, if they describe the current state.
+ *
+ * @param needRow The Need row of the process after the change, NULL when the bounds only have to give the request back.
+ */
+static void moveBankerRequestBounds(Banker *banker, const BankerRequest *request, const int32_t *needRow, int32_t sign) {
+    if (!isBankerBoundsFresh(banker->workspace, banker->state)) {
+        return;
+    }
+    for (int i = 0; i < request->member; ++i) {
+        int type = (int) request->resource[i].type;
+        if (type < banker->state->columns && request->resource[i].number != 0) {
+            adjustBankerBounds(banker->workspace, type, sign * request->resource[i].number,
+                               needRow != NULL ? needRow[type] : INT32_MAX);
+        }
+    }
+}
+
+/**
+ * @brief Moves the cells a request changed into the hash of the safety cache, if it describes the current state, O(1) per cell.
+ *
+ * Must be called right after moveBankerStateResource with the same row, request and sign.
+ */
+static void moveBankerRequestHash(Banker *banker, int row, const BankerRequest *request, int32_t sign) {
+    BankerSafetyCache *cache = bankerSafetyCacheOf(banker);
+    BankerState *state = banker->state;
+    if (!isBankerSafetyHashFresh(cache, state)) {
+        return;
+    }
+    const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+    for (int i = 0; i < request->member; ++i) {
+        ResourceType type = request->resource[i].type;
+        int32_t number = sign * request->resource[i].number;
+        if (number == 0) {
+            continue;
+        }
+        moveBankerSafetyCell(cache, safety_available, 0, type, state->available[type] + number, state->available[type]);
+        moveBankerSafetyCell(cache, safety_allocation, row, type, allocationRow[type] - number, allocationRow[type]);
+    }
+}
+
+/**
+ * @brief Lets the aggregate bounds describe the new version of the dense state, when they followed the change that made it.
+ */
+static void followBankerBounds(Banker *banker, _Bool fresh) {
+    if (fresh) {
+        banker->workspace->boundsVersion = banker->state->version;
+    }
+}
+
+/**
+ * @brief Lets the hash of the safety cache describe the new version of the dense state, when it followed the change that made it.
+ */
+static void followBankerSafetyHash(Banker *banker, _Bool fresh) {
+    if (fresh) {
+        bankerSafetyCacheOf(banker)->hashVersion = banker->state->version;
+    }
+}
+
+/**
+ * @brief Validates a request against the current dense state and, if it may be granted, trial-allocates it there.
+ *
+ * The dense state must be in a trial; the row of the process is logged before it changes.
+ *
+ * @return banker_request_invalid if the process is unknown or the request is negative or exceeds its need,
+ *         banker_request_wait if the available resources do not cover it, banker_request_granted once it is trial-allocated.
+ */
+static BankerRequestResult trialBankerRequest(Banker *banker, const BankerRequest *request, Allocator *allocator) {
+    BankProConBlock *bankProConBlock = findBankProConBlockFromBanker(banker, request->p_id);
+    if (bankProConBlock == NULL) {
+        return banker_request_invalid;
+    }
+    BankerState *state = banker->state;
+    const int32_t *needRow = bankerStateRow(state, needMatrix, bankProConBlock->row);
+    int invalid = 0;
+    int over = 0;
+    for (int i = 0; i < request->member; ++i) {
+        int type = (int) request->resource[i].type;
+        int32_t number = request->resource[i].number;
+        if (type >= state->columns) {
+            // the Banker has no column for it, so nobody needs any of it
+            invalid |= number != 0;
+            continue;
+        }
+        invalid |= number < 0 || number > needRow[type];
+        over |= number > state->available[type];
+    }
+    if (invalid != 0) {
+        return banker_request_invalid;
+    }
+    if (over != 0) {
+        return banker_request_wait;
+    }
+    logBankerStateRow(state, bankProConBlock->row, allocator);
+    moveBankerStateResource(state, bankProConBlock->row, request, 1);
+    moveBankerRequestBounds(banker, request, needRow, -1);
+    moveBankerRequestHash(banker, bankProConBlock->row, request, 1);
+    return banker_request_granted;
+}
+
+/**
+ * @brief Validates and trial-allocates requests[from, to) in order.
+ *
+ * @return The number of trial-allocated requests.
+ */
+static int trialBankerRequestRange(Banker *banker, BankerRequest *requests, int from, int to, Allocator *allocator) {
+    int trial = 0;
+    for (int i = from; i < to; ++i) {
+        requests[i].result = trialBankerRequest(banker, &requests[i], allocator);
+        trial += requests[i].result == banker_request_granted;
+    }
+    return trial;
+}
+
+/**
+ * @brief Writes the trial allocations of requests[from, to) back to the BaseAllocateArr cells.
+ */
+static void commitBankerRequestRange(Banker *banker, BankerRequest *requests, int from, int to) {
+    for (int i = from; i < to; ++i) {
+        if (requests[i].result == banker_request_granted) {
+            BankProConBlock *bankProConBlock = findBankProConBlockFromBanker(banker, requests[i].p_id);
+            commitBankerStateResource(banker, bankProConBlock, &requests[i], 1);
+        }
+    }
+}
+
+/**
+ * @brief Initializes a BankerRequest from an array of resource types and quantities.
+ *
+ * Quantities of the same resource type add up; resource types not listed are requested with 0.
+ * At most BANKER_REQUEST_TYPES different resource types can be listed.
+ *
+ * @param request Pointer to the BankerRequest to be initialized.
+ * @param p_id The process ID of the requesting process.
+ * @param rows The number of rows of the resourceArr array.
+ * @param resourceArr 2D array of resources, where each row contains a resource type and its quantity.
+ */
+void initBankerRequest(BankerRequest *request, int p_id, int rows, ResourceType resourceArr[rows][2]) {
+    request->p_id = p_id;
+    request->member = 0;
+    for (int i = 0; i < rows; ++i) {
+        assert((int) resourceArr[i][0] < resourceTypeCount());
+        int k = 0;
+        while (k < request->member && request->resource[k].type != resourceArr[i][0]) {
+            ++k;
+        }
+        if (k == request->member) {
+            assert(request->member < BANKER_REQUEST_TYPES);
+            request->resource[request->member++] = (BaseAllocate) {resourceArr[i][0], 0};
+        }
+        request->resource[k].number += (int) resourceArr[i][1];
+    }
+    request->result = banker_request_wait;
+}
+
+/**
+ * @brief Requests resources for a process of the Banker.
+ *
+ * The request must not exceed the need of the process. If the available resources cover it, it is trial-allocated in the dense BankerState
+ * and the safety check decides: a safe result is written back to the BaseAllocateArr cells, an unsafe one is rolled back.
+ * The aggregate bounds decide the obvious cases in O(m); otherwise the safety check first replays the last safe sequence,
+ * so a request that keeps it valid costs O(n · m).
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param p_id The process ID of the requesting process.
+ * @param rows The number of rows of the requestResourceArr array.
+ * @param requestResourceArr 2D array of requested resources, where each row contains a resource type and its requested quantity.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @return banker_request_granted if the resources were allocated, banker_request_wait if the process has to wait for them,
+ *         banker_request_invalid if the process is unknown or the request exceeds its need.
+ */
+BankerRequestResult requestResources(
+        Banker *banker,
+        int p_id,
+        int rows,
+        ResourceType requestResourceArr[rows][2],
+        SystemResource *systemResource
+) {
+    BankerRequest request;
+    initBankerRequest(&request, p_id, rows, requestResourceArr);
+    requestResourcesBatch(banker, 1, &request, systemResource);
+    return request.result;
+}
+
+/**
+ * @brief Releases resources held by a process of the Banker.
+ *
+ * The released resources go back to the available resources and to the need of the process.
+ * Releasing never turns a safe state into an unsafe one, so no safety check is made.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param p_id The process ID of the releasing process.
+ * @param rows The number of rows of the releaseResourceArr array.
+ * @param releaseResourceArr 2D array of released resources, where each row contains a resource type and its released quantity.
+ * @return banker_request_granted if the resources were released,
+ *         banker_request_invalid if the process is unknown or does not hold them.
+ */
+BankerRequestResult releaseResources(
+        Banker *banker,
+        int p_id,
+        int rows,
+        ResourceType releaseResourceArr[rows][2]
+) {
+    BankerRequest release;
+    initBankerRequest(&release, p_id, rows, releaseResourceArr);
+    return releaseBankerRequest(banker, &release);
+}
+
+/**
+ * @brief Releases the resources of a BankerRequest, as releaseResources does.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param release Pointer to the BankerRequest holding the process ID and the released resources.
+ * @return banker_request_granted if the resources were released,
+ *         banker_request_invalid if the process is unknown or does not hold them.
+ */
+BankerRequestResult releaseBankerRequest(Banker *banker, const BankerRequest *release) {
+    BankProConBlock *bankProConBlock = findBankProConBlockFromBanker(banker, release->p_id);
+    if (bankProConBlock == NULL) {
+        return banker_request_invalid;
+    }
+    BankerState *state = banker->state;
+    const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, bankProConBlock->row);
+    for (int i = 0; i < release->member; ++i) {
+        int type = (int) release->resource[i].type;
+        int32_t number = release->resource[i].number;
+        int32_t held = type < state->columns ? allocationRow[type] : 0;
+        if (number < 0 || number > held) {
+            return banker_request_invalid;
+        }
+    }
+    _Bool fresh = isBankerBoundsFresh(banker->workspace, state);
+    _Bool hashFresh = isBankerSafetyHashFresh(bankerSafetyCacheOf(banker), state);
+    moveBankerStateResource(state, bankProConBlock->row, release, -1);
+    moveBankerRequestBounds(banker, release, bankerStateRow(state, needMatrix, bankProConBlock->row), 1);
+    moveBankerRequestHash(banker, bankProConBlock->row, release, -1);
+    touchBankerState(state);
+    followBankerBounds(banker, fresh);
+    followBankerSafetyHash(banker, hashFresh);
+    commitBankerStateResource(banker, bankProConBlock, release, -1);
+    return banker_request_granted;
+}
+
+/**
+ * @brief Processes a queue of requests in order, with the same results as calling requestResources for each one.
+ *
+ * The queue is taken in chunks. Every request of a chunk is validated and trial-allocated on top of the ones before it,
+ * then one safety check covers the whole chunk: if the state with all the trial allocations is safe, so is every state on the way,
+ * and the chunk is granted. A safe chunk doubles the size of the next one.
+ * The trial runs on the dense BankerState, which logs the rows it changes and saves the Available vector, so a rollback is O(m) per request.
+ * An unsafe chunk is rolled back and retried with half its size, until the first request that makes the state unsafe is alone
+ * in its chunk; that one waits and the chunks start again from one request.
+ * A chunk in which nothing could be trial-allocated needs no check and leaves the size as it is.
+ * Before the safety check the aggregate bounds of the BankerWorkspace try to decide the chunk in O(m); only the chunks they cannot
+ * decide pay for the check.
+ * A queue of safe requests costs O(log k) safety checks, and each unsafe request adds O(log k) more at most;
+ * when most trial allocations are unsafe the chunks stay short and the cost is about that of one check per request.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param member The number of requests.
+ * @param requests Array of BankerRequests; the result of each one is filled in.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @return The number of granted requests.
+ */
+int requestResourcesBatch(
+        Banker *banker,
+        int member,
+        BankerRequest requests[member],
+        SystemResource *systemResource
+) {
+    int granted = 0;
+    int from = 0;
+    int chunk = 1;
+    BankerState *state = banker->state;
+    while (from < member) {
+        int to = member - from > chunk ? from + chunk : member;
+        BankerSafetyCache *cache = bankerSafetyCacheOf(banker);
+        _Bool hashKept = isBankerSafetyHashFresh(cache, state);
+        uint64_t hash = hashKept ? cache->hash : 0;
+        beginBankerStateTrial(state, systemResource->memory);
+        int trial = trialBankerRequestRange(banker, requests, from, to, systemResource->memory);
+        if (trial == 0) {
+            _Bool fresh = isBankerBoundsFresh(banker->workspace, state);
+            _Bool hashFresh = isBankerSafetyHashFresh(cache, state);
+            commitBankerStateTrial(state);
+            followBankerBounds(banker, fresh);
+            followBankerSafetyHash(banker, hashFresh);
+            from = to;
+            continue;
+        }
+        // the aggregate bounds settle most chunks in O(m), the safety check the others
+        int decided = decideBankerBounds(banker->workspace, state);
+        if (decided > 0 || (decided == 0 && checkResourceSecurity(banker, systemResource, NULL) == true)) {
+            _Bool hashFresh = isBankerSafetyHashFresh(cache, state);
+            commitBankerStateTrial(state);
+            followBankerBounds(banker, true);
+            followBankerSafetyHash(banker, hashFresh);
+            commitBankerRequestRange(banker, requests, from, to);
+            granted += trial;
+            from = to;
+            chunk *= 2;
+            continue;
+        }
+
+        // the dense state is exactly as before the chunk again
+        rollbackBankerStateTrial(state);
+        if (hashKept) {
+            // the hash is the one before the chunk again too
+            cache->hash = hash;
+        } else if (cache != NULL) {
+            // it was computed for the trial, the version did not change
+            cache->hashValid = false;
+        }
+        for (int i = from; i < to; ++i) {
+            if (requests[i].result == banker_request_granted) {
+                moveBankerRequestBounds(banker, &requests[i], NULL, 1);
+            }
+        }
+        if (to - from == 1) {
+            requests[from].result = banker_request_wait;
+            from = to;
+            chunk = 1;
+        } else {
+            chunk = (to - from) / 2;
+        }
+    }
+    return granted;
+}
@@ -0,0 +1,80 @@
+/*
+ User: Redskaber
+ Date: 2024/1/30
+ Time: 10:18
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_BANKER_REQUEST_H
+#define OPERATORSYSTEM_BANKER_REQUEST_H
+/*
+ * 银行家的在线资源请求与释放
+        requestResources(p_id, request):
+            1. request <= need, 否则请求超出了最大需求, 非法(invalid);
+            2. request <= available, 否则资源不足, 等待(wait);
+            3. 试探分配: available -= request, allocation += request, need -= request(只改稠密状态);
+            4. 先用聚合界(每列 Need 之和、Need 最小值)O(m) 判断一定安全或一定不安全, 判断不了才做安全性检查(先重放上一次的安全序列):
+               安全则把试探写回 BaseAllocateArr, 准予(granted); 不安全则回滚(撤销日志恢复改动的行和 Available), 等待(wait)。
+        releaseResources(p_id, release):
+            release <= allocation, 否则非法; 归还资源不会让安全状态变得不安全, 不需要安全性检查。
+
+ * 批量请求
+        requestResourcesBatch 按顺序处理一组请求, 结果与逐个调用 requestResources 完全相同, 但一段请求只做一次安全性检查:
+            1. 依次校验并试探分配一段请求(后面的请求看到前面的试探);
+            2. 整段试探后的状态安全, 则每个中间状态也都安全(少分配一些资源的状态不会更差), 整段准予, 下一段长度加倍;
+            3. 不安全则整段回滚, 长度减半重试, 直到让状态不安全的第一个请求单独成段: 它等待, 段长回到 1。
+        全部安全时 k 个请求只要 O(log k) 次检查, 每个不安全请求最多多出 O(log k) 次检查。
+ */
+
+#include "../banker.h"
+
+#define BANKER_REQUEST_TYPES 8
+
+typedef enum BankerRequestResult {
+    banker_request_granted,
+    banker_request_wait,
+    banker_request_invalid
+} BankerRequestResult;
+
+#define bankerRequestResultToString(result) _Generic((result),  \
+    enum BankerRequestResult:                                   \
+        (result == banker_request_granted) ? "granted":         \
+        (result == banker_request_wait) ? "wait":               \
+        (result == banker_request_invalid) ? "invalid": "UNKNOWN"\
+)
+
+// 只记录请求涉及的资源类型, 校验和试探分配的代价与注册了多少种类型无关
+typedef struct BankerRequest {
+    int p_id;
+    int member;
+    BaseAllocate resource[BANKER_REQUEST_TYPES];    // (类型, 数量), 每种类型最多一项
+    BankerRequestResult result;
+} BankerRequest;
+
+
+extern void initBankerRequest(BankerRequest *request, int p_id, int rows, ResourceType resourceArr[rows][2]);
+
+extern BankerRequestResult requestResources(
+        Banker *banker,
+        int p_id,
+        int rows,
+        ResourceType requestResourceArr[rows][2],
+        SystemResource *systemResource
+);
+
+extern BankerRequestResult releaseResources(
+        Banker *banker,
+        int p_id,
+        int rows,
+        ResourceType releaseResourceArr[rows][2]
+);
+
+extern BankerRequestResult releaseBankerRequest(Banker *banker, const BankerRequest *release);
+
+extern int requestResourcesBatch(
+        Banker *banker,
+        int member,
+        BankerRequest requests[member],
+        SystemResource *systemResource
+);
+
+#endif //OPERATORSYSTEM_BANKER_REQUEST_H
@@ -0,0 +1,222 @@
+/*
+ User: Redskaber
+ Date: 2024/1/28
+ Time: 16:05
+*/
+#include "banker_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BANKER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+typedef int (*ScanRunnableKernel)(const int32_t *, int, int, const int32_t *, const uint64_t *, uint64_t *);
+
+static pthread_once_t kernelOnce = PTHREAD_ONCE_INIT;
+static BankerSimdLevel kernelLevel = banker_simd_scalar;
+static ScanRunnableKernel kernel = NULL;
+
+
+/**
+ * @brief Returns the number of rows covered by a word of the bitmaps.
+ */
+static inline int wordRows(int rows, int word) {
+    int remaining = rows - word * 64;
+    return remaining < 64 ? remaining : 64;
+}
+
+/**
+ * @brief Returns the finish bits of a word, with the bits past the last row set.
+ */
+static inline uint64_t finishedWord(const uint64_t *finish, int rows, int word) {
+    int count = wordRows(rows, word);
+    uint64_t tail = count == 64 ? 0 : ~(uint64_t) 0 << count;
+    return finish[word] | tail;
+}
+
+/**
+ * @brief Scans the Need matrix one column at a time per row, without branches inside a row.
+ */
+static int scanRunnableRowsScalar(
+        const int32_t *needMatrix, int columns, int rows,
+        const int32_t *work, const uint64_t *finish, uint64_t *runnable
+) {
+    int count = 0;
+    for (int word = 0; word < bankerWorkspaceWords(rows); ++word) {
+        uint64_t finished = finishedWord(finish, rows, word);
+        uint64_t bits = 0;
+        if (finished != ~(uint64_t) 0) {
+            for (int bit = 0; bit < wordRows(rows, word); ++bit) {
+                const int32_t *needRow = needMatrix + (size_t) (word * 64 + bit) * columns;
+                int over = 0;
+                for (int j = 0; j < columns; ++j) {
+                    over |= needRow[j] > work[j];
+                }
+                bits |= (uint64_t) (over == 0) << bit;
+            }
+        }
+        runnable[word] = bits & ~finished;
+        count += __builtin_popcountll(runnable[word]);
+    }
+    return count;
+}
+
+#ifdef BANKER_SIMD_X86
+
+/**
+ * @brief Scans the Need matrix with two 128-bit compares per 8 columns.
+ */
+__attribute__((target("sse4.1")))
+static int scanRunnableRowsSse4(
+        const int32_t *needMatrix, int columns, int rows,
+        const int32_t *work, const uint64_t *finish, uint64_t *runnable
+) {
+    int count = 0;
+    for (int word = 0; word < bankerWorkspaceWords(rows); ++word) {
+        uint64_t finished = finishedWord(finish, rows, word);
+        uint64_t bits = 0;
+        if (finished != ~(uint64_t) 0) {
+            for (int bit = 0; bit < wordRows(rows, word); ++bit) {
+                const int32_t *needRow = needMatrix + (size_t) (word * 64 + bit) * columns;
+                __m128i over = _mm_setzero_si128();
+                for (int j = 0; j < columns; j += 4) {
+                    __m128i need = _mm_loadu_si128((const __m128i *) (needRow + j));
+                    __m128i have = _mm_loadu_si128((const __m128i *) (work + j));
+                    over = _mm_or_si128(over, _mm_cmpgt_epi32(need, have));
+                }
+                bits |= (uint64_t) _mm_testz_si128(over, over) << bit;
+            }
+        }
+        runnable[word] = bits & ~finished;
+        count += __builtin_popcountll(runnable[word]);
+    }
+    return count;
+}
+
+/**
+ * @brief Scans the Need matrix with one 256-bit compare per 8 columns; a row of the BankerState is exactly one compare.
+ */
+__attribute__((target("avx2,popcnt")))
+static int scanRunnableRowsAvx2(
+        const int32_t *needMatrix, int columns, int rows,
+        const int32_t *work, const uint64_t *finish, uint64_t *runnable
+) {
+    int count = 0;
+    for (int word = 0; word < bankerWorkspaceWords(rows); ++word) {
+        uint64_t finished = finishedWord(finish, rows, word);
+        uint64_t bits = 0;
+        if (finished != ~(uint64_t) 0) {
+            for (int bit = 0; bit < wordRows(rows, word); ++bit) {
+                const int32_t *needRow = needMatrix + (size_t) (word * 64 + bit) * columns;
+                __m256i over = _mm256_setzero_si256();
+                for (int j = 0; j < columns; j += 8) {
+                    __m256i need = _mm256_loadu_si256((const __m256i *) (needRow + j));
+                    __m256i have = _mm256_loadu_si256((const __m256i *) (work + j));
+                    over = _mm256_or_si256(over, _mm256_cmpgt_epi32(need, have));
+                }
+                bits |= (uint64_t) _mm256_testz_si256(over, over) << bit;
+            }
+        }
+        runnable[word] = bits & ~finished;
+        count += __builtin_popcountll(runnable[word]);
+    }
+    return count;
+}
+
+#endif
+
+/**
+ * @brief Returns the kernel of a SIMD level.
+ */
+static ScanRunnableKernel kernelOfLevel(BankerSimdLevel level) {
+#ifdef BANKER_SIMD_X86
+    switch (level) {
+        case banker_simd_avx2:
+            return scanRunnableRowsAvx2;
+        case banker_simd_sse4:
+            return scanRunnableRowsSse4;
+        default:
+            break;
+    }
+#endif
+    return scanRunnableRowsScalar;
+}
+
+/**
+ * @brief Selects the widest kernel the CPU supports.
+ */
+static void selectKernel(void) {
+    kernelLevel = banker_simd_scalar;
+#ifdef BANKER_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernelLevel = banker_simd_avx2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        kernelLevel = banker_simd_sse4;
+    }
+#endif
+    kernel = kernelOfLevel(kernelLevel);
+}
+
+/**
+ * @brief Returns the SIMD level used by scanRunnableRows.
+ *
+ * @return The BankerSimdLevel selected for the CPU, or the one forced by forceBankerSimdLevel.
+ */
+BankerSimdLevel bankerSimdLevel(void) {
+    pthread_once(&kernelOnce, selectKernel);
+    return kernelLevel;
+}
+
+/**
+ * @brief Forces scanRunnableRows to use a SIMD level, for example to compare the kernels.
+ *
+ * A level the CPU does not support is lowered to the widest supported one. Must not be called while other threads scan.
+ *
+ * @param level The BankerSimdLevel to be used.
+ * @return The BankerSimdLevel used before.
+ */
+BankerSimdLevel forceBankerSimdLevel(BankerSimdLevel level) {
+    pthread_once(&kernelOnce, selectKernel);
+    BankerSimdLevel previous = kernelLevel;
+#ifdef BANKER_SIMD_X86
+    if (level == banker_simd_avx2 && !__builtin_cpu_supports("avx2")) {
+        level = banker_simd_sse4;
+    }
+    if (level == banker_simd_sse4 && !__builtin_cpu_supports("sse4.1")) {
+        level = banker_simd_scalar;
+    }
+#else
+    level = banker_simd_scalar;
+#endif
+    kernelLevel = level;
+    kernel = kernelOfLevel(level);
+    return previous;
+}
+
+/**
+ * @brief Finds every unfinished row of a Need matrix that fits into the Work vector.
+ *
+ * Bit i of runnable is set when row i is not finished and every column of its Need is at most the Work of that column.
+ * The rows are read in order, so the scan is bound by memory bandwidth rather than by branches.
+ *
+ * @param needMatrix Pointer to the row-major Need matrix.
+ * @param columns The width of a row, a multiple of 8.
+ * @param rows The number of rows.
+ * @param work Pointer to the Work vector, columns entries.
+ * @param finish Pointer to the Finish bitmap.
+ * @param runnable Pointer to the bitmap to be filled, bankerWorkspaceWords(rows) words.
+ * @return The number of runnable rows.
+ */
+int scanRunnableRows(
+        const int32_t *needMatrix,
+        int columns,
+        int rows,
+        const int32_t *work,
+        const uint64_t *finish,
+        uint64_t *runnable
+) {
+    assert(columns % 8 == 0);
+    pthread_once(&kernelOnce, selectKernel);
+    return kernel(needMatrix, columns, rows, work, finish, runnable);
+}
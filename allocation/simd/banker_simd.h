@@ -0,0 +1,51 @@
+/*
+ User: Redskaber
+ Date: 2024/1/28
+ Time: 16:05
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_BANKER_SIMD_H
+#define OPERATORSYSTEM_BANKER_SIMD_H
+/*
+ * 安全性检查的向量化候选扫描
+        一次扫描整张 Need 矩阵, 对每个未完成的行判断 Need <= Work, 结果写成位图(每行一位)。
+        行宽是 8 的倍数(bankerStateColumns):
+            AVX2:   一行 8 列一次 256 位比较;
+            SSE4.1: 一行 8 列两次 128 位比较;
+            标量:   逐列比较, 无分支累积。
+        运行时按 CPU 支持选择一次(pthread_once), 非 x86 平台只有标量版本。
+        Finish 位图整字为 1 的 64 行直接跳过。
+ */
+
+#include <stdint.h>
+#include <pthread.h>
+#include "../state/banker_state.h"
+
+typedef enum BankerSimdLevel {
+    banker_simd_scalar,
+    banker_simd_sse4,
+    banker_simd_avx2
+} BankerSimdLevel;
+
+#define bankerSimdLevelToString(level) _Generic((level), \
+    enum BankerSimdLevel:                                \
+        (level == banker_simd_scalar) ? "scalar":        \
+        (level == banker_simd_sse4) ? "sse4.1":          \
+        (level == banker_simd_avx2) ? "avx2": "UNKNOWN"  \
+)
+
+
+extern BankerSimdLevel bankerSimdLevel(void);
+
+extern BankerSimdLevel forceBankerSimdLevel(BankerSimdLevel level);
+
+extern int scanRunnableRows(
+        const int32_t *needMatrix,
+        int columns,
+        int rows,
+        const int32_t *work,
+        const uint64_t *finish,
+        uint64_t *runnable
+);
+
+#endif //OPERATORSYSTEM_BANKER_SIMD_H
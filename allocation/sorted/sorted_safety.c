@@ -0,0 +1,111 @@
+/*
+ User: Redskaber
+ Date: 2024/1/29
+ Time: 14:27
+*/
+#include "sorted_safety.h"
+
+
+/**
+ * @brief Packs a need and its row into a key whose unsigned order is the order of the need.
+ */
+static inline uint64_t sortedNeedKey(int32_t need, int row) {
+    return (uint64_t) ((uint32_t) need ^ 0x80000000u) << 32 | (uint32_t) row;
+}
+
+static inline int32_t sortedNeedOfKey(uint64_t key) {
+    return (int32_t) ((uint32_t) (key >> 32) ^ 0x80000000u);
+}
+
+static inline int sortedRowOfKey(uint64_t key) {
+    return (int) (uint32_t) key;
+}
+
+static int compareSortedNeedKey(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Checks if the system is in a safe state, with processes sorted by need per resource type.
+ *
+ * This function gives the same verdict as checkResourceSecurity in O(m · n log n) instead of O(n² · m).
+ * Each column of the Need matrix is sorted once; a cursor per column moves past every process whose need of that resource fits into Work,
+ * and a process becomes runnable when the cursors of all columns have passed it. Runnable processes return their Allocation row to Work,
+ * which lets the cursors move on. The order in which processes become runnable is the safe sequence.
+ *
+ * The sort keys live in the BankerWorkspace; they are allocated by the first call and only grow with the rows.
+ * The safe sequence is also left in the sequence buffer of the BankerWorkspace, as rows.
+ *
+ * @param banker Pointer to the Banker structure representing the system state.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @param orderExecute Pointer to the array where the safe sequence will be stored, may be NULL.
+ * @return Boolean value indicating whether the system is in a safe state.
+ */
+_Bool checkResourceSecuritySorted(
+        Banker *banker,
+        SystemResource *systemResource,
+        BankProConBlock *(*orderExecute)[banker->size]
+) {
+    BankerState *state = banker->state;
+    BankerWorkspace *workspace = banker->workspace;
+    assert(state->rows == banker->size);
+    int rows = banker->size;
+    int columns = state->columns;
+    if (rows == 0) {
+        return true;
+    }
+    reserveSortedBankerWorkspace(workspace, rows, systemResource->memory);
+    resetBankerWorkspace(workspace, state);
+
+    // sort every column of the Need matrix
+    for (int j = 0; j < columns; ++j) {
+        uint64_t *column = workspace->sortedNeed + (size_t) j * rows;
+        for (int i = 0; i < rows; ++i) {
+            column[i] = sortedNeedKey(bankerStateRow(state, needMatrix, i)[j], i);
+        }
+        qsort(column, rows, sizeof(uint64_t), compareSortedNeedKey);
+    }
+    memset(workspace->satisfied, 0, rows * sizeof(int));
+
+    int32_t *work = workspace->work;
+    int *sequence = workspace->sequence;
+    int cursor[columns];
+    memset(cursor, 0, sizeof(cursor));
+    int ready = 0;
+    int finished = 0;
+    while (true) {
+        // move every cursor past the processes whose need of that resource fits into work
+        for (int j = 0; j < columns; ++j) {
+            const uint64_t *column = workspace->sortedNeed + (size_t) j * rows;
+            while (cursor[j] < rows && sortedNeedOfKey(column[cursor[j]]) <= work[j]) {
+                int row = sortedRowOfKey(column[cursor[j]++]);
+                if (++workspace->satisfied[row] == columns) {
+                    sequence[ready++] = row;
+                }
+            }
+        }
+        if (finished == ready) {
+            break;
+        }
+        // the runnable processes finish and return their allocations
+        while (finished < ready) {
+            int row = sequence[finished++];
+            const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+            for (int j = 0; j < columns; ++j) {
+                work[j] += allocationRow[j];
+            }
+        }
+    }
+
+    if (finished < rows) {
+        return false;
+    }
+    if (orderExecute != NULL) {
+        for (int i = 0; i < rows; ++i) {
+            (*orderExecute)[i] = banker->array[sequence[i]];
+        }
+    }
+    return true;
+}
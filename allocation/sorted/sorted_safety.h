@@ -0,0 +1,32 @@
+/*
+ User: Redskaber
+ Date: 2024/1/29
+ Time: 14:27
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SORTED_SAFETY_H
+#define OPERATORSYSTEM_SORTED_SAFETY_H
+/*
+ * 按需求排序的安全性检查 O(m · n log n)
+        逐轮扫描找可运行进程最坏要 n 轮, O(n² · m)。
+        排序版本:
+            1. 每种资源 j 把所有进程按 need[i][j] 升序排好, 指针 cursor[j] 指向第一个 need > work[j] 的位置;
+            2. cursor[j] 每越过一个进程, 该进程已满足的资源数 satisfied[i] 加一, 等于列数时进程可运行, 进入就绪队列;
+            3. 取出就绪进程, work += allocation[i], work 只增不减, 各列指针继续向后推进。
+        每个 (进程, 资源) 只被越过一次, 排序 O(m · n log n), 推进与归还 O(n · m)。
+        就绪队列就是安全序列本身。
+
+        行数达到 BANKER_SORTED_SAFETY_ROWS 时 checkResourceSecurity 自动改用这个版本。
+ */
+
+#include "../banker.h"
+
+#define BANKER_SORTED_SAFETY_ROWS 4096
+
+extern _Bool checkResourceSecuritySorted(
+        Banker *banker,
+        SystemResource *systemResource,
+        BankProConBlock *(*orderExecute)[banker->size]
+);
+
+#endif //OPERATORSYSTEM_SORTED_SAFETY_H
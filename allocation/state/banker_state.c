@@ -0,0 +1,566 @@
+/*
+ User: Redskaber
+ Date: 2024/1/26
+ Time: 15:12
+*/
+#include "banker_state.h"
+
+
+/**
+ * @brief Initializes an empty BankerState.
+ *
+ * The matrices are allocated when the first row is pushed, so an empty Banker only pays for the BankerState itself
+ * and its Available vector.
+ *
+ * @param columns The width of a row, a multiple of 8 above every resource type the Banker uses.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created BankerState structure.
+ */
+BankerState *initBankerState(int columns, Allocator *allocator) {
+    assert(columns > 0 && columns % 8 == 0);
+    BankerState *state = allocator->allocate(allocator, sizeof(BankerState) + columns * sizeof(int32_t));
+    assert(state != NULL);
+    state->maxMatrix = NULL;
+    state->allocationMatrix = NULL;
+    state->needMatrix = NULL;
+    memset(state->available, 0, columns * sizeof(int32_t));
+    state->trial = NULL;
+    state->columns = columns;
+    state->rows = 0;
+    state->capacity = 0;
+    state->version = 0;
+    return state;
+}
+
+/**
+ * @brief Returns the size in bytes of an undo log of a number of entries.
+ */
+static inline size_t bankerStateUndoSize(BankerState *state, int entries) {
+    return (size_t) entries * (1 + 2 * state->columns) * sizeof(int32_t);
+}
+
+/**
+ * @brief Destroys a BankerState and its matrices.
+ *
+ * @param state Pointer to the BankerState structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyBankerState(BankerState *state, Allocator *allocator) {
+    if (state != NULL) {
+        size_t matrixSize = (size_t) state->capacity * state->columns * sizeof(int32_t);
+        allocator->deallocate(allocator, state->maxMatrix, matrixSize);
+        allocator->deallocate(allocator, state->allocationMatrix, matrixSize);
+        allocator->deallocate(allocator, state->needMatrix, matrixSize);
+        if (state->trial != NULL) {
+            allocator->deallocate(allocator, state->trial->undoLog, bankerStateUndoSize(state, state->trial->undoCapacity));
+            allocator->deallocate(allocator, state->trial, sizeof(BankerStateTrial) + state->columns * sizeof(int32_t));
+        }
+        allocator->deallocate(allocator, state, sizeof(BankerState) + state->columns * sizeof(int32_t));
+    }
+}
+
+/**
+ * @brief Copies the available resources of a Banker into the Available vector, O(m).
+ *
+ * Resource types missing from the BaseAllocateArr are available with 0.
+ *
+ * @param state Pointer to the BankerState structure.
+ * @param availableResource Pointer to the BaseAllocateArr of available resources.
+ */
+void loadBankerStateAvailable(BankerState *state, BaseAllocateArr *availableResource) {
+    memset(state->available, 0, state->columns * sizeof(int32_t));
+    for (int i = 0; i < availableResource->member; ++i) {
+        int type = (int) availableResource->array[i]->type;
+        assert(type < state->columns);
+        state->available[type] = availableResource->array[i]->number;
+    }
+    touchBankerState(state);
+}
+
+/**
+ * @brief Grows the three matrices of a BankerState to hold at least one more row.
+ */
+static void upCapacityBankerState(BankerState *state, Allocator *allocator) {
+    int capacity = state->capacity == 0 ? BANKER_STATE_INIT_ROWS : 2 * state->capacity;
+    size_t oldSize = (size_t) state->capacity * state->columns * sizeof(int32_t);
+    size_t newSize = (size_t) capacity * state->columns * sizeof(int32_t);
+
+    state->maxMatrix = allocator->reallocate(allocator, state->maxMatrix, oldSize, newSize);
+    state->allocationMatrix = allocator->reallocate(allocator, state->allocationMatrix, oldSize, newSize);
+    state->needMatrix = allocator->reallocate(allocator, state->needMatrix, oldSize, newSize);
+    assert(state->maxMatrix != NULL && state->allocationMatrix != NULL && state->needMatrix != NULL);
+    state->capacity = capacity;
+}
+
+/**
+ * @brief Copies the Max, Allocation and Need of an AllocatorResource into a row of the matrices, O(m).
+ *
+ * The cells of the AllocatorResource are scattered by resource type; columns of types the process does not use are 0.
+ *
+ * @param state Pointer to the BankerState structure.
+ * @param row The row to be overwritten.
+ * @param resource Pointer to the AllocatorResource of the process.
+ */
+void loadBankerStateRow(BankerState *state, int row, AllocatorResource *resource) {
+    assert(row >= 0 && row < state->rows);
+    int32_t *maxRow = bankerStateRow(state, maxMatrix, row);
+    int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+    int32_t *needRow = bankerStateRow(state, needMatrix, row);
+    memset(maxRow, 0, state->columns * sizeof(int32_t));
+    memset(allocationRow, 0, state->columns * sizeof(int32_t));
+    memset(needRow, 0, state->columns * sizeof(int32_t));
+
+    for (int i = 0; i < resource->maxResource->member; ++i) {
+        int type = (int) resource->maxResource->array[i]->type;
+        assert(type < state->columns);
+        maxRow[type] = resource->maxResource->array[i]->number;
+        allocationRow[type] = resource->assignedResource->array[i]->number;
+        needRow[type] = resource->needResource->array[i]->number;
+    }
+    touchBankerState(state);
+}
+
+/**
+ * @brief Appends a row for a process to the matrices.
+ *
+ * @param state Pointer to the BankerState structure.
+ * @param resource Pointer to the AllocatorResource of the process.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return The index of the new row.
+ */
+int pushBankerStateRow(BankerState *state, AllocatorResource *resource, Allocator *allocator) {
+    if (state->rows >= state->capacity) {
+        upCapacityBankerState(state, allocator);
+    }
+    int row = state->rows++;
+    loadBankerStateRow(state, row, resource);
+    return row;
+}
+
+/**
+ * @brief Removes a row from the matrices by moving the last row into its place, O(m).
+ *
+ * The BankProConBlock array of the Banker moves its last entry the same way, so rows and processes stay paired.
+ *
+ * @param state Pointer to the BankerState structure.
+ * @param row The row to be removed.
+ */
+void removeBankerStateRow(BankerState *state, int row) {
+    assert(row >= 0 && row < state->rows);
+    int last = state->rows - 1;
+    if (row != last) {
+        size_t rowSize = state->columns * sizeof(int32_t);
+        memcpy(bankerStateRow(state, maxMatrix, row), bankerStateRow(state, maxMatrix, last), rowSize);
+        memcpy(bankerStateRow(state, allocationMatrix, row), bankerStateRow(state, allocationMatrix, last), rowSize);
+        memcpy(bankerStateRow(state, needMatrix, row), bankerStateRow(state, needMatrix, last), rowSize);
+    }
+    state->rows -= 1;
+    touchBankerState(state);
+}
+
+/**
+ * @brief Starts a trial allocation on a BankerState.
+ *
+ * The Available vector is saved, O(m); rows must be passed to logBankerStateRow before they are changed,
+ * so nothing else of the state is copied. The first trial creates the saved vector and the undo log.
+ *
+ * @param state Pointer to the BankerState structure.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void beginBankerStateTrial(BankerState *state, Allocator *allocator) {
+    if (state->trial == NULL) {
+        state->trial = allocator->allocate(allocator, sizeof(BankerStateTrial) + state->columns * sizeof(int32_t));
+        assert(state->trial != NULL);
+        state->trial->undoLog = NULL;
+        state->trial->undoSize = 0;
+        state->trial->undoCapacity = 0;
+        state->trial->active = false;
+    }
+    BankerStateTrial *trial = state->trial;
+    assert(!trial->active);
+    memcpy(trial->available, state->available, state->columns * sizeof(int32_t));
+    trial->undoSize = 0;
+    trial->active = true;
+}
+
+/**
+ * @brief Saves the Allocation and Need of a row in the undo log of the trial, before the trial changes it, O(m).
+ *
+ * @param state Pointer to the BankerState structure, in a trial.
+ * @param row The row about to be changed.
+ * @param allocator Pointer to the Allocator structure used when the undo log has to grow.
+ */
+void logBankerStateRow(BankerState *state, int row, Allocator *allocator) {
+    BankerStateTrial *trial = state->trial;
+    assert(trial != NULL && trial->active && row >= 0 && row < state->rows);
+    if (trial->undoSize >= trial->undoCapacity) {
+        int capacity = trial->undoCapacity == 0 ? BANKER_STATE_INIT_ROWS : 2 * trial->undoCapacity;
+        trial->undoLog = allocator->reallocate(allocator, trial->undoLog,
+                                               bankerStateUndoSize(state, trial->undoCapacity),
+                                               bankerStateUndoSize(state, capacity));
+        assert(trial->undoLog != NULL);
+        trial->undoCapacity = capacity;
+    }
+    int32_t *entry = trial->undoLog + (size_t) trial->undoSize++ * (1 + 2 * state->columns);
+    entry[0] = row;
+    memcpy(entry + 1, bankerStateRow(state, allocationMatrix, row), state->columns * sizeof(int32_t));
+    memcpy(entry + 1 + state->columns, bankerStateRow(state, needMatrix, row), state->columns * sizeof(int32_t));
+}
+
+/**
+ * @brief Keeps the changes of a trial allocation.
+ *
+ * @param state Pointer to the BankerState structure, in a trial.
+ */
+void commitBankerStateTrial(BankerState *state) {
+    assert(state->trial != NULL && state->trial->active);
+    state->trial->undoSize = 0;
+    state->trial->active = false;
+    touchBankerState(state);
+}
+
+/**
+ * @brief Undoes a trial allocation: the logged rows are restored in reverse order and the saved Available vector is copied back.
+ *
+ * @param state Pointer to the BankerState structure, in a trial.
+ */
+void rollbackBankerStateTrial(BankerState *state) {
+    BankerStateTrial *trial = state->trial;
+    assert(trial != NULL && trial->active);
+    for (int i = trial->undoSize - 1; i >= 0; --i) {
+        const int32_t *entry = trial->undoLog + (size_t) i * (1 + 2 * state->columns);
+        memcpy(bankerStateRow(state, allocationMatrix, entry[0]), entry + 1, state->columns * sizeof(int32_t));
+        memcpy(bankerStateRow(state, needMatrix, entry[0]), entry + 1 + state->columns, state->columns * sizeof(int32_t));
+    }
+    memcpy(state->available, trial->available, state->columns * sizeof(int32_t));
+    trial->undoSize = 0;
+    trial->active = false;
+}
+
+/**
+ * @brief Initializes an empty BankerWorkspace for a given number of resource types.
+ *
+ * @param columns The number of resource types, the length of the Work vector.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created BankerWorkspace structure.
+ */
+BankerWorkspace *initBankerWorkspace(int columns, Allocator *allocator) {
+    BankerWorkspace *workspace = allocator->allocate(allocator, sizeof(BankerWorkspace));
+    assert(workspace != NULL);
+    workspace->work = allocator->allocate(allocator, columns * sizeof(int32_t));
+    assert(workspace->work != NULL);
+    workspace->finish = NULL;
+    workspace->runnable = NULL;
+    workspace->sequence = NULL;
+    workspace->sortedNeed = NULL;
+    workspace->satisfied = NULL;
+    workspace->witness = NULL;
+    workspace->witnessPosition = NULL;
+    workspace->witnessSize = 0;
+    workspace->witnessDead = 0;
+    workspace->witnessHits = 0;
+    workspace->witnessMisses = 0;
+    workspace->needTotal = allocator->allocate(allocator, columns * sizeof(int64_t));
+    workspace->needMin = allocator->allocate(allocator, columns * sizeof(int32_t));
+    assert(workspace->needTotal != NULL && workspace->needMin != NULL);
+    workspace->boundsVersion = 0;
+    workspace->boundsValid = false;
+    workspace->boundsSafe = 0;
+    workspace->boundsUnsafe = 0;
+    workspace->boundsUndecided = 0;
+    workspace->cache = NULL;
+    workspace->columns = columns;
+    workspace->capacity = 0;
+    workspace->sortedCapacity = 0;
+    return workspace;
+}
+
+/**
+ * @brief Destroys a BankerWorkspace and its buffers.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyBankerWorkspace(BankerWorkspace *workspace, Allocator *allocator) {
+    if (workspace != NULL) {
+        allocator->deallocate(allocator, workspace->work, workspace->columns * sizeof(int32_t));
+        allocator->deallocate(allocator, workspace->needTotal, workspace->columns * sizeof(int64_t));
+        allocator->deallocate(allocator, workspace->needMin, workspace->columns * sizeof(int32_t));
+        allocator->deallocate(allocator, workspace->finish, bankerWorkspaceWords(workspace->capacity) * sizeof(uint64_t));
+        allocator->deallocate(allocator, workspace->runnable, bankerWorkspaceWords(workspace->capacity) * sizeof(uint64_t));
+        allocator->deallocate(allocator, workspace->sequence, workspace->capacity * sizeof(int));
+        allocator->deallocate(allocator, workspace->witness, workspace->capacity * sizeof(int));
+        allocator->deallocate(allocator, workspace->witnessPosition, workspace->capacity * sizeof(int));
+        allocator->deallocate(allocator, workspace->sortedNeed,
+                              (size_t) workspace->sortedCapacity * workspace->columns * sizeof(uint64_t));
+        allocator->deallocate(allocator, workspace->satisfied, workspace->sortedCapacity * sizeof(int));
+        allocator->deallocate(allocator, workspace, sizeof(BankerWorkspace));
+    }
+}
+
+/**
+ * @brief Makes sure a BankerWorkspace can hold a safety check over a number of rows.
+ *
+ * The capacity doubles, so a growing Banker reallocates O(log n) times and a Banker of stable size never again.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param rows The number of rows the next safety check will cover.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void reserveBankerWorkspace(BankerWorkspace *workspace, int rows, Allocator *allocator) {
+    if (rows <= workspace->capacity) {
+        return;
+    }
+    int capacity = workspace->capacity == 0 ? BANKER_STATE_INIT_ROWS : workspace->capacity;
+    while (capacity < rows) {
+        capacity *= 2;
+    }
+    workspace->finish = allocator->reallocate(
+            allocator, workspace->finish,
+            bankerWorkspaceWords(workspace->capacity) * sizeof(uint64_t),
+            bankerWorkspaceWords(capacity) * sizeof(uint64_t));
+    workspace->runnable = allocator->reallocate(
+            allocator, workspace->runnable,
+            bankerWorkspaceWords(workspace->capacity) * sizeof(uint64_t),
+            bankerWorkspaceWords(capacity) * sizeof(uint64_t));
+    workspace->sequence = allocator->reallocate(
+            allocator, workspace->sequence,
+            workspace->capacity * sizeof(int),
+            capacity * sizeof(int));
+    workspace->witness = allocator->reallocate(
+            allocator, workspace->witness,
+            workspace->capacity * sizeof(int),
+            capacity * sizeof(int));
+    workspace->witnessPosition = allocator->reallocate(
+            allocator, workspace->witnessPosition,
+            workspace->capacity * sizeof(int),
+            capacity * sizeof(int));
+    assert(workspace->finish != NULL && workspace->runnable != NULL && workspace->sequence != NULL);
+    assert(workspace->witness != NULL && workspace->witnessPosition != NULL);
+    workspace->capacity = capacity;
+}
+
+/**
+ * @brief Prepares a BankerWorkspace for a safety check: Work = Available, every row unfinished.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure, reserved for at least the rows of the BankerState.
+ * @param state Pointer to the BankerState to be checked.
+ */
+void resetBankerWorkspace(BankerWorkspace *workspace, BankerState *state) {
+    assert(workspace->capacity >= state->rows && workspace->columns == state->columns);
+    memcpy(workspace->work, state->available, state->columns * sizeof(int32_t));
+    memset(workspace->finish, 0, bankerWorkspaceWords(state->rows) * sizeof(uint64_t));
+}
+
+/**
+ * @brief Makes sure a BankerWorkspace holds the buffers of the sorted safety check over a number of rows.
+ *
+ * These buffers cost a key per matrix cell, so they are only created by the first sorted check and then grow like the other buffers.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param rows The number of rows the next sorted safety check will cover.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void reserveSortedBankerWorkspace(BankerWorkspace *workspace, int rows, Allocator *allocator) {
+    if (rows <= workspace->sortedCapacity) {
+        return;
+    }
+    int capacity = workspace->sortedCapacity == 0 ? BANKER_STATE_INIT_ROWS : workspace->sortedCapacity;
+    while (capacity < rows) {
+        capacity *= 2;
+    }
+    workspace->sortedNeed = allocator->reallocate(
+            allocator, workspace->sortedNeed,
+            (size_t) workspace->sortedCapacity * workspace->columns * sizeof(uint64_t),
+            (size_t) capacity * workspace->columns * sizeof(uint64_t));
+    workspace->satisfied = allocator->reallocate(
+            allocator, workspace->satisfied,
+            workspace->sortedCapacity * sizeof(int),
+            capacity * sizeof(int));
+    assert(workspace->sortedNeed != NULL && workspace->satisfied != NULL);
+    workspace->sortedCapacity = capacity;
+}
+
+/**
+ * @brief Drops the removed rows from the safe sequence witness and renumbers the positions, O(n).
+ */
+static void compactBankerWitness(BankerWorkspace *workspace) {
+    int size = 0;
+    for (int i = 0; i < workspace->witnessSize; ++i) {
+        int row = workspace->witness[i];
+        if (row >= 0) {
+            workspace->witnessPosition[row] = size;
+            workspace->witness[size++] = row;
+        }
+    }
+    workspace->witnessSize = size;
+    workspace->witnessDead = 0;
+}
+
+/**
+ * @brief Appends a new row to the end of the safe sequence witness, where Work is the largest.
+ *
+ * When removed rows fill the witness up to its capacity it is compacted first, which amortizes to O(1) per removal.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure, reserved for at least the new row.
+ * @param row The row of the process pushed to the Banker.
+ */
+void pushBankerWitnessRow(BankerWorkspace *workspace, int row) {
+    if (workspace->witnessSize >= workspace->capacity) {
+        compactBankerWitness(workspace);
+    }
+    assert(workspace->witnessSize < workspace->capacity);
+    workspace->witnessPosition[row] = workspace->witnessSize;
+    workspace->witness[workspace->witnessSize++] = row;
+}
+
+/**
+ * @brief Drops a removed row from the safe sequence witness, O(1).
+ *
+ * The entry of the row is marked -1 and skipped from then on; the last row, which removeBankerStateRow moves into the place of the removed one,
+ * takes the new row index at its old position. The other rows keep their order in the witness.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param row The row removed from the BankerState.
+ * @param last The last row of the BankerState before the removal.
+ */
+void removeBankerWitnessRow(BankerWorkspace *workspace, int row, int last) {
+    int position = workspace->witnessPosition[row];
+    assert(position >= 0 && position < workspace->witnessSize && workspace->witness[position] == row);
+    workspace->witness[position] = -1;
+    workspace->witnessDead += 1;
+    if (last != row) {
+        int lastPosition = workspace->witnessPosition[last];
+        workspace->witness[lastPosition] = row;
+        workspace->witnessPosition[row] = lastPosition;
+    }
+}
+
+/**
+ * @brief Replays the safe sequence witness on the current state, O(n · m).
+ *
+ * Starting from Work = Available, every row of the witness in turn must have Need <= Work and then returns its Allocation to Work.
+ * When every row passes, the witness is still a safe sequence and the state is safe. When a row fails, the witness says nothing:
+ * another order may still be safe, so the caller falls back to the full search.
+ * Rows removed since the last replay are dropped from the witness first.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param state Pointer to the BankerState to be checked.
+ * @return Boolean value indicating whether the witness is a safe sequence of the state.
+ */
+_Bool replayBankerWitness(BankerWorkspace *workspace, BankerState *state) {
+    if (workspace->witnessDead > 0) {
+        compactBankerWitness(workspace);
+    }
+    if (workspace->witnessSize != state->rows) {
+        return false;
+    }
+    int32_t *work = workspace->work;
+    memcpy(work, state->available, state->columns * sizeof(int32_t));
+    for (int i = 0; i < workspace->witnessSize; ++i) {
+        int row = workspace->witness[i];
+        const int32_t *needRow = bankerStateRow(state, needMatrix, row);
+        const int32_t *allocationRow = bankerStateRow(state, allocationMatrix, row);
+        int over = 0;
+        for (int j = 0; j < state->columns; ++j) {
+            over |= needRow[j] > work[j];
+        }
+        if (over != 0) {
+            return false;
+        }
+        for (int j = 0; j < state->columns; ++j) {
+            work[j] += allocationRow[j];
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces the safe sequence witness with a safe sequence found by a full search.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param sequence Array of the rows of the safe sequence.
+ * @param rows The number of rows of the safe sequence.
+ */
+void saveBankerWitness(BankerWorkspace *workspace, const int *sequence, int rows) {
+    assert(rows <= workspace->capacity);
+    memmove(workspace->witness, sequence, rows * sizeof(int));
+    for (int i = 0; i < rows; ++i) {
+        workspace->witnessPosition[sequence[i]] = i;
+    }
+    workspace->witnessSize = rows;
+    workspace->witnessDead = 0;
+}
+
+/**
+ * @brief Recomputes the aggregate bounds of a BankerWorkspace from the Need matrix, unless they already describe this version of the state.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure.
+ * @param state Pointer to the BankerState the bounds describe.
+ */
+void loadBankerBounds(BankerWorkspace *workspace, BankerState *state) {
+    if (isBankerBoundsFresh(workspace, state)) {
+        return;
+    }
+    for (int j = 0; j < state->columns; ++j) {
+        workspace->needTotal[j] = 0;
+        workspace->needMin[j] = INT32_MAX;
+    }
+    for (int i = 0; i < state->rows; ++i) {
+        const int32_t *needRow = bankerStateRow(state, needMatrix, i);
+        for (int j = 0; j < state->columns; ++j) {
+            workspace->needTotal[j] += needRow[j];
+            workspace->needMin[j] = needRow[j] < workspace->needMin[j] ? needRow[j] : workspace->needMin[j];
+        }
+    }
+    workspace->boundsVersion = state->version;
+    workspace->boundsValid = true;
+}
+
+/**
+ * @brief Updates the aggregate bounds after a cell of the Need matrix changed, O(1).
+ *
+ * The minimum only ever drops here; when a cell grows it stays a lower bound until the next recomputation.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure, with fresh bounds.
+ * @param type The column of the cell.
+ * @param delta The change of the cell.
+ * @param need The new value of the cell.
+ */
+void adjustBankerBounds(BankerWorkspace *workspace, int type, int32_t delta, int32_t need) {
+    workspace->needTotal[type] += delta;
+    if (need < workspace->needMin[type]) {
+        workspace->needMin[type] = need;
+    }
+}
+
+/**
+ * @brief Decides the safety of a state from the aggregate bounds alone, O(m).
+ *
+ * If the Need of all processes together fits into Available, every order is a safe sequence.
+ * If in some column even the smallest Need exceeds Available, no process can finish first and the state is unsafe.
+ * The counters of the BankerWorkspace record which way every call went.
+ *
+ * @param workspace Pointer to the BankerWorkspace structure; stale bounds are recomputed first.
+ * @param state Pointer to the BankerState to be decided.
+ * @return 1 if the state is safe, -1 if it is unsafe, 0 if the bounds cannot tell and a safety check is needed.
+ */
+int decideBankerBounds(BankerWorkspace *workspace, BankerState *state) {
+    loadBankerBounds(workspace, state);
+    int fits = 1;
+    int blocked = 0;
+    for (int j = 0; j < state->columns; ++j) {
+        fits &= workspace->needTotal[j] <= state->available[j];
+        blocked |= workspace->needMin[j] > state->available[j];
+    }
+    if (fits) {
+        workspace->boundsSafe += 1;
+        return 1;
+    }
+    if (blocked && state->rows > 0) {
+        workspace->boundsUnsafe += 1;
+        return -1;
+    }
+    workspace->boundsUndecided += 1;
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ User: Redskaber
+ Date: 2024/1/26
+ Time: 15:12
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_BANKER_STATE_H
+#define OPERATORSYSTEM_BANKER_STATE_H
+/*
+ * 银行家的稠密状态
+        AllocatorResource 中每个矩阵单元都是单独 malloc 的 BaseAllocate{type, number}, 按下标找类型要做指针追逐和哈希。
+        BankerState 把 Max / Allocation / Need 保存为按行优先的连续 int32 矩阵, 列下标就是资源类型的序号(ResourceType),
+        再加一个 Available 向量; 第 i 行对应 Banker 的第 i 个 BankProConBlock。
+
+            maxMatrix[row * columns + type]
+            allocationMatrix[row * columns + type]
+            needMatrix[row * columns + type]
+            available[type]
+
+        安全性检查和资源请求只顺序扫描这些数组。BaseAllocateArr 仍然是对外的表示(显示、初始化),
+        Banker 在初始化、加入、移除进程以及分配/释放资源之后同步对应的行和 Available 向量, 每次 O(m)。
+        矩阵在第一个进程加入时才分配。
+        每次修改 version 加一(直接改矩阵的代码用 touchBankerState), 持有安全序列的一方据此判断是否需要重新检查。
+        移除进程时最后一行搬到被移除的位置(swap-remove), O(m), 行号只在这时改变。
+        列数由 initBanker 决定: 取内置类型数(RESOURCE_TYPE_BUILTIN)与 Available 中最大类型 + 1 的较大者, 再补零到 8 的倍数(bankerStateColumns),
+        而不是创建时已注册的全部类型数; 进程只能使用这些列内的类型。只内置类型时一行正好是一个 256 位向量, 两行一条缓存行;
+        补出的列 Need 与 Available 都是 0, 不影响比较。Available 接在 BankerState 之后一起分配(柔性数组成员)。
+
+ * 安全性检查的工作区
+        BankerWorkspace 保存安全性检查用到的 Work 向量、Finish 位图和安全序列缓冲区, 在第一个进程加入时创建,
+        只在加入进程使行数超过容量时按倍数扩容; 安全性检查本身不做任何堆分配, 也不在栈上放 O(n) 的变长数组。
+
+ * 试探分配
+        试探分配只改动请求进程的一行和 Available 向量, 不复制整个状态:
+            beginBankerStateTrial     保存 Available, O(m);
+            logBankerStateRow         某行被试探改动之前, 把它的 Allocation / Need 记入撤销日志, O(m);
+            commitBankerStateTrial    丢弃撤销日志;
+            rollbackBankerStateTrial  按日志倒序恢复改动过的行, 恢复 Available, O(改动行数 · m)。
+        Available 只有一行, 保存和恢复都是一次定长复制; BankerState 本身不变大,
+        保存的 Available 和撤销日志(BankerStateTrial)在第一次试探时才创建, 撤销日志只在一次试探改动的行数超过以往时扩容。
+
+ * 安全序列见证
+        工作区还保存上一次找到的安全序列(witness)。分配或释放一次通常只改动一两行, 旧的安全序列往往仍然成立:
+        按见证的顺序重放一遍 Work(Need <= Work 则 Work += Allocation), O(n · m), 全部通过即安全。
+        见证失效时才回退到完整的搜索, 并用新找到的安全序列替换见证。
+        加入进程时新行接在见证末尾(此时 Work 最大), 移除进程时把该行在见证中的位置标记为 -1, 其余行保持原有的先后顺序;
+        标记在下一次重放(或见证写满)时统一压缩, 所以移除是 O(1)。
+
+ * 聚合界
+        工作区还维护每列 Need 之和 needTotal 与 Need 最小值 needMin, 请求在完整的安全性检查之前先用它们 O(m) 判断:
+            needTotal <= Available: 所有进程同时拿到全部需求也够, 任意顺序都能完成, 一定安全;
+            某列 needMin > Available: 没有进程能第一个完成, 一定不安全;
+            否则回退到完整的安全性检查。
+        请求与释放只按改动的列增量更新; Need 变大时 needMin 只作为下界保留, 判断仍然成立, 下次重算时再收紧。
+        聚合界记下它对应的 version, 别处改动 BankerState(加入、移除、同步进程)之后, 下次判断前按整个矩阵重算一次, O(n · m)。
+ */
+
+#include <stdint.h>
+#include "../base/resource_allocate.h"
+
+#define BANKER_STATE_INIT_ROWS 8
+#define bankerStateColumns(types) (((types) + 7) / 8 * 8)
+
+typedef struct BankerState {
+    int32_t *maxMatrix;
+    int32_t *allocationMatrix;
+    int32_t *needMatrix;
+    struct BankerStateTrial *trial;
+    int columns;                // 行宽, 8 的倍数
+    int rows;
+    int capacity;
+    unsigned int version;       // 每次修改加一, 用来发现上次检查之后状态是否变过
+    int32_t available[];        // columns
+} BankerState;
+
+typedef struct BankerStateTrial {
+    int32_t *undoLog;           // 试探分配改动前的行, 每项 (row, Allocation 行, Need 行)
+    int undoSize;
+    int undoCapacity;
+    _Bool active;
+    int32_t available[];        // 试探开始前的 Available, columns
+} BankerStateTrial;
+
+typedef struct BankerWorkspace {
+    int32_t *work;              // columns
+    uint64_t *finish;           // 每行一位
+    uint64_t *runnable;         // 每行一位, 本轮 Need <= Work 且未完成
+    int *sequence;              // 安全序列(行下标)
+    uint64_t *sortedNeed;       // 按列排序的 (need, row), 排序安全性检查使用
+    int *satisfied;             // 每行已满足的列数, 排序安全性检查使用
+    int *witness;               // 上一次的安全序列(行下标, -1 表示已移除的行), 与 sequence 同容量
+    int *witnessPosition;       // 每行在 witness 中的位置
+    int witnessSize;
+    int witnessDead;            // witness 中 -1 的个数
+    long witnessHits;           // 见证仍然成立的安全性检查次数
+    long witnessMisses;         // 回退到完整搜索的次数
+    int64_t *needTotal;         // 每列 Need 之和, columns
+    int32_t *needMin;           // 每列 Need 最小值的下界, columns
+    unsigned int boundsVersion; // 聚合界对应的 BankerState version
+    _Bool boundsValid;
+    long boundsSafe;            // 聚合界判定一定安全的次数
+    long boundsUnsafe;          // 聚合界判定一定不安全的次数
+    long boundsUndecided;       // 回退到安全性检查的次数
+    struct BankerSafetyCache *cache;    // 安全性检查结果缓存, enableBankerSafetyCache 之前为 NULL
+    int columns;
+    int capacity;
+    int sortedCapacity;
+} BankerWorkspace;
+
+#define bankerWorkspaceWords(capacity) (((capacity) + 63) / 64)
+#define isBankerWorkspaceFinished(workspace, row) ((workspace)->finish[(row) >> 6] >> ((row) & 63) & 1)
+#define finishBankerWorkspaceRow(workspace, row) ((workspace)->finish[(row) >> 6] |= (uint64_t) 1 << ((row) & 63))
+
+#define isBankerBoundsFresh(workspace, state) \
+    ((workspace) != NULL && (workspace)->boundsValid && (workspace)->boundsVersion == (state)->version)
+
+#define bankerStateRow(state, matrix, row) ((state)->matrix + (size_t) (row) * (state)->columns)
+#define touchBankerState(state) ((state)->version += 1)
+
+
+extern BankerState *initBankerState(int columns, Allocator *allocator);
+
+extern void destroyBankerState(BankerState *state, Allocator *allocator);
+
+extern void loadBankerStateAvailable(BankerState *state, BaseAllocateArr *availableResource);
+
+extern int pushBankerStateRow(BankerState *state, AllocatorResource *resource, Allocator *allocator);
+
+extern void loadBankerStateRow(BankerState *state, int row, AllocatorResource *resource);
+
+extern void removeBankerStateRow(BankerState *state, int row);
+
+extern void beginBankerStateTrial(BankerState *state, Allocator *allocator);
+
+extern void logBankerStateRow(BankerState *state, int row, Allocator *allocator);
+
+extern void commitBankerStateTrial(BankerState *state);
+
+extern void rollbackBankerStateTrial(BankerState *state);
+
+extern BankerWorkspace *initBankerWorkspace(int columns, Allocator *allocator);
+
+extern void destroyBankerWorkspace(BankerWorkspace *workspace, Allocator *allocator);
+
+extern void reserveBankerWorkspace(BankerWorkspace *workspace, int rows, Allocator *allocator);
+
+extern void resetBankerWorkspace(BankerWorkspace *workspace, BankerState *state);
+
+extern void reserveSortedBankerWorkspace(BankerWorkspace *workspace, int rows, Allocator *allocator);
+
+extern void pushBankerWitnessRow(BankerWorkspace *workspace, int row);
+
+extern void removeBankerWitnessRow(BankerWorkspace *workspace, int row, int last);
+
+extern _Bool replayBankerWitness(BankerWorkspace *workspace, BankerState *state);
+
+extern void saveBankerWitness(BankerWorkspace *workspace, const int *sequence, int rows);
+
+extern void loadBankerBounds(BankerWorkspace *workspace, BankerState *state);
+
+extern void adjustBankerBounds(BankerWorkspace *workspace, int type, int32_t delta, int32_t need);
+
+extern int decideBankerBounds(BankerWorkspace *workspace, BankerState *state);
+
+#endif //OPERATORSYSTEM_BANKER_STATE_H
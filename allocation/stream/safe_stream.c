@@ -0,0 +1,148 @@
+/*
+ User: Redskaber
+ Date: 2024/2/1
+ Time: 10:24
+*/
+#include "safe_stream.h"
+
+
+/**
+ * @brief Counts the BankProConBlocks from the front of the sequence whose Need rows fit into Available together, at most workers.
+ *
+ * The first BankProConBlock of a safe sequence always fits, so at least one is returned.
+ */
+static int independentPrefixWidth(BankerState *state, BankProConBlock **sequence, int count, int workers) {
+    int32_t work[state->columns];
+    memcpy(work, state->available, state->columns * sizeof(int32_t));
+    int width = 0;
+    while (width < count && (width == 0 || width < workers)) {
+        const int32_t *needRow = bankerStateRow(state, needMatrix, sequence[width]->row);
+        int over = 0;
+        for (int j = 0; j < state->columns; ++j) {
+            over |= needRow[j] > work[j];
+        }
+        if (over != 0) {
+            break;
+        }
+        for (int j = 0; j < state->columns; ++j) {
+            work[j] -= needRow[j];
+        }
+        width += 1;
+    }
+    assert(width > 0);
+    return width;
+}
+
+/**
+ * @brief Runs the callbacks of admitted BankProConBlocks, one thread each when there are several.
+ */
+static void runBankProConBlockCallbacks(int width, BankProConBlock *prefix[width]) {
+    pthread_t threads[width];
+    _Bool started[width];
+    for (int i = 0; i < width; ++i) {
+        ProConBlock *proConBlock = prefix[i]->base;
+        proConBlock->p_state = running;
+        started[i] = false;
+        if (proConBlock->callback == NULL) {
+            continue;
+        }
+        if (width == 1) {
+            proConBlock->callback(proConBlock);
+        } else {
+            started[i] = pthread_create(&threads[i], NULL, proConBlock->callback, proConBlock) == 0;
+            if (started[i] == false) {
+                proConBlock->callback(proConBlock);
+            }
+        }
+    }
+    for (int i = 0; i < width; ++i) {
+        if (started[i] == true) {
+            pthread_join(threads[i], NULL);
+        }
+        ProConBlock *proConBlock = prefix[i]->base;
+        proConBlock->p_execute_time = proConBlock->p_total_time;
+        proConBlock->p_state = suspended_ready;
+    }
+    countScheduleStats(counter_dispatches, width);
+}
+
+/**
+ * @brief Executes every BankProConBlock of the Banker along a safe sequence, checking safety again only when the Banker was changed from outside.
+ *
+ * A safe sequence stays safe for the remaining processes while its front finishes and releases, so one safety check covers the whole run.
+ * Each round takes the independent prefix of the sequence, the BankProConBlocks whose Need rows fit into Available together
+ * (at most workers of them), admits them with their whole need, runs their callbacks, then releases their resources and removes them
+ * from the Banker. When the version of the BankerState moved while the callbacks ran, for example because a callback requested
+ * resources for another process, the next round starts with a new safety check.
+ *
+ * With more than one worker the callbacks run on their own threads and must not touch the Banker.
+ *
+ * @param banker Pointer to the Banker structure.
+ * @param workers The largest number of BankProConBlocks run at once; 1 runs them one by one on the calling thread.
+ * @param systemResource Pointer to the SystemResource structure used for memory management.
+ * @param stats Pointer to the SafeStreamStats to be filled, may be NULL.
+ * @return Boolean value indicating whether every BankProConBlock was executed; if false, the remaining ones are unsafe and stay in the Banker.
+ */
+_Bool executeSafeSequenceStream(
+        Banker *banker,
+        int workers,
+        SystemResource *systemResource,
+        SafeStreamStats *stats
+) {
+    SafeStreamStats local = {0, 0, 0};
+    BankerState *state = banker->state;
+    BankProConBlock **sequence = NULL;
+    int capacity = 0;
+    int count = 0;
+    int next = 0;
+    _Bool stale = true;
+    _Bool safe = true;
+
+    while (banker->size > 0) {
+        if (stale == true) {
+            if (banker->size > capacity) {
+                int grown = banker->size;
+                sequence = systemResource->memory->reallocate(
+                        systemResource->memory, sequence,
+                        capacity * sizeof(BankProConBlock *), grown * sizeof(BankProConBlock *)
+                );
+                assert(sequence != NULL);
+                capacity = grown;
+            }
+            local.verifications += 1;
+            if (checkResourceSecurity(banker, systemResource, (BankProConBlock *(*)[banker->size]) sequence) == false) {
+                safe = false;
+                break;
+            }
+            count = banker->size;
+            next = 0;
+            stale = false;
+        }
+
+        int width = independentPrefixWidth(state, sequence + next, count - next, workers);
+        BankProConBlock **prefix = sequence + next;
+        for (int i = 0; i < width; ++i) {
+            _Bool admitted = admitBankProConBlock(banker, prefix[i]);
+            assert(admitted == true);
+        }
+        unsigned int version = state->version;
+        runBankProConBlockCallbacks(width, prefix);
+        stale = state->version != version;
+
+        for (int i = 0; i < width; ++i) {
+            releaseBankProConBlock(banker, prefix[i]);
+            removeBankProConBlockFromBanker(banker, prefix[i], systemResource);
+        }
+        next += width;
+        local.executed += width;
+        local.rounds += 1;
+    }
+
+    if (sequence != NULL) {
+        systemResource->memory->deallocate(systemResource->memory, sequence, capacity * sizeof(BankProConBlock *));
+    }
+    if (stats != NULL) {
+        *stats = local;
+    }
+    return safe;
+}
@@ -0,0 +1,41 @@
+/*
+ User: Redskaber
+ Date: 2024/2/1
+ Time: 10:24
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SAFE_STREAM_H
+#define OPERATORSYSTEM_SAFE_STREAM_H
+/*
+ * 按安全序列流式执行
+        安全序列 P1, P2, ..., Pn 中 P1 运行结束并归还资源后, P2, ..., Pn 仍是剩余进程的安全序列:
+        每个 Pk 能用的 Work 只多不少。所以执行完一个进程不需要重新做安全性检查, 沿着同一个序列往下走即可。
+        只有别人改了 Banker(进程回调里 requestResources、加入新进程等), 原序列才可能失效:
+            BankerState 每次修改 version 加一, 回调前后 version 不同就在下一轮重新检查, 得到新的安全序列。
+        一次检查之后连续执行 k 个进程只花 O(k · m), 而不是每个进程一次检查。
+
+ * 并行执行独立前缀
+        从序列当前位置起, 若干个相邻进程的 Need 之和不超过 Available, 它们可以同时准入(各自拿到最大需求),
+        互不等待, 一起运行、一起归还, 之后剩下的序列仍然安全。每轮最多 workers 个进程, 回调各占一个线程;
+        第一个进程总是可以准入, workers <= 1 时就是逐个执行。
+        并行执行时回调在其它线程上运行, 不能访问 Banker(Banker 和 Allocator 都不加锁)。
+ */
+
+#include <pthread.h>
+#include "../admission/banker_admission.h"
+
+typedef struct SafeStreamStats {
+    int executed;           // 执行完并移出 Banker 的进程数
+    int rounds;             // 轮数, 每轮并行执行一段独立前缀
+    int verifications;      // 安全性检查次数
+} SafeStreamStats;
+
+
+extern _Bool executeSafeSequenceStream(
+        Banker *banker,
+        int workers,
+        SystemResource *systemResource,
+        SafeStreamStats *stats
+);
+
+#endif //OPERATORSYSTEM_SAFE_STREAM_H
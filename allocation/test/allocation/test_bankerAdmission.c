@@ -0,0 +1,194 @@
+/*
+ User: Redskaber
+ Date: 2024/1/25
+ Time: 14:06
+*/
+#include "../header/test_bankerAdmission.h"
+
+
+static int executeOrder[8];
+static int executeCount = 0;
+static Banker *admissionBanker = NULL;
+
+static void *admissionCallBack(void *args) {
+    executeOrder[executeCount++] = ((ProConBlock *) args)->p_id;
+    return args;
+}
+
+/**
+ * @brief Records the slice like admissionCallBack and checks that the admitted processes never hold more than the system has.
+ */
+static void *slicedAdmissionCallBack(void *args) {
+    for (int i = 0; i < admissionBanker->availableResource->member; ++i) {
+        assert(admissionBanker->availableResource->array[i]->number >= 0);
+    }
+    return admissionCallBack(args);
+}
+
+/**
+ * @brief Creates three processes of 10 ticks, two slices each, whose cpu claims (3, 3, 1) exceed the 4 cpu of the Banker together.
+ */
+static Banker *initSlicedAdmission(ProConBlock *pcbArr[3], SystemResource *systemResource) {
+    ResourceType availableResourceArr[][2] = {
+            {cpu, 4}
+    };
+    Banker *banker = initBanker(availableResourceArr, 1, systemResource);
+
+    ResourceType bankerProConBlockGroup[3][1][3] = {
+            {{cpu, 3, 0}},
+            {{cpu, 3, 0}},
+            {{cpu, 1, 0}}
+    };
+    for (int i = 0; i < 3; ++i) {
+        pcbArr[i] = initProConBlock(i + 1, "admission", 10.0, normal, slicedAdmissionCallBack, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 3, 1, bankerProConBlockGroup, systemResource);
+    admissionBanker = banker;
+    executeCount = 0;
+    return banker;
+}
+
+void test_bankerAdmissionScheduling_whenHeadNeedsReleasedResources_defersAndRetries() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    8},
+            {memory, 6}
+    };
+    Banker *banker = initBanker(availableResourceArr, 2, systemResource);
+
+    // {type, max, assigned}: process 1 needs 6 cpu, only 5 are left until process 2 returns its cpu
+    ResourceType bankerProConBlockGroup[3][2][3] = {
+            {{cpu, 8, 2}, {memory, 4, 1}},
+            {{cpu, 3, 1}, {memory, 3, 1}},
+            {{cpu, 2, 0}, {memory, 2, 0}}
+    };
+    ProConBlock *pcbArr[3];
+    ProConBlockLink *proConBlockLink = initProConBlockLink(systemResource->memory);
+    for (int i = 0; i < 3; ++i) {
+        pcbArr[i] = initProConBlock(i + 1, "admission", 10.0, normal, admissionCallBack, systemResource->memory);
+        pushToLink(pcbArr[i], proConBlockLink);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 3, 2, bankerProConBlockGroup, systemResource);
+
+    executeCount = 0;
+    assert(bankerAdmissionScheduling(banker, proConBlockLink, firstComeFirstServe, NULL, systemResource) == true);
+    assert(executeCount == 3);
+    assert(executeOrder[0] == 2);
+    assert(executeOrder[1] == 1);
+    assert(executeOrder[2] == 3);
+    assert(banker->size == 0);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == NULL);
+    // every resource is back
+    assert(banker->availableResource->array[0]->number == 8);
+    assert(banker->availableResource->array[1]->number == 6);
+
+    destroyProConBlockLink(proConBlockLink, systemResource->memory);
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_bankerAdmissionScheduling_whenNeedNeverFits_requeuesProcess() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu, 4}
+    };
+    Banker *banker = initBanker(availableResourceArr, 1, systemResource);
+
+    ResourceType bankerProConBlockGroup[2][1][3] = {
+            {{cpu, 9, 0}},
+            {{cpu, 2, 1}}
+    };
+    ProConBlock *pcbArr[2];
+    ProConBlockLink *proConBlockLink = initProConBlockLink(systemResource->memory);
+    for (int i = 0; i < 2; ++i) {
+        pcbArr[i] = initProConBlock(i + 1, "admission", 10.0, normal, admissionCallBack, systemResource->memory);
+        pushToLink(pcbArr[i], proConBlockLink);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 2, 1, bankerProConBlockGroup, systemResource);
+
+    executeCount = 0;
+    assert(bankerAdmissionScheduling(banker, proConBlockLink, NULL, NULL, systemResource) == false);
+    assert(executeCount == 1);
+    assert(executeOrder[0] == 2);
+    // process 1 waits in the ready link again, still owned by the banker
+    assert(banker->size == 1);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == pcbArr[0]);
+    assert(findProConBlockFromLink(proConBlockLink, 1) == pcbArr[0]);
+    assert(pcbArr[0]->p_state == blocked);
+    assert(banker->availableResource->array[0]->number == 4);
+
+    detachProConBlockFromLink(proConBlockLink, pcbArr[0]);
+    destroyProConBlockLink(proConBlockLink, systemResource->memory);
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_bankerAdmissionScheduling_whenRoundRobin_admitsAtDispatch() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    ProConBlock *pcbArr[3];
+    Banker *banker = initSlicedAdmission(pcbArr, systemResource);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(systemResource->memory);
+    for (int i = 0; i < 3; ++i) {
+        pushToLink(pcbArr[i], proConBlockLink);
+    }
+
+    // 1 takes 3 cpu, 2 is refused and rotated, 3 takes the last cpu; 2 is admitted once 1 finishes
+    assert(bankerAdmissionScheduling(banker, proConBlockLink, NULL, roundRobinScheduling, systemResource) == true);
+    int order[] = {1, 3, 1, 2, 3, 2};
+    assert(executeCount == 6);
+    for (int i = 0; i < 6; ++i) {
+        assert(executeOrder[i] == order[i]);
+    }
+    assert(banker->size == 0);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == NULL);
+    assert(banker->availableResource->array[0]->number == 4);
+
+    destroyProConBlockLink(proConBlockLink, systemResource->memory);
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_attachScheduleBanker_whenAgingAndGroupFairDispatch_holdBackRefused() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    ProConBlock *pcbArr[3];
+    Banker *banker = initSlicedAdmission(pcbArr, systemResource);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(systemResource->memory);
+    for (int i = 0; i < 3; ++i) {
+        appendToLink(pcbArr[i], proConBlockLink);
+    }
+
+    attachScheduleBanker(banker);
+    priorityAgingScheduling(proConBlockLink);
+    attachScheduleBanker(NULL);
+    // 2 waits outside the run queue until 1 releases its cpu, so it finishes last
+    assert(executeCount == 6);
+    assert(proConBlockLink->lastProConBlock == pcbArr[1]);
+    assert(pcbArr[1]->p_execute_time == pcbArr[1]->p_total_time);
+    assert(banker->availableResource->array[0]->number == 4);
+
+    // the same processes again, dispatched by the group fair scheduler
+    ScheduleGroup *root = initScheduleGroup("root", 0, NULL, systemResource->memory);
+    for (int i = 0; i < 3; ++i) {
+        detachProConBlockFromLink(proConBlockLink, pcbArr[i]);
+        pcbArr[i]->p_execute_time = 0;
+        enqueueScheduleGroup(root, pcbArr[i], systemResource->memory);
+    }
+    executeCount = 0;
+    attachScheduleBanker(banker);
+    groupFairScheduling(root, proConBlockLink, systemResource->memory);
+    attachScheduleBanker(NULL);
+    // 2 leaves the tree until 1 and 3 finished, then it is alone and runs to completion in one slice
+    assert(executeCount == 5);
+    assert(executeOrder[4] == 2);
+    assert(root->member == 0);
+    assert(proConBlockLink->lastProConBlock == pcbArr[1]);
+    assert(banker->availableResource->array[0]->number == 4);
+
+    for (int i = 0; i < 3; ++i) {
+        detachProConBlockFromLink(proConBlockLink, pcbArr[i]);
+    }
+    destroyScheduleGroup(root, systemResource->memory);
+    destroyProConBlockLink(proConBlockLink, systemResource->memory);
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
@@ -0,0 +1,269 @@
+/*
+ User: Redskaber
+ Date: 2024/1/30
+ Time: 15:02
+*/
+#include "../header/test_bankerRequest.h"
+
+#define REQUEST_TEST_PROCESSES 50
+#define REQUEST_TEST_TYPES 3
+#define REQUEST_TEST_REQUESTS 200
+#define REQUEST_TEST_ROUNDS 20
+
+
+/**
+ * @brief The five processes of the textbook example, A = cpu, B = memory, C = swap; available (3, 3, 2).
+ */
+static Banker *initTextbookBanker(SystemResource *systemResource) {
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    10},
+            {memory, 5},
+            {swap,   7}
+    };
+    Banker *banker = initBanker(availableResourceArr, 3, systemResource);
+
+    // {type, max, assigned}
+    ResourceType bankerProConBlockGroup[5][3][3] = {
+            {{cpu, 7, 0}, {memory, 5, 1}, {swap, 3, 0}},
+            {{cpu, 3, 2}, {memory, 2, 0}, {swap, 2, 0}},
+            {{cpu, 9, 3}, {memory, 0, 0}, {swap, 2, 2}},
+            {{cpu, 2, 2}, {memory, 2, 1}, {swap, 2, 1}},
+            {{cpu, 4, 0}, {memory, 3, 0}, {swap, 3, 2}}
+    };
+    ProConBlock *pcbArr[5];
+    for (int i = 0; i < 5; ++i) {
+        pcbArr[i] = initProConBlock(i, "textbook", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 5, 3, bankerProConBlockGroup, systemResource);
+    return banker;
+}
+
+void test_requestResources_whenGrantUnsafe_rollsBackAndWaits() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    Banker *banker = initTextbookBanker(systemResource);
+    BankerState *state = banker->state;
+    assert(state->available[cpu] == 3 && state->available[memory] == 3 && state->available[swap] == 2);
+
+    // P1 asks for (1, 0, 2): safe, granted
+    ResourceType p1Request[][2] = {{cpu, 1}, {swap, 2}};
+    assert(requestResources(banker, 1, 2, p1Request, systemResource) == banker_request_granted);
+    assert(state->available[cpu] == 2 && state->available[memory] == 3 && state->available[swap] == 0);
+    BankProConBlock *p1 = findBankProConBlockFromBanker(banker, 1);
+    assert(bankerStateRow(state, allocationMatrix, p1->row)[cpu] == 3);
+    assert(bankerStateRow(state, needMatrix, p1->row)[swap] == 0);
+    // the BaseAllocateArr cells follow the dense state
+    assert(banker->availableResource->array[0]->number == 2);
+    assert(p1->resource->assignedResource->array[2]->number == 2);
+
+    // P4 asks for (3, 3, 0): more than available
+    ResourceType p4Request[][2] = {{cpu, 3}, {memory, 3}};
+    assert(requestResources(banker, 4, 2, p4Request, systemResource) == banker_request_wait);
+
+    // P0 asks for (0, 2, 0): available, but nobody could finish afterwards
+    ResourceType p0Request[][2] = {{memory, 2}};
+    assert(requestResources(banker, 0, 1, p0Request, systemResource) == banker_request_wait);
+    BankProConBlock *p0 = findBankProConBlockFromBanker(banker, 0);
+    assert(state->available[memory] == 3);
+    assert(bankerStateRow(state, allocationMatrix, p0->row)[memory] == 1);
+    assert(p0->resource->assignedResource->array[1]->number == 1);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == true);
+
+    // beyond the need of P1, or an unknown process
+    ResourceType overNeed[][2] = {{swap, 1}};
+    assert(requestResources(banker, 1, 1, overNeed, systemResource) == banker_request_invalid);
+    assert(requestResources(banker, 42, 1, overNeed, systemResource) == banker_request_invalid);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_releaseResources_whenMoreThanHeld_isInvalid() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    Banker *banker = initTextbookBanker(systemResource);
+    BankerState *state = banker->state;
+
+    ResourceType tooMuch[][2] = {{cpu, 4}};
+    assert(releaseResources(banker, 2, 1, tooMuch) == banker_request_invalid);
+    assert(state->available[cpu] == 3);
+
+    // P2 gives back 3 cpu and 1 swap: its need grows by as much
+    ResourceType release[][2] = {{cpu, 3}, {swap, 1}};
+    assert(releaseResources(banker, 2, 2, release) == banker_request_granted);
+    BankProConBlock *p2 = findBankProConBlockFromBanker(banker, 2);
+    assert(state->available[cpu] == 6 && state->available[swap] == 3);
+    assert(bankerStateRow(state, allocationMatrix, p2->row)[cpu] == 0);
+    assert(bankerStateRow(state, needMatrix, p2->row)[cpu] == 9);
+    assert(p2->resource->needResource->array[2]->number == 1);
+    assert(banker->availableResource->array[2]->number == 3);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+/**
+ * @brief Creates a Banker of REQUEST_TEST_PROCESSES processes with random claims and no allocations.
+ */
+static Banker *initRandomRequestBanker(SystemResource *systemResource) {
+    ResourceType types[REQUEST_TEST_TYPES] = {cpu, memory, swap};
+    ResourceType availableResourceArr[REQUEST_TEST_TYPES][2];
+    for (int j = 0; j < REQUEST_TEST_TYPES; ++j) {
+        availableResourceArr[j][0] = types[j];
+        availableResourceArr[j][1] = 150;
+    }
+    Banker *banker = initBanker(availableResourceArr, REQUEST_TEST_TYPES, systemResource);
+
+    ResourceType group[REQUEST_TEST_PROCESSES][REQUEST_TEST_TYPES][3];
+    ProConBlock *pcbArr[REQUEST_TEST_PROCESSES];
+    for (int i = 0; i < REQUEST_TEST_PROCESSES; ++i) {
+        for (int j = 0; j < REQUEST_TEST_TYPES; ++j) {
+            group[i][j][0] = types[j];
+            group[i][j][1] = 1 + rand() % 20;
+            group[i][j][2] = 0;
+        }
+        pcbArr[i] = initProConBlock(i + 1, "request", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, REQUEST_TEST_PROCESSES, REQUEST_TEST_TYPES, group, systemResource);
+    return banker;
+}
+
+/**
+ * @brief Releases everything a process holds, as it does when it finishes.
+ */
+static void releaseHeldResources(Banker *banker, int p_id) {
+    BankProConBlock *bankProConBlock = findBankProConBlockFromBanker(banker, p_id);
+    const int32_t *allocationRow = bankerStateRow(banker->state, allocationMatrix, bankProConBlock->row);
+    ResourceType types[REQUEST_TEST_TYPES] = {cpu, memory, swap};
+    ResourceType releaseResourceArr[REQUEST_TEST_TYPES][2];
+    for (int j = 0; j < REQUEST_TEST_TYPES; ++j) {
+        releaseResourceArr[j][0] = types[j];
+        releaseResourceArr[j][1] = allocationRow[types[j]];
+    }
+    assert(releaseResources(banker, p_id, REQUEST_TEST_TYPES, releaseResourceArr) == banker_request_granted);
+}
+
+static long countSafetyChecks(Banker *banker) {
+    return banker->workspace->witnessHits + banker->workspace->witnessMisses;
+}
+
+void test_requestResourcesBatch_whenRequestsQueued_matchesOneByOne() {
+    SystemResource *systemResource = initSystemResource(1000000, 100, 100, 100, 100, 100);
+    srand(41);
+    Banker *batchBanker = initRandomRequestBanker(systemResource);
+    srand(41);
+    Banker *serialBanker = initRandomRequestBanker(systemResource);
+    long batchChecks = countSafetyChecks(batchBanker);
+    long serialChecks = countSafetyChecks(serialBanker);
+
+    ResourceType types[REQUEST_TEST_TYPES] = {cpu, memory, swap};
+    static BankerRequest requests[REQUEST_TEST_REQUESTS];
+    static BankerRequestResult serialResults[REQUEST_TEST_REQUESTS];
+    int results[3] = {0, 0, 0};
+    for (int round = 0; round < REQUEST_TEST_ROUNDS; ++round) {
+        for (int i = 0; i < REQUEST_TEST_REQUESTS; ++i) {
+            ResourceType resourceArr[REQUEST_TEST_TYPES][2];
+            for (int j = 0; j < REQUEST_TEST_TYPES; ++j) {
+                resourceArr[j][0] = types[j];
+                resourceArr[j][1] = rand() % 3;
+            }
+            // a few requests for processes that do not exist
+            int p_id = 1 + rand() % (REQUEST_TEST_PROCESSES + 2);
+            initBankerRequest(&requests[i], p_id, REQUEST_TEST_TYPES, resourceArr);
+        }
+
+        int serialGranted = 0;
+        for (int i = 0; i < REQUEST_TEST_REQUESTS; ++i) {
+            BankerRequest request = requests[i];
+            requestResourcesBatch(serialBanker, 1, &request, systemResource);
+            serialResults[i] = request.result;
+            serialGranted += request.result == banker_request_granted;
+            results[request.result] += 1;
+        }
+        assert(requestResourcesBatch(batchBanker, REQUEST_TEST_REQUESTS, requests, systemResource) == serialGranted);
+        for (int i = 0; i < REQUEST_TEST_REQUESTS; ++i) {
+            assert(requests[i].result == serialResults[i]);
+        }
+
+        BankerState *batchState = batchBanker->state;
+        BankerState *serialState = serialBanker->state;
+        assert(memcmp(batchState->available, serialState->available, batchState->columns * sizeof(int32_t)) == 0);
+        size_t matrixSize = (size_t) batchState->rows * batchState->columns * sizeof(int32_t);
+        assert(memcmp(batchState->allocationMatrix, serialState->allocationMatrix, matrixSize) == 0);
+        assert(memcmp(batchState->needMatrix, serialState->needMatrix, matrixSize) == 0);
+
+        // every fifth process finishes and gives back what it holds
+        for (int p_id = 1 + round % 5; p_id <= REQUEST_TEST_PROCESSES; p_id += 5) {
+            releaseHeldResources(batchBanker, p_id);
+            releaseHeldResources(serialBanker, p_id);
+        }
+    }
+    // the queue mixes every outcome, and the batches share their safety checks
+    assert(results[banker_request_granted] > 0 && results[banker_request_wait] > 0 && results[banker_request_invalid] > 0);
+    batchChecks = countSafetyChecks(batchBanker) - batchChecks;
+    serialChecks = countSafetyChecks(serialBanker) - serialChecks;
+    assert(batchChecks < serialChecks);
+
+    destroyBanker(batchBanker, systemResource);
+    destroyBanker(serialBanker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_requestResources_whenBoundsDecide_skipsSafetyCheck() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    // {type, max, assigned}
+    ResourceType group[2][2][3] = {
+            {{cpu, 4, 1}, {memory, 2, 0}},
+            {{cpu, 4, 1}, {memory, 2, 0}}
+    };
+
+    // plenty: the Need of everybody fits into Available
+    ResourceType plentyArr[][2] = {{cpu, 10}, {memory, 10}};
+    Banker *plenty = initBanker(plentyArr, 2, systemResource);
+    ProConBlock *plentyPcbArr[2];
+    for (int i = 0; i < 2; ++i) {
+        plentyPcbArr[i] = initProConBlock(i, "bounds", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(plenty, plentyPcbArr, 2, 2, group, systemResource);
+    long checks = countSafetyChecks(plenty);
+    ResourceType plentyRequest[][2] = {{cpu, 2}, {memory, 1}};
+    assert(requestResources(plenty, 0, 2, plentyRequest, systemResource) == banker_request_granted);
+    assert(plenty->workspace->boundsSafe == 1 && countSafetyChecks(plenty) == checks);
+
+    // tight: cpu 4, each process holds 1 and needs 3 more, so 2 are available
+    ResourceType tightArr[][2] = {{cpu, 4}, {memory, 10}};
+    Banker *tight = initBanker(tightArr, 2, systemResource);
+    ProConBlock *tightPcbArr[2];
+    for (int i = 0; i < 2; ++i) {
+        tightPcbArr[i] = initProConBlock(i, "bounds", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(tight, tightPcbArr, 2, 2, group, systemResource);
+    BankerWorkspace *workspace = tight->workspace;
+    checks = countSafetyChecks(tight);
+    // one more cpu for P0 leaves 1, less than anybody still needs
+    ResourceType oneCpu[][2] = {{cpu, 1}};
+    assert(requestResources(tight, 0, 1, oneCpu, systemResource) == banker_request_wait);
+    assert(workspace->boundsUnsafe == 1 && countSafetyChecks(tight) == checks);
+    assert(tight->state->available[cpu] == 2);
+
+    // after P1 gives its cpu back the bounds cannot tell, the safety check grants
+    assert(releaseResources(tight, 1, 1, oneCpu) == banker_request_granted);
+    assert(requestResources(tight, 0, 1, oneCpu, systemResource) == banker_request_granted);
+    assert(workspace->boundsUndecided == 1 && countSafetyChecks(tight) == checks + 1);
+
+    // the bounds followed every change: the sums are exact and the minimums never above the real ones
+    int64_t needTotal[tight->state->columns];
+    int32_t needMin[tight->state->columns];
+    memcpy(needTotal, workspace->needTotal, sizeof(needTotal));
+    memcpy(needMin, workspace->needMin, sizeof(needMin));
+    assert(isBankerBoundsFresh(workspace, tight->state));
+    workspace->boundsValid = false;
+    loadBankerBounds(workspace, tight->state);
+    assert(memcmp(needTotal, workspace->needTotal, sizeof(needTotal)) == 0);
+    for (int j = 0; j < tight->state->columns; ++j) {
+        assert(needMin[j] <= workspace->needMin[j]);
+    }
+    assert(workspace->needTotal[cpu] == 2 + 4 && workspace->needMin[cpu] == 2);
+
+    destroyBanker(plenty, systemResource);
+    destroyBanker(tight, systemResource);
+    destroySystemResource(systemResource);
+}
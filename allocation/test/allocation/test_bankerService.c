@@ -0,0 +1,159 @@
+/*
+ User: Redskaber
+ Date: 2024/1/31
+ Time: 14:20
+*/
+#include "../header/test_bankerService.h"
+
+#define SERVICE_TEST_THREADS 8
+#define SERVICE_TEST_PROCESSES 48
+#define SERVICE_TEST_ROUNDS 500
+#define SERVICE_TEST_TOTAL 60
+#define SERVICE_TEST_COLUMNS bankerStateColumns(RESOURCE_TYPE_BUILTIN)   // the Banker only uses builtin types
+
+typedef struct ServiceWorker {
+    BankerService *service;
+    int thread;
+    unsigned int seed;
+    int granted;
+} ServiceWorker;
+
+typedef struct ServiceReader {
+    BankerService *service;
+    _Atomic _Bool *running;
+    long snapshots;
+} ServiceReader;
+
+static const ResourceType serviceTypes[3] = {cpu, memory, swap};
+
+
+/**
+ * @brief Requests and releases resources for the processes p_id % SERVICE_TEST_THREADS == thread, which no other worker touches.
+ */
+static void *serviceWorker(void *arg) {
+    ServiceWorker *worker = arg;
+    int held[SERVICE_TEST_PROCESSES / SERVICE_TEST_THREADS][3] = {};
+    int32_t available[SERVICE_TEST_COLUMNS];
+    static int32_t allocation[SERVICE_TEST_THREADS][SERVICE_TEST_PROCESSES][SERVICE_TEST_COLUMNS];
+
+    for (int round = 0; round < SERVICE_TEST_ROUNDS; ++round) {
+        int slot = rand_r(&worker->seed) % (SERVICE_TEST_PROCESSES / SERVICE_TEST_THREADS);
+        int p_id = slot * SERVICE_TEST_THREADS + worker->thread;
+        ResourceType resourceArr[3][2];
+        if (rand_r(&worker->seed) % 4 == 0) {
+            // finish: give back everything
+            for (int j = 0; j < 3; ++j) {
+                resourceArr[j][0] = serviceTypes[j];
+                resourceArr[j][1] = held[slot][j];
+                held[slot][j] = 0;
+            }
+            assert(submitBankerRelease(worker->service, p_id, 3, resourceArr) == banker_request_granted);
+        } else {
+            for (int j = 0; j < 3; ++j) {
+                resourceArr[j][0] = serviceTypes[j];
+                resourceArr[j][1] = rand_r(&worker->seed) % 3;
+            }
+            BankerRequestResult result = submitBankerRequest(worker->service, p_id, 3, resourceArr);
+            if (result == banker_request_granted) {
+                worker->granted += 1;
+                for (int j = 0; j < 3; ++j) {
+                    held[slot][j] += (int) resourceArr[j][1];
+                }
+            }
+        }
+        // the snapshot already shows this worker's own rows as they are now
+        snapshotBankerService(worker->service, available, allocation[worker->thread]);
+        for (int j = 0; j < 3; ++j) {
+            assert(allocation[worker->thread][p_id][serviceTypes[j]] == held[slot][j]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Takes snapshots while the workers run: every one of them must conserve the resources.
+ */
+static void *serviceReader(void *arg) {
+    ServiceReader *reader = arg;
+    int32_t available[SERVICE_TEST_COLUMNS];
+    static int32_t allocation[SERVICE_TEST_PROCESSES][SERVICE_TEST_COLUMNS];
+    uint64_t version = 0;
+    while (atomic_load(reader->running)) {
+        uint64_t next = snapshotBankerService(reader->service, available, allocation);
+        assert(next >= version && (next & 1) == 0);
+        version = next;
+        for (int j = 0; j < 3; ++j) {
+            int32_t total = available[serviceTypes[j]];
+            assert(available[serviceTypes[j]] >= 0);
+            for (int row = 0; row < SERVICE_TEST_PROCESSES; ++row) {
+                total += allocation[row][serviceTypes[j]];
+            }
+            assert(total == SERVICE_TEST_TOTAL);
+        }
+        reader->snapshots += 1;
+    }
+    return NULL;
+}
+
+void test_submitBankerRequest_whenManyThreads_keepsStateConsistent() {
+    SystemResource *systemResource = initSystemResource(1000000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[3][2] = {
+            {cpu,    SERVICE_TEST_TOTAL},
+            {memory, SERVICE_TEST_TOTAL},
+            {swap,   SERVICE_TEST_TOTAL}
+    };
+    Banker *banker = initBanker(availableResourceArr, 3, systemResource);
+    ResourceType group[SERVICE_TEST_PROCESSES][3][3];
+    ProConBlock *pcbArr[SERVICE_TEST_PROCESSES];
+    srand(42);
+    for (int i = 0; i < SERVICE_TEST_PROCESSES; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            group[i][j][0] = serviceTypes[j];
+            group[i][j][1] = 2 + rand() % 9;
+            group[i][j][2] = 0;
+        }
+        pcbArr[i] = initProConBlock(i, "service", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, SERVICE_TEST_PROCESSES, 3, group, systemResource);
+
+    BankerService *service = initBankerService(banker, systemResource);
+    assert(service->columns == SERVICE_TEST_COLUMNS);
+    _Atomic _Bool running = true;
+    ServiceReader reader = {service, &running, 0};
+    pthread_t readerThread;
+    assert(pthread_create(&readerThread, NULL, serviceReader, &reader) == 0);
+    ServiceWorker workers[SERVICE_TEST_THREADS];
+    pthread_t threads[SERVICE_TEST_THREADS];
+    for (int t = 0; t < SERVICE_TEST_THREADS; ++t) {
+        workers[t] = (ServiceWorker) {service, t, 1000u + t, 0};
+        assert(pthread_create(&threads[t], NULL, serviceWorker, &workers[t]) == 0);
+    }
+    int granted = 0;
+    for (int t = 0; t < SERVICE_TEST_THREADS; ++t) {
+        pthread_join(threads[t], NULL);
+        granted += workers[t].granted;
+    }
+    atomic_store(&running, false);
+    pthread_join(readerThread, NULL);
+
+    // every submission went through the writer, several of them per group
+    assert(service->tickets == SERVICE_TEST_THREADS * SERVICE_TEST_ROUNDS);
+    assert(service->groups <= service->tickets);
+    assert(granted > 0 && reader.snapshots > 0);
+
+    int32_t available[SERVICE_TEST_COLUMNS];
+    static int32_t allocation[SERVICE_TEST_PROCESSES][SERVICE_TEST_COLUMNS];
+    snapshotBankerService(service, available, allocation);
+    destroyBankerService(service);
+
+    // the Banker belongs to this thread again: the snapshot is its state, and that state is safe
+    BankerState *state = banker->state;
+    assert(memcmp(available, state->available, sizeof(available)) == 0);
+    for (int row = 0; row < SERVICE_TEST_PROCESSES; ++row) {
+        assert(memcmp(allocation[row], bankerStateRow(state, allocationMatrix, row), sizeof(allocation[row])) == 0);
+    }
+    assert(checkResourceSecurity(banker, systemResource, NULL) == true);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
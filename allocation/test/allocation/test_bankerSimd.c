@@ -0,0 +1,56 @@
+/*
+ User: Redskaber
+ Date: 2024/1/28
+ Time: 18:20
+*/
+#include "../header/test_bankerSimd.h"
+
+#define SIMD_TEST_ROWS 1000
+#define SIMD_TEST_COLUMNS 16
+
+
+void test_scanRunnableRows_whenEveryLevel_matchesScalarReference() {
+    static int32_t needMatrix[SIMD_TEST_ROWS * SIMD_TEST_COLUMNS];
+    int32_t work[SIMD_TEST_COLUMNS];
+    uint64_t finish[bankerWorkspaceWords(SIMD_TEST_ROWS)];
+    uint64_t expected[bankerWorkspaceWords(SIMD_TEST_ROWS)];
+    uint64_t runnable[bankerWorkspaceWords(SIMD_TEST_ROWS)];
+
+    srand(38);
+    for (int j = 0; j < SIMD_TEST_COLUMNS; ++j) {
+        work[j] = 6 + rand() % 4;
+    }
+    memset(finish, 0, sizeof(finish));
+    int expectedCount = 0;
+    memset(expected, 0, sizeof(expected));
+    for (int i = 0; i < SIMD_TEST_ROWS; ++i) {
+        _Bool fits = true;
+        for (int j = 0; j < SIMD_TEST_COLUMNS; ++j) {
+            // mostly small needs, so that some rows fit in every column
+            needMatrix[i * SIMD_TEST_COLUMNS + j] = rand() % 16 == 0 ? 12 : rand() % 7;
+            fits = fits && needMatrix[i * SIMD_TEST_COLUMNS + j] <= work[j];
+        }
+        if (rand() % 3 == 0) {
+            finish[i >> 6] |= (uint64_t) 1 << (i & 63);
+        } else if (fits) {
+            expected[i >> 6] |= (uint64_t) 1 << (i & 63);
+            expectedCount += 1;
+        }
+    }
+    // a fully finished word is skipped
+    finish[3] = ~(uint64_t) 0;
+    expectedCount -= __builtin_popcountll(expected[3]);
+    expected[3] = 0;
+    assert(expectedCount > 0);
+
+    BankerSimdLevel selected = bankerSimdLevel();
+    for (BankerSimdLevel level = banker_simd_scalar; level <= banker_simd_avx2; ++level) {
+        forceBankerSimdLevel(level);
+        memset(runnable, 0xff, sizeof(runnable));
+        int count = scanRunnableRows(needMatrix, SIMD_TEST_COLUMNS, SIMD_TEST_ROWS, work, finish, runnable);
+        printf_s("[ SIMD ]: %s found %d runnable rows\n", bankerSimdLevelToString(bankerSimdLevel()), count);
+        assert(count == expectedCount);
+        assert(memcmp(runnable, expected, sizeof(expected)) == 0);
+    }
+    forceBankerSimdLevel(selected);
+}
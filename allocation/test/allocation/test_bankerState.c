@@ -0,0 +1,283 @@
+/*
+ User: Redskaber
+ Date: 2024/1/26
+ Time: 17:40
+*/
+#include "../header/test_bankerState.h"
+
+
+static Banker *initStateBanker(SystemResource *systemResource) {
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    20},
+            {memory, 25},
+            {swap,   30}
+    };
+    Banker *banker = initBanker(availableResourceArr, 3, systemResource);
+
+    // {type, max, assigned}, the types in a different order for every process
+    ResourceType bankerProConBlockGroup[3][3][3] = {
+            {{cpu,  7,  5}, {memory, 10, 5}, {swap, 15, 10}},
+            {{swap, 5,  2}, {cpu,    3,  2}, {memory, 7, 2}},
+            {{memory, 5, 2}, {swap,  7,  4}, {cpu,  9,  4}}
+    };
+    ProConBlock *pcbArr[3] = {
+            initProConBlock(1, "Process 1", 10.0, high, NULL, systemResource->memory),
+            initProConBlock(2, "Process 2", 20.0, normal, NULL, systemResource->memory),
+            initProConBlock(3, "Process 3", 30.0, low, NULL, systemResource->memory)
+    };
+    pushProConBlockArrToBanker(banker, pcbArr, 3, 3, bankerProConBlockGroup, systemResource);
+    return banker;
+}
+
+void test_pushProConBlockToBanker_whenProcessesPushed_fillsDenseRows() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    Banker *banker = initStateBanker(systemResource);
+    BankerState *state = banker->state;
+
+    assert(state->rows == 3);
+    assert(state->columns == bankerStateColumns(RESOURCE_TYPE_BUILTIN) && state->columns >= RESOURCE_TYPE_BUILTIN);
+    // available = initial - assigned, indexed by the resource type ordinal
+    assert(state->available[cpu] == 20 - 5 - 2 - 4);
+    assert(state->available[memory] == 25 - 5 - 2 - 2);
+    assert(state->available[swap] == 30 - 10 - 2 - 4);
+    assert(state->available[gpu] == 0);
+
+    const int32_t *need = bankerStateRow(state, needMatrix, 1);
+    assert(need[cpu] == 1 && need[memory] == 5 && need[swap] == 3 && need[gpu] == 0);
+    const int32_t *allocation = bankerStateRow(state, allocationMatrix, 2);
+    assert(allocation[cpu] == 4 && allocation[memory] == 2 && allocation[swap] == 4);
+    assert(bankerStateRow(state, maxMatrix, 0)[swap] == 15);
+    for (int i = 0; i < banker->size; ++i) {
+        assert(banker->array[i]->row == i);
+    }
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_checkResourceSecurity_whenRowRemoved_usesShiftedDenseState() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    Banker *banker = initStateBanker(systemResource);
+
+    BankProConBlock *orderExecute[banker->size];
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(orderExecute[0]->base->p_id == 1);
+
+    // process 2 leaves: process 3 moves to row 1, with its own need
+    removeBankProConBlockFromBanker(banker, findBankProConBlockFromBanker(banker, 2), systemResource);
+    BankerState *state = banker->state;
+    assert(state->rows == 2);
+    assert(findBankProConBlockFromBanker(banker, 3)->row == 1);
+    assert(bankerStateRow(state, needMatrix, 1)[cpu] == 5);
+
+    // keep only 4 cpu: process 3 (needs 5) can run only after process 1 (needs 2) returns its 5
+    banker->availableResource->array[0]->number = 4;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    BankProConBlock *shortOrder[banker->size];
+    assert(checkResourceSecurity(banker, systemResource, &shortOrder) == true);
+    assert(shortOrder[0]->base->p_id == 1);
+    assert(shortOrder[1]->base->p_id == 3);
+
+    // 1 cpu: nobody can finish
+    banker->availableResource->array[0]->number = 1;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == false);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_checkResourceSecurity_whenWorkspaceReserved_allocatesNothing() {
+    SystemResource *systemResource = initSystemResource(100000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    1000},
+            {memory, 1000}
+    };
+    Banker *banker = initBanker(availableResourceArr, 2, systemResource);
+
+    // process i needs i cpu more, so the safe sequence is found in p_id order
+    ResourceType bankerProConBlockGroup[200][2][3];
+    ProConBlock *pcbArr[200];
+    for (int i = 0; i < 200; ++i) {
+        bankerProConBlockGroup[i][0][0] = cpu;
+        bankerProConBlockGroup[i][0][1] = i + 1;
+        bankerProConBlockGroup[i][0][2] = 1;
+        bankerProConBlockGroup[i][1][0] = memory;
+        bankerProConBlockGroup[i][1][1] = 2;
+        bankerProConBlockGroup[i][1][2] = 1;
+        pcbArr[i] = initProConBlock(i + 1, "workspace", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 200, 2, bankerProConBlockGroup, systemResource);
+
+    // any allocation during the checks would fail the budget assertion of the allocator
+    Allocator *memory = systemResource->memory;
+    int used = memory->used;
+    int remain = memory->remain;
+    memory->remain = 0;
+    BankProConBlock *orderExecute[banker->size];
+    for (int round = 0; round < 10; ++round) {
+        assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    }
+    memory->remain = remain;
+    assert(memory->used == used);
+    assert(orderExecute[0]->base->p_id == 1);
+    assert(orderExecute[199]->base->p_id == 200);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_checkResourceSecurity_whenWitnessStillHolds_skipsFullSearch() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    Banker *banker = initStateBanker(systemResource);
+    BankerWorkspace *workspace = banker->workspace;
+    BankProConBlock *orderExecute[banker->size];
+
+    // the push order 1, 2, 3 is already safe
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(workspace->witnessHits == 1 && workspace->witnessMisses == 0);
+    assert(orderExecute[0]->base->p_id == 1 && orderExecute[2]->base->p_id == 3);
+
+    // 4 cpu: process 1 (needs 2) still runs first, the witness holds
+    banker->availableResource->array[0]->number = 4;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(workspace->witnessHits == 2 && workspace->witnessMisses == 0);
+
+    // 1 cpu: process 1 has to wait for process 2, the witness breaks and the search finds 2, 1, 3
+    banker->availableResource->array[0]->number = 1;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(workspace->witnessHits == 2 && workspace->witnessMisses == 1);
+    assert(orderExecute[0]->base->p_id == 2);
+    assert(orderExecute[1]->base->p_id == 1);
+    assert(orderExecute[2]->base->p_id == 3);
+    // the new witness answers the same state
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(workspace->witnessHits == 3 && workspace->witnessMisses == 1);
+
+    // process 2 leaves with its cpu, the rest of the witness keeps its order
+    banker->availableResource->array[0]->number = 3;
+    removeBankProConBlockFromBanker(banker, findBankProConBlockFromBanker(banker, 2), systemResource);
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(workspace->witnessSize - workspace->witnessDead == 2);
+    BankProConBlock *shortOrder[banker->size];
+    assert(checkResourceSecurity(banker, systemResource, &shortOrder) == true);
+    assert(workspace->witnessHits == 4 && workspace->witnessMisses == 1);
+    assert(shortOrder[0]->base->p_id == 1 && shortOrder[1]->base->p_id == 3);
+
+    // nobody fits: the witness breaks and so does the search
+    banker->availableResource->array[0]->number = 1;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == false);
+    assert(workspace->witnessMisses == 2);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_rollbackBankerStateTrial_whenRowsChanged_restoresRowsAndAvailable() {
+    SystemResource *systemResource = initSystemResource(3000, 100, 100, 100, 100, 100);
+    Banker *banker = initStateBanker(systemResource);
+    BankerState *state = banker->state;
+    size_t matrixSize = (size_t) state->rows * state->columns * sizeof(int32_t);
+    int32_t allocation[state->rows * state->columns];
+    int32_t need[state->rows * state->columns];
+    memcpy(allocation, state->allocationMatrix, matrixSize);
+    memcpy(need, state->needMatrix, matrixSize);
+    int32_t available[state->columns];
+    memcpy(available, state->available, sizeof(available));
+
+    // the first trial creates the undo log, the second one allocates nothing
+    for (int round = 0; round < 2; ++round) {
+        Allocator *memory = systemResource->memory;
+        int remain = memory->remain;
+        if (round == 1) {
+            memory->remain = 0;
+        }
+        beginBankerStateTrial(state, memory);
+        // row 1 is changed twice, row 2 once
+        int rows[3] = {1, 2, 1};
+        for (int i = 0; i < 3; ++i) {
+            logBankerStateRow(state, rows[i], memory);
+            bankerStateRow(state, allocationMatrix, rows[i])[cpu] += 1;
+            bankerStateRow(state, needMatrix, rows[i])[cpu] -= 1;
+            state->available[cpu] -= 1;
+        }
+        assert(bankerStateRow(state, allocationMatrix, 1)[cpu] == 4);
+        rollbackBankerStateTrial(state);
+        memory->remain = remain;
+
+        assert(memcmp(state->available, available, sizeof(available)) == 0 && state->available[cpu] == 9);
+        assert(memcmp(state->allocationMatrix, allocation, matrixSize) == 0);
+        assert(memcmp(state->needMatrix, need, matrixSize) == 0);
+    }
+
+    // a committed trial keeps its changes
+    beginBankerStateTrial(state, systemResource->memory);
+    logBankerStateRow(state, 0, systemResource->memory);
+    bankerStateRow(state, allocationMatrix, 0)[swap] += 2;
+    state->available[swap] -= 2;
+    commitBankerStateTrial(state);
+    assert(state->available[swap] == 14 - 2);
+    assert(bankerStateRow(state, allocationMatrix, 0)[swap] == 12);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_removeBankProConBlockFromBanker_whenBurstCompletes_keepsRowsAndWitness() {
+    SystemResource *systemResource = initSystemResource(1000000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    1000},
+            {memory, 1000}
+    };
+    Banker *banker = initBanker(availableResourceArr, 2, systemResource);
+
+    // process i needs i cpu more: every safe sequence is in p_id order
+    ResourceType bankerProConBlockGroup[300][2][3];
+    ProConBlock *pcbArr[300];
+    for (int i = 0; i < 300; ++i) {
+        bankerProConBlockGroup[i][0][0] = cpu;
+        bankerProConBlockGroup[i][0][1] = i + 401;
+        bankerProConBlockGroup[i][0][2] = 1;
+        bankerProConBlockGroup[i][1][0] = memory;
+        bankerProConBlockGroup[i][1][1] = i + 1;
+        bankerProConBlockGroup[i][1][2] = 0;
+        pcbArr[i] = initProConBlock(i + 1, "burst", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 300, 2, bankerProConBlockGroup, systemResource);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == true);
+
+    // every third process finishes, in a burst
+    for (int p_id = 3; p_id <= 300; p_id += 3) {
+        removeBankProConBlockFromBanker(banker, findBankProConBlockFromBanker(banker, p_id), systemResource);
+    }
+    assert(banker->size == 200 && banker->state->rows == 200);
+
+    // every process still owns the dense row it points to
+    BankerState *state = banker->state;
+    int32_t need[state->columns];
+    for (int i = 0; i < banker->size; ++i) {
+        BankProConBlock *bankProConBlock = banker->array[i];
+        assert(bankProConBlock->row == i);
+        assert(bankProConBlock->base->p_id % 3 != 0);
+        assert(findBankProConBlockFromBanker(banker, bankProConBlock->base->p_id) == bankProConBlock);
+        memcpy(need, bankerStateRow(state, needMatrix, i), sizeof(need));
+        loadBankerStateRow(state, i, bankProConBlock->resource);
+        assert(memcmp(need, bankerStateRow(state, needMatrix, i), sizeof(need)) == 0);
+    }
+
+    // the witness lost the finished processes and kept the order of the others
+    BankerWorkspace *workspace = banker->workspace;
+    long misses = workspace->witnessMisses;
+    BankProConBlock *orderExecute[banker->size];
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    assert(workspace->witnessMisses == misses);
+    for (int i = 1; i < banker->size; ++i) {
+        assert(orderExecute[i - 1]->base->p_id < orderExecute[i]->base->p_id);
+    }
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
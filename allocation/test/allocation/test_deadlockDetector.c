@@ -0,0 +1,97 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 17:41
+*/
+#include "../header/test_deadlockDetector.h"
+
+#define DETECTOR_TEST_PROCESSES 4000
+
+
+void test_waitForProcess_whenCycleCloses_choosesCheapestCutVictim() {
+    Allocator *allocator = createAllocator(100000);
+    DeadlockDetector *detector = initDeadlockDetector(allocator);
+    // process p holds held[p] memory; process 3 holds the least but can be bypassed
+    int held[5] = {0, 8, 4, 1, 6};
+    for (int p = 1; p <= 4; ++p) {
+        pushProcessToDeadlockDetector(detector, p, allocator);
+        BaseAllocate resource = {memory, held[p]};
+        holdDeadlockResource(detector, p, &resource, allocator);
+    }
+
+    // 1 -> 2 -> 3 -> 4 and 2 -> 4
+    assert(waitForProcess(detector, 1, 2, allocator).deadlocked == false);
+    assert(waitForProcess(detector, 2, 3, allocator).deadlocked == false);
+    assert(waitForProcess(detector, 3, 4, allocator).deadlocked == false);
+    assert(waitForProcess(detector, 2, 4, allocator).deadlocked == false);
+
+    // 4 -> 1 closes two cycles; 1, 2 and 4 are on both, 2 holds the least of them
+    DeadlockReport report = waitForProcess(detector, 4, 1, allocator);
+    assert(report.deadlocked == true);
+    assert(report.candidates == 3);
+    assert(report.victim == 2);
+
+    // without the victim nobody waits for 1 any more
+    removeProcessFromDeadlockDetector(detector, report.victim, allocator);
+    assert(detector->size == 3);
+    assert(waitForProcess(detector, 4, 1, allocator).deadlocked == false);
+    // 3 -> 4 -> 1: 1 waiting for 3 closes a cycle again
+    report = waitForProcess(detector, 1, 3, allocator);
+    assert(report.deadlocked == true && report.candidates == 3 && report.victim == 3);
+
+    // two locks held crosswise
+    pushProcessToDeadlockDetector(detector, 5, allocator);
+    pushProcessToDeadlockDetector(detector, 6, allocator);
+    BaseAllocate lock = {file, 1};
+    BaseAllocate link = {network, 1};
+    BaseAllocate buffer = {memory, 3};
+    holdDeadlockResource(detector, 5, &lock, allocator);
+    holdDeadlockResource(detector, 6, &link, allocator);
+    holdDeadlockResource(detector, 6, &buffer, allocator);
+    assert(waitForResource(detector, 5, network, allocator).deadlocked == false);
+    report = waitForResource(detector, 6, file, allocator);
+    assert(report.deadlocked == true && report.victim == 5);
+    // once 5 is served and returns the lock, 6 waits for nobody
+    clearDeadlockWaits(detector, 5);
+    releaseDeadlockResource(detector, 5, &lock);
+    assert(waitForResource(detector, 6, file, allocator).deadlocked == false);
+    assert(detector->nodes[detector->size - 1].outSize == 0);
+
+    destroyDeadlockDetector(detector, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_waitForResource_whenGraphLarge_searchesOnlyAffectedRegion() {
+    Allocator *allocator = createAllocator(4000000);
+    DeadlockDetector *detector = initDeadlockDetector(allocator);
+    for (int p = 0; p < DETECTOR_TEST_PROCESSES; ++p) {
+        pushProcessToDeadlockDetector(detector, p, allocator);
+    }
+    // chains of four: p waits for p + 1, already in topological order, so nothing is searched
+    for (int p = 0; p < DETECTOR_TEST_PROCESSES; p += 4) {
+        for (int k = 0; k < 3; ++k) {
+            assert(waitForProcess(detector, p + k, p + k + 1, allocator).deadlocked == false);
+        }
+    }
+    assert(detector->visited == 0);
+
+    // the tail of a late chain waits for the head of an early one: only the two chains are searched and reordered
+    assert(waitForProcess(detector, 3003, 1000, allocator).deadlocked == false);
+    assert(detector->visited <= 8);
+    for (int p = 0; p < DETECTOR_TEST_PROCESSES; ++p) {
+        DeadlockNode *node = &detector->nodes[p];
+        for (int k = 0; k < node->outSize; ++k) {
+            assert(node->order < detector->nodes[node->out[k]].order);
+        }
+    }
+
+    // closing the loop between the two chains is a deadlock found in the same region
+    long visited = detector->visited;
+    DeadlockReport report = waitForProcess(detector, 1003, 3000, allocator);
+    assert(report.deadlocked == true);
+    assert(report.candidates == 8);
+    assert(detector->visited - visited <= 16);
+
+    destroyDeadlockDetector(detector, allocator);
+    destroyAllocator(allocator);
+}
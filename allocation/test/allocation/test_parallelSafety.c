@@ -0,0 +1,63 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 11:03
+*/
+#include "../header/test_parallelSafety.h"
+
+#define PARALLEL_TEST_PROCESSES 2000
+#define PARALLEL_TEST_TYPES 4
+
+
+void test_checkResourceSecurityParallel_whenWorkersVary_returnsSameSequence() {
+    ResourceType types[PARALLEL_TEST_TYPES] = {memory, cpu, gpu, swap};
+    int workers[] = {2, 3, 8, PARALLEL_SAFETY_MAX_WORKERS};
+    int verdicts[2] = {0, 0};
+
+    for (int seed = 0; seed < 12; ++seed) {
+        srand(seed);
+        SystemResource *systemResource = initSystemResource(4000000, 100, 100, 100, 100, 100);
+        ResourceType availableResourceArr[PARALLEL_TEST_TYPES][2];
+        int remaining[PARALLEL_TEST_TYPES];
+        for (int j = 0; j < PARALLEL_TEST_TYPES; ++j) {
+            remaining[j] = 2000 + rand() % 1000;
+            availableResourceArr[j][0] = types[j];
+            availableResourceArr[j][1] = remaining[j];
+        }
+        Banker *banker = initBanker(availableResourceArr, PARALLEL_TEST_TYPES, systemResource);
+
+        // the larger the seed, the larger the needs: later seeds take more rounds or are unsafe
+        static ResourceType group[PARALLEL_TEST_PROCESSES][PARALLEL_TEST_TYPES][3];
+        static ProConBlock *pcbArr[PARALLEL_TEST_PROCESSES];
+        for (int i = 0; i < PARALLEL_TEST_PROCESSES; ++i) {
+            for (int j = 0; j < PARALLEL_TEST_TYPES; ++j) {
+                int max = rand() % (2 + seed * 40);
+                int assigned = max == 0 ? 0 : rand() % (max / 4 + 1);
+                assigned = assigned <= remaining[j] ? assigned : remaining[j];
+                remaining[j] -= assigned;
+                group[i][j][0] = types[j];
+                group[i][j][1] = max;
+                group[i][j][2] = assigned;
+            }
+            pcbArr[i] = initProConBlock(i + 1, "parallel", 1.0, normal, NULL, systemResource->memory);
+        }
+        pushProConBlockArrToBanker(banker, pcbArr, PARALLEL_TEST_PROCESSES, PARALLEL_TEST_TYPES, group, systemResource);
+
+        static BankProConBlock *serialOrder[PARALLEL_TEST_PROCESSES];
+        static BankProConBlock *parallelOrder[PARALLEL_TEST_PROCESSES];
+        _Bool serial = checkResourceSecurityParallel(banker, 1, systemResource, &serialOrder);
+        assert(serial == checkResourceSecurity(banker, systemResource, NULL));
+        for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); ++w) {
+            assert(checkResourceSecurityParallel(banker, workers[w], systemResource, &parallelOrder) == serial);
+            if (serial) {
+                assert(memcmp(serialOrder, parallelOrder, sizeof(serialOrder)) == 0);
+            }
+        }
+        verdicts[serial] += 1;
+
+        destroyBanker(banker, systemResource);
+        destroySystemResource(systemResource);
+    }
+    // the seeds cover both verdicts
+    assert(verdicts[false] > 0 && verdicts[true] > 0);
+}
@@ -0,0 +1,85 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 11:30
+*/
+#include "../header/test_resourceRegistry.h"
+
+
+void test_registerResourceType_whenNamesRegistered_givesDenseNumbers() {
+    // the built-in types are registered first, under the names they always printed with
+    assert(resourceTypeCount() >= RESOURCE_TYPE_BUILTIN);
+    assert(findResourceType("memory") == memory && findResourceType("file") == file);
+    assert(strcmp(resourceTypeToString(network), "network") == 0);
+
+    int before = resourceTypeCount();
+    int license = registerResourceType("registry_license");
+    int connection = registerResourceType("registry_db_connection");
+    assert(license >= RESOURCE_TYPE_BUILTIN && connection == license + 1);
+    assert(resourceTypeCount() == before + 2);
+    // a name is registered once
+    assert(registerResourceType("registry_license") == license);
+    assert(resourceTypeCount() == before + 2);
+
+    assert(findResourceType("registry_db_connection") == connection);
+    assert(findResourceType("registry_missing") == -1);
+    assert(strcmp(resourceTypeName(license), "registry_license") == 0);
+    assert(strcmp(resourceTypeName(resourceTypeCount()), "Unknown") == 0);
+}
+
+void test_requestResources_whenTypeRegistered_indexesItDirectly() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    ResourceType license = registerResourceType("registry_banker_license");
+    ResourceType availableResourceArr[][2] = {
+            {cpu,     2},
+            {license, 3}
+    };
+    Banker *banker = initBanker(availableResourceArr, 2, systemResource);
+    BankerState *state = banker->state;
+    // the columns cover the registered type, rounded up to the SIMD width
+    int type = (int) license;
+    assert(state->columns > type && state->columns == bankerStateColumns(type + 1));
+    assert(state->available[license] == 3);
+
+    // {type, max, assigned}
+    ResourceType group[2][2][3] = {
+            {{cpu, 2, 1}, {license, 2, 1}},
+            {{cpu, 2, 0}, {license, 2, 0}}
+    };
+    ProConBlock *pcbArr[2];
+    for (int i = 0; i < 2; ++i) {
+        pcbArr[i] = initProConBlock(i, "registry", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 2, 2, group, systemResource);
+    assert(state->available[license] == 2);
+
+    // P1 takes both remaining licenses: P0 waits for a license, P1 for the cpu P0 holds, unsafe
+    ResourceType greedy[][2] = {{license, 2}};
+    assert(requestResources(banker, 1, 1, greedy, systemResource) == banker_request_wait);
+    assert(state->available[license] == 2);
+    // one license leaves enough for P0, granted
+    ResourceType modest[][2] = {{license, 1}};
+    assert(requestResources(banker, 1, 1, modest, systemResource) == banker_request_granted);
+    assert(state->available[license] == 1);
+    assert(bankerStateRow(state, allocationMatrix, findBankProConBlockFromBanker(banker, 1)->row)[license] == 1);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == true);
+
+    // the DeadlockDetector grows its holders for the registered type
+    Allocator *allocator = createAllocator(10000);
+    DeadlockDetector *detector = initDeadlockDetector(allocator);
+    pushProcessToDeadlockDetector(detector, 0, allocator);
+    pushProcessToDeadlockDetector(detector, 1, allocator);
+    BaseAllocate held = {license, 1};
+    holdDeadlockResource(detector, 0, &held, allocator);
+    holdDeadlockResource(detector, 1, &held, allocator);
+    assert(detector->types > (int) license && detector->holders[license].size == 2);
+    assert(waitForResource(detector, 0, license, allocator).deadlocked == false);
+    assert(waitForResource(detector, 1, license, allocator).deadlocked == true);
+    releaseDeadlockResource(detector, 0, &held);
+    assert(detector->holders[license].size == 1 && detector->holders[license].nodes[0] == 1);
+    destroyDeadlockDetector(detector, allocator);
+    destroyAllocator(allocator);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
@@ -0,0 +1,122 @@
+/*
+ User: Redskaber
+ Date: 2024/2/1
+ Time: 14:37
+*/
+#include "../header/test_safeStream.h"
+
+#define STREAM_TEST_PROCESSES 12
+
+static Banker *streamBanker = NULL;
+static SystemResource *streamSystemResource = NULL;
+static int streamOrder[STREAM_TEST_PROCESSES];
+static int streamCount = 0;
+static BankerRequestResult streamRequest;
+static atomic_int streamRunning = 0;
+static atomic_int streamPeak = 0;
+
+
+/**
+ * @brief Records the order; the first process asks for one memory on behalf of process 4.
+ */
+static void *streamRequestCallBack(void *args) {
+    streamOrder[streamCount++] = ((ProConBlock *) args)->p_id;
+    if (streamCount == 1) {
+        ResourceType request[][2] = {{memory, 1}};
+        streamRequest = requestResources(streamBanker, 4, 1, request, streamSystemResource);
+    }
+    return args;
+}
+
+/**
+ * @brief Records how many callbacks run at the same time.
+ */
+static void *streamParallelCallBack(void *args) {
+    int running = atomic_fetch_add(&streamRunning, 1) + 1;
+    int peak = atomic_load(&streamPeak);
+    while (running > peak && !atomic_compare_exchange_weak(&streamPeak, &peak, running)) {
+    }
+    sched_yield();
+    atomic_fetch_sub(&streamRunning, 1);
+    return args;
+}
+
+void test_executeSafeSequenceStream_whenCallbackRequests_verifiesAgain() {
+    SystemResource *systemResource = initSystemResource(10000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    10},
+            {memory, 5},
+            {swap,   7}
+    };
+    Banker *banker = initBanker(availableResourceArr, 3, systemResource);
+
+    // the textbook example, {type, max, assigned}
+    ResourceType bankerProConBlockGroup[5][3][3] = {
+            {{cpu, 7, 0}, {memory, 5, 1}, {swap, 3, 0}},
+            {{cpu, 3, 2}, {memory, 2, 0}, {swap, 2, 0}},
+            {{cpu, 9, 3}, {memory, 0, 0}, {swap, 2, 2}},
+            {{cpu, 2, 2}, {memory, 2, 1}, {swap, 2, 1}},
+            {{cpu, 4, 0}, {memory, 3, 0}, {swap, 3, 2}}
+    };
+    ProConBlock *pcbArr[5];
+    for (int i = 0; i < 5; ++i) {
+        pcbArr[i] = initProConBlock(i, "stream", 1.0, normal, streamRequestCallBack, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 5, 3, bankerProConBlockGroup, systemResource);
+    BankProConBlock *orderExecute[5];
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    int first = orderExecute[0]->base->p_id;
+
+    streamBanker = banker;
+    streamSystemResource = systemResource;
+    streamCount = 0;
+    SafeStreamStats stats;
+    assert(executeSafeSequenceStream(banker, 1, systemResource, &stats) == true);
+    // the request of the first callback was granted, so the sequence was checked once more after it
+    assert(streamRequest == banker_request_granted);
+    assert(stats.verifications == 2);
+    assert(stats.executed == 5 && stats.rounds == 5);
+    assert(streamCount == 5);
+    assert(streamOrder[0] == first);
+    assert(banker->size == 0);
+    // every resource is back, including the memory granted to process 4
+    assert(banker->state->available[cpu] == 10);
+    assert(banker->state->available[memory] == 5);
+    assert(banker->state->available[swap] == 7);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_executeSafeSequenceStream_whenPrefixFitsTogether_runsInParallel() {
+    SystemResource *systemResource = initSystemResource(20000, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu, 8}
+    };
+    Banker *banker = initBanker(availableResourceArr, 1, systemResource);
+
+    // every process needs 2 cpu, so 4 of them fit into the available cpu together
+    ResourceType bankerProConBlockGroup[STREAM_TEST_PROCESSES][1][3];
+    ProConBlock *pcbArr[STREAM_TEST_PROCESSES];
+    for (int i = 0; i < STREAM_TEST_PROCESSES; ++i) {
+        bankerProConBlockGroup[i][0][0] = cpu;
+        bankerProConBlockGroup[i][0][1] = 2;
+        bankerProConBlockGroup[i][0][2] = 0;
+        pcbArr[i] = initProConBlock(i, "stream", 1.0, normal, streamParallelCallBack, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, STREAM_TEST_PROCESSES, 1, bankerProConBlockGroup, systemResource);
+
+    atomic_store(&streamPeak, 0);
+    SafeStreamStats stats;
+    assert(executeSafeSequenceStream(banker, 8, systemResource, &stats) == true);
+    // more workers than fit: the available cpu bounds every round to 4 processes
+    assert(stats.verifications == 1);
+    assert(stats.executed == STREAM_TEST_PROCESSES);
+    assert(stats.rounds == STREAM_TEST_PROCESSES / 4);
+    assert(atomic_load(&streamPeak) <= 4);
+    assert(banker->size == 0);
+    assert(banker->state->available[cpu] == 8);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
@@ -0,0 +1,103 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 16:35
+*/
+#include "../header/test_safetyCache.h"
+
+
+/**
+ * @brief The incrementally kept hash must equal the one computed from every cell.
+ */
+static void assertSafetyHashExact(Banker *banker) {
+    BankerSafetyCache *cache = banker->workspace->cache;
+    assert(isBankerSafetyHashFresh(cache, banker->state));
+    uint64_t hash = cache->hash;
+    cache->hashValid = false;
+    assert(loadBankerSafetyHash(cache, banker->state) == hash);
+}
+
+static long countSafetyScans(Banker *banker) {
+    return banker->workspace->witnessHits + banker->workspace->witnessMisses;
+}
+
+void test_checkResourceSecurity_whenStateRecurs_answersFromCache() {
+    SystemResource *systemResource = initSystemResource(20000, 100, 100, 100, 100, 100);
+    // the textbook example, A = cpu, B = memory, C = swap; available (3, 3, 2)
+    ResourceType availableResourceArr[][2] = {
+            {cpu,    10},
+            {memory, 5},
+            {swap,   7}
+    };
+    Banker *banker = initBanker(availableResourceArr, 3, systemResource);
+    // {type, max, assigned}
+    ResourceType bankerProConBlockGroup[5][3][3] = {
+            {{cpu, 7, 0}, {memory, 5, 1}, {swap, 3, 0}},
+            {{cpu, 3, 2}, {memory, 2, 0}, {swap, 2, 0}},
+            {{cpu, 9, 3}, {memory, 0, 0}, {swap, 2, 2}},
+            {{cpu, 2, 2}, {memory, 2, 1}, {swap, 2, 1}},
+            {{cpu, 4, 0}, {memory, 3, 0}, {swap, 3, 2}}
+    };
+    ProConBlock *pcbArr[6];
+    for (int i = 0; i < 6; ++i) {
+        pcbArr[i] = initProConBlock(i, "cache", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, 5, 3, bankerProConBlockGroup, systemResource);
+    enableBankerSafetyCache(banker, BANKER_SAFETY_CACHE_SIZE, systemResource);
+    BankerSafetyCache *cache = banker->workspace->cache;
+
+    // P1 takes (1, 0, 2) and gives it back: the state after the grant recurs
+    ResourceType p1Request[][2] = {{cpu, 1}, {swap, 2}};
+    assert(requestResources(banker, 1, 2, p1Request, systemResource) == banker_request_granted);
+    assert(cache->hits == 0 && cache->misses == 1);
+    assertSafetyHashExact(banker);
+    assert(releaseResources(banker, 1, 2, p1Request) == banker_request_granted);
+    assertSafetyHashExact(banker);
+    long scans = countSafetyScans(banker);
+    assert(requestResources(banker, 1, 2, p1Request, systemResource) == banker_request_granted);
+    assert(cache->hits == 1 && countSafetyScans(banker) == scans);
+
+    // P0 asking (0, 2, 0) now is unsafe; the verdict is remembered, and the rollback restores the hash
+    ResourceType p0Request[][2] = {{memory, 2}};
+    assert(requestResources(banker, 0, 1, p0Request, systemResource) == banker_request_wait);
+    assertSafetyHashExact(banker);
+    scans = countSafetyScans(banker);
+    assert(requestResources(banker, 0, 1, p0Request, systemResource) == banker_request_wait);
+    assert(cache->hits == 2 && countSafetyScans(banker) == scans);
+
+    // pushing, syncing and removing processes keep the hash up to date as well
+    ResourceType newcomer[1][3][3] = {{{cpu, 1, 0}, {memory, 1, 0}, {swap, 0, 0}}};
+    pushProConBlockArrToBanker(banker, pcbArr + 5, 1, 3, newcomer, systemResource);
+    assertSafetyHashExact(banker);
+    // P1 needs (0, 2, 0) of (2, 3, 0): it runs to the end and leaves, row 1 takes the last process
+    BankProConBlock *p1 = findBankProConBlockFromBanker(banker, 1);
+    assert(admitBankProConBlock(banker, p1) == true);
+    assertSafetyHashExact(banker);
+    releaseBankProConBlock(banker, p1);
+    removeBankProConBlockFromBanker(banker, p1, systemResource);
+    assertSafetyHashExact(banker);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == true);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
+
+void test_saveBankerSafety_whenCacheFull_evictsLeastRecentlyUsed() {
+    Allocator *allocator = createAllocator(10000);
+    BankerSafetyCache *cache = initBankerSafetyCache(2, allocator);
+    int sequence[3] = {2, 0, 1};
+    saveBankerSafety(cache, 11, true, sequence, 3, allocator);
+    saveBankerSafety(cache, 22, false, NULL, 0, allocator);
+    // 11 is used again, so 22 is the least recently used
+    BankerSafetyEntry *entry = findBankerSafety(cache, 11);
+    assert(entry != NULL && entry->safe == true && entry->rows == 3 && entry->sequence[0] == 2);
+    saveBankerSafety(cache, 33, true, sequence, 2, allocator);
+    assert(cache->evictions == 1 && cache->size == 2);
+    assert(findBankerSafety(cache, 22) == NULL);
+    assert(findBankerSafety(cache, 11) != NULL);
+    entry = findBankerSafety(cache, 33);
+    assert(entry != NULL && entry->rows == 2);
+    assert(cache->hits == 3 && cache->misses == 1);
+    destroyBankerSafetyCache(cache, allocator);
+    destroyAllocator(allocator);
+}
@@ -0,0 +1,117 @@
+/*
+ User: Redskaber
+ Date: 2024/1/29
+ Time: 16:48
+*/
+#include "../header/test_sortedSafety.h"
+
+#define SORTED_TEST_PROCESSES 300
+#define SORTED_TEST_TYPES 4
+#define SORTED_CHAIN_PROCESSES (BANKER_SORTED_SAFETY_ROWS + 1000)
+
+
+/**
+ * @brief Replays a safe sequence on the dense state and checks that every process can finish in turn.
+ */
+static _Bool replaySafeSequence(Banker *banker, BankProConBlock **sequence) {
+    BankerState *state = banker->state;
+    int32_t work[state->columns];
+    memcpy(work, state->available, sizeof(work));
+    for (int i = 0; i < banker->size; ++i) {
+        const int32_t *need = bankerStateRow(state, needMatrix, sequence[i]->row);
+        const int32_t *allocation = bankerStateRow(state, allocationMatrix, sequence[i]->row);
+        for (int j = 0; j < state->columns; ++j) {
+            if (need[j] > work[j]) {
+                return false;
+            }
+        }
+        for (int j = 0; j < state->columns; ++j) {
+            work[j] += allocation[j];
+        }
+    }
+    return true;
+}
+
+void test_checkResourceSecuritySorted_whenRandomStates_agreesWithScan() {
+    ResourceType types[SORTED_TEST_TYPES] = {memory, cpu, gpu, swap};
+    int verdicts[2] = {0, 0};
+
+    for (int seed = 0; seed < 40; ++seed) {
+        srand(seed);
+        SystemResource *systemResource = initSystemResource(1000000, 100, 100, 100, 100, 100);
+        ResourceType availableResourceArr[SORTED_TEST_TYPES][2];
+        int remaining[SORTED_TEST_TYPES];
+        for (int j = 0; j < SORTED_TEST_TYPES; ++j) {
+            remaining[j] = 400 + rand() % 200;
+            availableResourceArr[j][0] = types[j];
+            availableResourceArr[j][1] = remaining[j];
+        }
+        Banker *banker = initBanker(availableResourceArr, SORTED_TEST_TYPES, systemResource);
+
+        static ResourceType group[SORTED_TEST_PROCESSES][SORTED_TEST_TYPES][3];
+        ProConBlock *pcbArr[SORTED_TEST_PROCESSES];
+        for (int i = 0; i < SORTED_TEST_PROCESSES; ++i) {
+            for (int j = 0; j < SORTED_TEST_TYPES; ++j) {
+                int max = rand() % (10 + seed);
+                int assigned = max == 0 ? 0 : rand() % (max + 1);
+                assigned = assigned <= remaining[j] ? assigned : remaining[j];
+                remaining[j] -= assigned;
+                group[i][j][0] = types[j];
+                group[i][j][1] = max;
+                group[i][j][2] = assigned;
+            }
+            pcbArr[i] = initProConBlock(i + 1, "sorted", 1.0, normal, NULL, systemResource->memory);
+        }
+        pushProConBlockArrToBanker(banker, pcbArr, SORTED_TEST_PROCESSES, SORTED_TEST_TYPES, group, systemResource);
+
+        BankProConBlock *scanOrder[banker->size];
+        BankProConBlock *sortedOrder[banker->size];
+        _Bool scan = checkResourceSecurity(banker, systemResource, &scanOrder);
+        _Bool sorted = checkResourceSecuritySorted(banker, systemResource, &sortedOrder);
+        assert(scan == sorted);
+        if (sorted) {
+            assert(replaySafeSequence(banker, sortedOrder));
+        }
+        verdicts[sorted] += 1;
+
+        destroyBanker(banker, systemResource);
+        destroySystemResource(systemResource);
+    }
+    // the seeds cover both verdicts
+    assert(verdicts[false] > 0 && verdicts[true] > 0);
+}
+
+void test_checkResourceSecurity_whenLongChain_usesSortedSequence() {
+    SystemResource *systemResource = initSystemResource(INT32_MAX, 100, 100, 100, 100, 100);
+    ResourceType availableResourceArr[][2] = {
+            {cpu, SORTED_CHAIN_PROCESSES + 1}
+    };
+    Banker *banker = initBanker(availableResourceArr, 1, systemResource);
+
+    // process p needs p cpu and holds 1: only the last pushed one fits at first, each one unlocks the next
+    static ResourceType group[SORTED_CHAIN_PROCESSES][1][3];
+    static ProConBlock *pcbArr[SORTED_CHAIN_PROCESSES];
+    for (int i = 0; i < SORTED_CHAIN_PROCESSES; ++i) {
+        int p_id = SORTED_CHAIN_PROCESSES - i;
+        group[i][0][0] = cpu;
+        group[i][0][1] = p_id + 1;
+        group[i][0][2] = 1;
+        pcbArr[i] = initProConBlock(p_id, "chain", 1.0, normal, NULL, systemResource->memory);
+    }
+    pushProConBlockArrToBanker(banker, pcbArr, SORTED_CHAIN_PROCESSES, 1, group, systemResource);
+    assert(banker->state->available[cpu] == 1);
+
+    static BankProConBlock *orderExecute[SORTED_CHAIN_PROCESSES];
+    assert(checkResourceSecurity(banker, systemResource, &orderExecute) == true);
+    for (int i = 0; i < SORTED_CHAIN_PROCESSES; ++i) {
+        assert(orderExecute[i]->base->p_id == i + 1);
+    }
+
+    // one cpu less and nobody can start
+    banker->availableResource->array[0]->number = 0;
+    syncBankProConBlockToBanker(banker, banker->array[0]);
+    assert(checkResourceSecurity(banker, systemResource, NULL) == false);
+
+    destroyBanker(banker, systemResource);
+    destroySystemResource(systemResource);
+}
@@ -0,0 +1,23 @@
+/*
+ User: Redskaber
+ Date: 2024/1/25
+ Time: 14:06
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_BANKERADMISSION_H
+#define OPERATORSYSTEM_TEST_BANKERADMISSION_H
+
+#include <assert.h>
+#include "../../admission/banker_admission.h"
+#include "../../../process/run_queue/priority_run_queue.h"
+#include "../../../process/group/schedule_group.h"
+
+extern void test_bankerAdmissionScheduling_whenHeadNeedsReleasedResources_defersAndRetries();
+
+extern void test_bankerAdmissionScheduling_whenNeedNeverFits_requeuesProcess();
+
+extern void test_bankerAdmissionScheduling_whenRoundRobin_admitsAtDispatch();
+
+extern void test_attachScheduleBanker_whenAgingAndGroupFairDispatch_holdBackRefused();
+
+#endif //OPERATORSYSTEM_TEST_BANKERADMISSION_H
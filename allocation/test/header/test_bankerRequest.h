@@ -0,0 +1,21 @@
+/*
+ User: Redskaber
+ Date: 2024/1/30
+ Time: 15:02
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_BANKERREQUEST_H
+#define OPERATORSYSTEM_TEST_BANKERREQUEST_H
+
+#include <assert.h>
+#include "../../request/banker_request.h"
+
+extern void test_requestResources_whenGrantUnsafe_rollsBackAndWaits();
+
+extern void test_releaseResources_whenMoreThanHeld_isInvalid();
+
+extern void test_requestResourcesBatch_whenRequestsQueued_matchesOneByOne();
+
+extern void test_requestResources_whenBoundsDecide_skipsSafetyCheck();
+
+#endif //OPERATORSYSTEM_TEST_BANKERREQUEST_H
@@ -0,0 +1,16 @@
+/*
+ User: Redskaber
+ Date: 2024/1/31
+ Time: 14:20
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_BANKERSERVICE_H
+#define OPERATORSYSTEM_TEST_BANKERSERVICE_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include "../../concurrent/banker_service.h"
+
+extern void test_submitBankerRequest_whenManyThreads_keepsStateConsistent();
+
+#endif //OPERATORSYSTEM_TEST_BANKERSERVICE_H
@@ -0,0 +1,16 @@
+/*
+ User: Redskaber
+ Date: 2024/1/28
+ Time: 18:20
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_BANKERSIMD_H
+#define OPERATORSYSTEM_TEST_BANKERSIMD_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include "../../simd/banker_simd.h"
+
+extern void test_scanRunnableRows_whenEveryLevel_matchesScalarReference();
+
+#endif //OPERATORSYSTEM_TEST_BANKERSIMD_H
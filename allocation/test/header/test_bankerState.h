@@ -0,0 +1,25 @@
+/*
+ User: Redskaber
+ Date: 2024/1/26
+ Time: 17:40
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_BANKERSTATE_H
+#define OPERATORSYSTEM_TEST_BANKERSTATE_H
+
+#include <assert.h>
+#include "../../banker.h"
+
+extern void test_pushProConBlockToBanker_whenProcessesPushed_fillsDenseRows();
+
+extern void test_checkResourceSecurity_whenRowRemoved_usesShiftedDenseState();
+
+extern void test_checkResourceSecurity_whenWorkspaceReserved_allocatesNothing();
+
+extern void test_checkResourceSecurity_whenWitnessStillHolds_skipsFullSearch();
+
+extern void test_rollbackBankerStateTrial_whenRowsChanged_restoresRowsAndAvailable();
+
+extern void test_removeBankProConBlockFromBanker_whenBurstCompletes_keepsRowsAndWitness();
+
+#endif //OPERATORSYSTEM_TEST_BANKERSTATE_H
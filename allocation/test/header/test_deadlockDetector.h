@@ -0,0 +1,17 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 17:41
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_DEADLOCKDETECTOR_H
+#define OPERATORSYSTEM_TEST_DEADLOCKDETECTOR_H
+
+#include <assert.h>
+#include "../../detection/deadlock_detector.h"
+
+extern void test_waitForProcess_whenCycleCloses_choosesCheapestCutVictim();
+
+extern void test_waitForResource_whenGraphLarge_searchesOnlyAffectedRegion();
+
+#endif //OPERATORSYSTEM_TEST_DEADLOCKDETECTOR_H
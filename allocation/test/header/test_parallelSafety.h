@@ -0,0 +1,15 @@
+/*
+ User: Redskaber
+ Date: 2024/2/2
+ Time: 11:03
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_PARALLELSAFETY_H
+#define OPERATORSYSTEM_TEST_PARALLELSAFETY_H
+
+#include <assert.h>
+#include "../../parallel/parallel_safety.h"
+
+extern void test_checkResourceSecurityParallel_whenWorkersVary_returnsSameSequence();
+
+#endif //OPERATORSYSTEM_TEST_PARALLELSAFETY_H
@@ -0,0 +1,18 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 11:30
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_RESOURCEREGISTRY_H
+#define OPERATORSYSTEM_TEST_RESOURCEREGISTRY_H
+
+#include <assert.h>
+#include "../../request/banker_request.h"
+#include "../../detection/deadlock_detector.h"
+
+extern void test_registerResourceType_whenNamesRegistered_givesDenseNumbers();
+
+extern void test_requestResources_whenTypeRegistered_indexesItDirectly();
+
+#endif //OPERATORSYSTEM_TEST_RESOURCEREGISTRY_H
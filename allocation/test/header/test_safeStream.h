@@ -0,0 +1,19 @@
+/*
+ User: Redskaber
+ Date: 2024/2/1
+ Time: 14:37
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_SAFESTREAM_H
+#define OPERATORSYSTEM_TEST_SAFESTREAM_H
+
+#include <assert.h>
+#include <stdatomic.h>
+#include "../../stream/safe_stream.h"
+#include "../../request/banker_request.h"
+
+extern void test_executeSafeSequenceStream_whenCallbackRequests_verifiesAgain();
+
+extern void test_executeSafeSequenceStream_whenPrefixFitsTogether_runsInParallel();
+
+#endif //OPERATORSYSTEM_TEST_SAFESTREAM_H
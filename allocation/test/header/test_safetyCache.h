@@ -0,0 +1,18 @@
+/*
+ User: Redskaber
+ Date: 2024/2/3
+ Time: 16:35
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_SAFETYCACHE_H
+#define OPERATORSYSTEM_TEST_SAFETYCACHE_H
+
+#include <assert.h>
+#include "../../request/banker_request.h"
+#include "../../admission/banker_admission.h"
+
+extern void test_checkResourceSecurity_whenStateRecurs_answersFromCache();
+
+extern void test_saveBankerSafety_whenCacheFull_evictsLeastRecentlyUsed();
+
+#endif //OPERATORSYSTEM_TEST_SAFETYCACHE_H
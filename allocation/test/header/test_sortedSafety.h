@@ -0,0 +1,18 @@
+/*
+ User: Redskaber
+ Date: 2024/1/29
+ Time: 16:48
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_TEST_SORTEDSAFETY_H
+#define OPERATORSYSTEM_TEST_SORTEDSAFETY_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include "../../sorted/sorted_safety.h"
+
+extern void test_checkResourceSecuritySorted_whenRandomStates_agreesWithScan();
+
+extern void test_checkResourceSecurity_whenLongChain_usesSortedSequence();
+
+#endif //OPERATORSYSTEM_TEST_SORTEDSAFETY_H
@@ -15,6 +15,65 @@ void test_Banker() {
 void testBankerSecurity() {
 //    test_checkResourceSecurity_withSafeSequence_returnsTrue();
 //    test_checkResourceSecurity_withUnsafeSequence_returnsFalse();
+    test_pushProConBlockToBanker_whenProcessesPushed_fillsDenseRows();
+    test_checkResourceSecurity_whenRowRemoved_usesShiftedDenseState();
+    test_checkResourceSecurity_whenWorkspaceReserved_allocatesNothing();
+    test_checkResourceSecurity_whenWitnessStillHolds_skipsFullSearch();
+    test_rollbackBankerStateTrial_whenRowsChanged_restoresRowsAndAvailable();
+    test_removeBankProConBlockFromBanker_whenBurstCompletes_keepsRowsAndWitness();
+    test_scanRunnableRows_whenEveryLevel_matchesScalarReference();
+    test_checkResourceSecuritySorted_whenRandomStates_agreesWithScan();
+    test_checkResourceSecurity_whenLongChain_usesSortedSequence();
+    test_bankerAdmissionScheduling_whenHeadNeedsReleasedResources_defersAndRetries();
+    test_bankerAdmissionScheduling_whenNeedNeverFits_requeuesProcess();
+    test_bankerAdmissionScheduling_whenRoundRobin_admitsAtDispatch();
+    test_attachScheduleBanker_whenAgingAndGroupFairDispatch_holdBackRefused();
+    test_requestResources_whenGrantUnsafe_rollsBackAndWaits();
+    test_releaseResources_whenMoreThanHeld_isInvalid();
+    test_requestResourcesBatch_whenRequestsQueued_matchesOneByOne();
+    test_requestResources_whenBoundsDecide_skipsSafetyCheck();
+    test_submitBankerRequest_whenManyThreads_keepsStateConsistent();
+    test_executeSafeSequenceStream_whenCallbackRequests_verifiesAgain();
+    test_executeSafeSequenceStream_whenPrefixFitsTogether_runsInParallel();
+    test_checkResourceSecurityParallel_whenWorkersVary_returnsSameSequence();
+    test_waitForProcess_whenCycleCloses_choosesCheapestCutVictim();
+    test_waitForResource_whenGraphLarge_searchesOnlyAffectedRegion();
+    test_registerResourceType_whenNamesRegistered_givesDenseNumbers();
+    test_requestResources_whenTypeRegistered_indexesItDirectly();
+    test_checkResourceSecurity_whenStateRecurs_answersFromCache();
+    test_saveBankerSafety_whenCacheFull_evictsLeastRecentlyUsed();
+}
+
+void test_Scheduler() {
+    test_findProConBlockFromLink_whenProcessExists_returnsProConBlock();
+    test_killProConBlockFromLink_whenProcessInMiddle_relinksNeighbours();
+    test_reniceProConBlockFromLink_whenProcessExists_changesPriority();
+    test_killProConBlockFromLink_whenProcessesShareId_keepsTheOthersIndexed();
+    test_dequeuePriorityRunQueue_whenLowWaitsLongEnough_overtakesExigencyStream();
+    test_reniceFromPriorityRunQueue_whenProcessWaiting_movesLevel();
+    test_priorityAgingScheduling_whenLinkScheduled_usesLinkAllocator();
+    test_restoreSchedulerSnapshot_whenCheckpointed_restoresRunQueue();
+    test_restoreSchedulerSnapshot_whenFileCorrupt_returnsNull();
+    test_restoreProConBlockLinkSnapshot_whenCheckpointed_restoresLinkOrder();
+    test_runPolicySweep_whenGridOfPolicies_matchesSerialSimulation();
+    test_runPolicySweep_whenSliceCoversEveryJob_roundRobinEqualsFirstComeFirstServe();
+    test_runPolicySweep_whenDefaultParameters_matchesRealScheduler();
+    test_simulatePolicy_whenProcessesShareId_countsEveryProcess();
+    test_attachScheduleTrace_whenRoundRobin_recordsEverySlice();
+    test_attachScheduleTrace_whenThreadsDispatch_recordsOneLanePerThread();
+    test_attachScheduleTrace_whenSharedByThreads_recordsEveryEventOnItsLane();
+    test_snapshotScheduleStats_whenPoliciesRun_countsPerPolicy();
+    test_snapshotScheduleStats_whenOtherThreadRecords_sumsShards();
+    test_snapshotScheduleStats_whenThreadsExit_keepsRetiredCounts();
+    test_percentileScheduleHistogram_whenSkewed_returnsBucketUpperBound();
+    test_shortestJobFromTable_whenLoadedFromLink_matchesShortestJobNext();
+    test_highestPriorityFromTable_whenRowsFinish_skipsFinishedRows();
+    test_toCompactTicks_whenTimeOutOfRange_saturates();
+    test_pushRingQueue_whenWrappedAndFull_growsInOrder();
+    test_roundRobinScheduling_whenJobsFinish_linksReverseCompletionOrder();
+    test_roundRobinScheduling_whenProcessesShareId_schedulesEveryNode();
+    test_pickScheduleGroup_whenTenantFloods_othersKeepTheirShare();
+    test_groupFairScheduling_whenNestedGroups_finishesEveryProcess();
 }
 
 int main() {
@@ -22,6 +81,7 @@ int main() {
     test_Banker();
     testBankerSecurity();
     test_allocator();
+    test_Scheduler();
 
     return 0;
 }
@@ -11,6 +11,27 @@
 
 #include "allocation/test/header/test_initBanker.h"
 #include "allocation/test/header/test_checkResourceSecurity.h"
+#include "allocation/test/header/test_bankerAdmission.h"
+#include "allocation/test/header/test_bankerState.h"
+#include "allocation/test/header/test_bankerSimd.h"
+#include "allocation/test/header/test_sortedSafety.h"
+#include "allocation/test/header/test_bankerRequest.h"
+#include "allocation/test/header/test_bankerService.h"
+#include "allocation/test/header/test_safeStream.h"
+#include "allocation/test/header/test_parallelSafety.h"
+#include "allocation/test/header/test_deadlockDetector.h"
+#include "allocation/test/header/test_resourceRegistry.h"
+#include "allocation/test/header/test_safetyCache.h"
 
 #include "allocation/test/header/test_allocator.h"
+
+#include "process/test/header/test_findProConBlockFromLink.h"
+#include "process/test/header/test_priorityRunQueue.h"
+#include "process/test/header/test_schedulerCheckpoint.h"
+#include "process/test/header/test_policySweep.h"
+#include "process/test/header/test_scheduleTrace.h"
+#include "process/test/header/test_scheduleStats.h"
+#include "process/test/header/test_compactProConBlock.h"
+#include "process/test/header/test_ringQueue.h"
+#include "process/test/header/test_scheduleGroup.h"
 #endif //OPERATORSYSTEM_MAIN_H
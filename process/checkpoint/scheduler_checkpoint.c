@@ -0,0 +1,487 @@
+/*
+ User: Redskaber
+ Date: 2024/1/14
+ Time: 16:20
+*/
+#include "scheduler_checkpoint.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/**
+ * @brief Maps a checkpoint file into memory with copy-on-write semantics.
+ *
+ * The mapping is private: the fix-up pass may rewrite offsets into pointers without modifying the file on disk.
+ *
+ * @param path Path of the checkpoint file.
+ * @param length Output parameter receiving the length of the mapping.
+ * @return Base address of the mapping, NULL if the file cannot be mapped.
+ */
+static void *mapCheckpointFile(const char *path, size_t *length) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return NULL;
+    }
+    void *base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    *length = (size_t) size.QuadPart;
+    return base;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    void *base = mmap(NULL, (size_t) status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    *length = (size_t) status.st_size;
+    return base;
+#endif
+}
+
+/**
+ * @brief Unmaps a mapping created by mapCheckpointFile.
+ *
+ * @param base Base address of the mapping.
+ * @param length Length of the mapping.
+ */
+static void unmapCheckpointFile(void *base, size_t length) {
+#ifdef _WIN32
+    (void) length;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, length);
+#endif
+}
+
+/**
+ * @brief Checks whether an offset is the start of one of the records of a checkpoint.
+ */
+static _Bool isCheckpointRecord(int64_t offset, int64_t member) {
+    int64_t recordOffset = (int64_t) sizeof(SchedulerCheckpointHeader);
+    return offset >= recordOffset &&
+           offset < recordOffset + member * (int64_t) sizeof(ProConBlock) &&
+           (offset - recordOffset) % (int64_t) sizeof(ProConBlock) == 0;
+}
+
+/**
+ * @brief Validates the records of a mapped checkpoint file before any offset is turned into a pointer.
+ *
+ * Every level is walked from its first record along the stored aftProConBlock offsets. Each record must lie inside the records area,
+ * point back at the record before it, belong to the level by its p_priority (checkpoints of a PriorityRunQueue only),
+ * and keep its p_name inside the string pool, terminated before the end of the file.
+ * The walk must end at the last record of the level, and together the levels must visit exactly member records, so every record is checked once.
+ *
+ * @param base Base address of the mapping.
+ * @param length Length of the mapping.
+ * @return Boolean value indicating whether the checkpoint can be restored safely.
+ */
+static _Bool validateSchedulerCheckpoint(const char *base, size_t length) {
+
+    const SchedulerCheckpointHeader *header = (const SchedulerCheckpointHeader *) base;
+    int64_t recordOffset = (int64_t) sizeof(SchedulerCheckpointHeader);
+    if (header->member < 0 || header->member > ((int64_t) length - recordOffset) / (int64_t) sizeof(ProConBlock)) {
+        return false;
+    }
+    int64_t nameOffset = recordOffset + header->member * (int64_t) sizeof(ProConBlock);
+
+    int64_t visited = 0;
+    for (int level = 0; level < header->levels; ++level) {
+        int64_t offset = header->first[level];
+        int64_t perOffset = 0;
+        if ((offset == 0) != (header->last[level] == 0)) {
+            return false;
+        }
+        while (offset != 0) {
+            if (!isCheckpointRecord(offset, header->member) || visited++ == header->member) {
+                return false;
+            }
+            const ProConBlock *record = (const ProConBlock *) (base + offset);
+            int64_t aftOffset = (int64_t) (intptr_t) record->aftProConBlock;
+            int64_t namePosition = (int64_t) (intptr_t) record->p_name;
+            if ((int64_t) (intptr_t) record->perProConBlock != perOffset ||
+                (aftOffset != 0 && !isCheckpointRecord(aftOffset, header->member))) {
+                return false;
+            }
+            if (header->kind == checkpoint_run_queue ? (int) record->p_priority != level
+                                                     : (unsigned) record->p_priority >= PRIORITY_LEVELS) {
+                return false;
+            }
+            if (namePosition != 0 && (namePosition < nameOffset || namePosition >= (int64_t) length ||
+                                      memchr(base + namePosition, '\0', length - (size_t) namePosition) == NULL)) {
+                return false;
+            }
+            perOffset = offset;
+            offset = aftOffset;
+        }
+        if (perOffset != header->last[level]) {
+            return false;
+        }
+    }
+    return visited == header->member;
+}
+
+/**
+ * @brief Writes a checkpoint file from a prepared header and the links it covers.
+ *
+ * The ProConBlocks of one link are written as consecutive records, so their perProConBlock and aftProConBlock fields
+ * become the offsets of the neighbouring records. Process names are copied into a string pool at the end of the file,
+ * and the p_name field stores the offset into it. Callbacks are not written.
+ *
+ * @param header Pointer to the header, with kind, levels, clock and agingTicks already set.
+ * @param links The links of the checkpoint, header->levels of them.
+ * @param path Path of the checkpoint file, overwritten if it exists.
+ * @return Boolean value indicating whether the checkpoint was written completely.
+ */
+static _Bool writeSchedulerCheckpoint(SchedulerCheckpointHeader *header, ProConBlockLink **links, const char *path) {
+
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL) {
+        return false;
+    }
+
+    memcpy(header->magic, SCHEDULER_CHECKPOINT_MAGIC, sizeof(header->magic));
+    header->blockSize = (int32_t) sizeof(ProConBlock);
+
+    // count records and the size of the string pool
+    int64_t nameBytes = 0;
+    for (int level = 0; level < header->levels; ++level) {
+        ProConBlock *proConBlock = links[level]->headProConBlock->aftProConBlock;
+        while (proConBlock != NULL) {
+            header->member += 1;
+            nameBytes += proConBlock->p_name != NULL ? (int64_t) strlen(proConBlock->p_name) + 1 : 0;
+            proConBlock = proConBlock->aftProConBlock;
+        }
+    }
+    int64_t recordOffset = (int64_t) sizeof(SchedulerCheckpointHeader);
+    int64_t nameOffset = recordOffset + header->member * (int64_t) sizeof(ProConBlock);
+    header->length = nameOffset + nameBytes;
+
+    _Bool flag = fwrite(header, sizeof(SchedulerCheckpointHeader), 1, fp) == 1;
+
+    // records: pointers become offsets from the start of the file
+    int64_t offset = recordOffset;
+    int64_t namePosition = nameOffset;
+    for (int level = 0; level < header->levels && flag; ++level) {
+        ProConBlock *proConBlock = links[level]->headProConBlock->aftProConBlock;
+        if (proConBlock != NULL) {
+            header->first[level] = offset;
+        }
+        while (proConBlock != NULL && flag) {
+            ProConBlock record = *proConBlock;
+            record.perProConBlock = proConBlock->perProConBlock != NULL
+                                    ? (ProConBlock *) (intptr_t) (offset - (int64_t) sizeof(ProConBlock)) : NULL;
+            record.aftProConBlock = proConBlock->aftProConBlock != NULL
+                                    ? (ProConBlock *) (intptr_t) (offset + (int64_t) sizeof(ProConBlock)) : NULL;
+            record.p_name = proConBlock->p_name != NULL ? (char *) (intptr_t) namePosition : NULL;
+            record.callback = NULL;
+            namePosition += proConBlock->p_name != NULL ? (int64_t) strlen(proConBlock->p_name) + 1 : 0;
+
+            flag = fwrite(&record, sizeof(ProConBlock), 1, fp) == 1;
+            header->last[level] = offset;
+            offset += (int64_t) sizeof(ProConBlock);
+            proConBlock = proConBlock->aftProConBlock;
+        }
+    }
+
+    // string pool
+    for (int level = 0; level < header->levels && flag; ++level) {
+        ProConBlock *proConBlock = links[level]->headProConBlock->aftProConBlock;
+        while (proConBlock != NULL && flag) {
+            if (proConBlock->p_name != NULL) {
+                size_t length = strlen(proConBlock->p_name) + 1;
+                flag = fwrite(proConBlock->p_name, 1, length, fp) == length;
+            }
+            proConBlock = proConBlock->aftProConBlock;
+        }
+    }
+
+    // rewrite the header with the first/last offsets of every level
+    if (flag) {
+        flag = fseek(fp, 0, SEEK_SET) == 0 &&
+               fwrite(header, sizeof(SchedulerCheckpointHeader), 1, fp) == 1;
+    }
+    flag = fclose(fp) == 0 && flag;
+    return flag;
+}
+
+/**
+ * @brief Writes the state of a PriorityRunQueue to a checkpoint file.
+ *
+ * This function stores the virtual clock, the aging configuration and every waiting ProConBlock level by level,
+ * see writeSchedulerCheckpoint for the layout of the records.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue to be saved.
+ * @param path Path of the checkpoint file, overwritten if it exists.
+ * @return Boolean value indicating whether the checkpoint was written completely.
+ */
+_Bool checkpointPriorityRunQueue(PriorityRunQueue *runQueue, const char *path) {
+
+    SchedulerCheckpointHeader header;
+    memset(&header, 0, sizeof(SchedulerCheckpointHeader));
+    header.kind = checkpoint_run_queue;
+    header.levels = PRIORITY_LEVELS;
+    header.clock = runQueue->clock;
+    header.agingTicks = runQueue->agingTicks;
+    return writeSchedulerCheckpoint(&header, runQueue->levels, path);
+}
+
+/**
+ * @brief Writes the ready queue of a ProConBlockLink to a checkpoint file.
+ *
+ * This function saves the waiting ProConBlocks of the link-based policies (first come first serve, shortest job next,
+ * priority and round robin) in their current order, as a checkpoint with a single level.
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink to be saved.
+ * @param path Path of the checkpoint file, overwritten if it exists.
+ * @return Boolean value indicating whether the checkpoint was written completely.
+ */
+_Bool checkpointProConBlockLink(ProConBlockLink *proConBlockLink, const char *path) {
+
+    SchedulerCheckpointHeader header;
+    memset(&header, 0, sizeof(SchedulerCheckpointHeader));
+    header.kind = checkpoint_link;
+    header.levels = 1;
+    return writeSchedulerCheckpoint(&header, &proConBlockLink, path);
+}
+
+/**
+ * @brief Collects the links of a restored SchedulerSnapshot.
+ *
+ * @param snapshot Pointer to the SchedulerSnapshot.
+ * @param links Output array receiving the links, at least PRIORITY_LEVELS long.
+ * @return Number of links of the snapshot.
+ */
+static int snapshotLinks(SchedulerSnapshot *snapshot, ProConBlockLink **links) {
+
+    if (snapshot->runQueue != NULL) {
+        for (int level = 0; level < PRIORITY_LEVELS; ++level) {
+            links[level] = snapshot->runQueue->levels[level];
+        }
+        return PRIORITY_LEVELS;
+    }
+    links[0] = snapshot->proConBlockLink;
+    return 1;
+}
+
+/**
+ * @brief Checks whether a ProConBlock lives in the mapping of a SchedulerSnapshot.
+ */
+static inline _Bool isSnapshotProConBlock(SchedulerSnapshot *snapshot, ProConBlock *proConBlock) {
+    char *begin = snapshot->base;
+    return (char *) proConBlock >= begin && (char *) proConBlock < begin + snapshot->length;
+}
+
+/**
+ * @brief Maps a checkpoint file of the given kind and restores its links in place.
+ *
+ * This function maps the checkpoint file and validates its header and every record, see validateSchedulerCheckpoint.
+ * A single fix-up pass over the contiguous records turns the stored offsets back into pointers, assigns the callback
+ * and registers every ProConBlock in the p_id index of its link. The records are used in place, so no ProConBlock is allocated or re-inserted.
+ * The links of the snapshot are then pointed at the first and last record of every level.
+ *
+ * @param path Path of the checkpoint file.
+ * @param kind The kind of checkpoint expected in the file.
+ * @param callBack The callback function assigned to every restored ProConBlock.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the restored SchedulerSnapshot, NULL if the file is missing, of another kind, truncated or corrupt.
+ */
+static SchedulerSnapshot *
+restoreSchedulerCheckpoint(const char *path, SchedulerCheckpointKind kind, CallBack callBack, Allocator *allocator) {
+
+    size_t length = 0;
+    char *base = mapCheckpointFile(path, &length);
+    if (base == NULL) {
+        return NULL;
+    }
+
+    SchedulerCheckpointHeader *header = (SchedulerCheckpointHeader *) base;
+    if (length < sizeof(SchedulerCheckpointHeader) ||
+        memcmp(header->magic, SCHEDULER_CHECKPOINT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->blockSize != (int32_t) sizeof(ProConBlock) ||
+        header->kind != (int32_t) kind ||
+        header->levels != (kind == checkpoint_run_queue ? PRIORITY_LEVELS : 1) ||
+        header->length != (int64_t) length ||
+        !validateSchedulerCheckpoint(base, length)) {
+        unmapCheckpointFile(base, length);
+        return NULL;
+    }
+
+    SchedulerSnapshot *snapshot = allocator->allocate(allocator, sizeof(SchedulerSnapshot));
+    assert(snapshot != NULL);
+    snapshot->base = base;
+    snapshot->length = length;
+    snapshot->runQueue = NULL;
+    snapshot->proConBlockLink = NULL;
+    if (kind == checkpoint_run_queue) {
+        snapshot->runQueue = initPriorityRunQueue(header->agingTicks, allocator);
+        snapshot->runQueue->clock = header->clock;
+        snapshot->runQueue->size = (int) header->member;
+    } else {
+        snapshot->proConBlockLink = initProConBlockLink(allocator);
+    }
+    ProConBlockLink *links[PRIORITY_LEVELS];
+    snapshotLinks(snapshot, links);
+
+    // fix-up pass: offset -> pointer
+    ProConBlock *records = (ProConBlock *) (base + sizeof(SchedulerCheckpointHeader));
+    for (int64_t i = 0; i < header->member; ++i) {
+        ProConBlock *record = &records[i];
+        if (record->perProConBlock != NULL) {
+            record->perProConBlock = (ProConBlock *) (base + (intptr_t) record->perProConBlock);
+        }
+        if (record->aftProConBlock != NULL) {
+            record->aftProConBlock = (ProConBlock *) (base + (intptr_t) record->aftProConBlock);
+        }
+        if (record->p_name != NULL) {
+            record->p_name = base + (intptr_t) record->p_name;
+        }
+        record->callback = callBack;
+        ProConBlockLink *link = kind == checkpoint_run_queue ? links[record->p_priority] : links[0];
+        appendProcess(link->index, record->p_id, record);
+    }
+
+    for (int level = 0; level < header->levels; ++level) {
+        if (header->first[level] != 0) {
+            links[level]->headProConBlock->aftProConBlock = (ProConBlock *) (base + header->first[level]);
+            links[level]->lastProConBlock = (ProConBlock *) (base + header->last[level]);
+        }
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Restores a PriorityRunQueue from a checkpoint file.
+ *
+ * The restored PriorityRunQueue gets the virtual clock and the aging configuration of the checkpoint, see restoreSchedulerCheckpoint.
+ *
+ * @param path Path of the checkpoint file.
+ * @param callBack The callback function assigned to every restored ProConBlock.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the restored SchedulerSnapshot, NULL if the file is missing, truncated or corrupt.
+ */
+SchedulerSnapshot *restoreSchedulerSnapshot(const char *path, CallBack callBack, Allocator *allocator) {
+
+    return restoreSchedulerCheckpoint(path, checkpoint_run_queue, callBack, allocator);
+}
+
+/**
+ * @brief Restores a ProConBlockLink from a checkpoint file written by checkpointProConBlockLink.
+ *
+ * The restored ProConBlockLink keeps the order of the saved link. Policies that destroy finished ProConBlocks, such as executeOver,
+ * must only run on it after every ProConBlock was taken over with detachSnapshotProConBlock.
+ *
+ * @param path Path of the checkpoint file.
+ * @param callBack The callback function assigned to every restored ProConBlock.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the restored SchedulerSnapshot, NULL if the file is missing, truncated or corrupt.
+ */
+SchedulerSnapshot *restoreProConBlockLinkSnapshot(const char *path, CallBack callBack, Allocator *allocator) {
+
+    return restoreSchedulerCheckpoint(path, checkpoint_link, callBack, allocator);
+}
+
+/**
+ * @brief Copies a restored ProConBlock out of the mapping, so the caller owns it.
+ *
+ * A ProConBlock that lives in the mapping is copied into memory of the allocator and can then be destroyed with destroyProConBlock.
+ * If it is still queued in the snapshot, the copy takes its place in the link and in the p_id index; a dequeued one is returned unlinked.
+ * ProConBlocks that do not live in the mapping, for example enqueued after the restore, are returned unchanged.
+ * As everywhere in the scheduler the process name is borrowed: it stays in the mapping and is valid until releaseSchedulerSnapshot.
+ *
+ * @param snapshot Pointer to the SchedulerSnapshot the ProConBlock was restored from.
+ * @param proConBlock Pointer to the ProConBlock to be taken over.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the ProConBlock owned by the caller.
+ */
+ProConBlock *detachSnapshotProConBlock(SchedulerSnapshot *snapshot, ProConBlock *proConBlock, Allocator *allocator) {
+
+    if (!isSnapshotProConBlock(snapshot, proConBlock)) {
+        return proConBlock;
+    }
+    ProConBlock *copy = allocator->allocate(allocator, sizeof(ProConBlock));
+    assert(copy != NULL);
+    *copy = *proConBlock;
+
+    ProConBlockLink *link = snapshot->runQueue != NULL
+                            ? snapshot->runQueue->levels[proConBlock->p_priority] : snapshot->proConBlockLink;
+    if (removeProcessValue(link->index, proConBlock->p_id, proConBlock)) {
+        // still queued: [per] <-> [copy] <-> [aft]
+        appendProcess(link->index, copy->p_id, copy);
+        if (copy->perProConBlock != NULL) {
+            copy->perProConBlock->aftProConBlock = copy;
+        } else {
+            link->headProConBlock->aftProConBlock = copy;
+        }
+        if (copy->aftProConBlock != NULL) {
+            copy->aftProConBlock->perProConBlock = copy;
+        } else {
+            link->lastProConBlock = copy;
+        }
+    } else {
+        copy->perProConBlock = NULL;
+        copy->aftProConBlock = NULL;
+    }
+    return copy;
+}
+
+/**
+ * @brief Releases a restored SchedulerSnapshot.
+ *
+ * This function empties every link of the restored PriorityRunQueue or ProConBlockLink. ProConBlocks that live in the mapping are only unlinked,
+ * ProConBlocks enqueued or detached after the restore were allocated normally and are destroyed.
+ * It then destroys the PriorityRunQueue or ProConBlockLink, unmaps the checkpoint file and deallocates the SchedulerSnapshot structure.
+ *
+ * @param snapshot Pointer to the SchedulerSnapshot to be released.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void releaseSchedulerSnapshot(SchedulerSnapshot *snapshot, Allocator *allocator) {
+
+    if (snapshot != NULL) {
+        ProConBlockLink *links[PRIORITY_LEVELS];
+        int count = snapshotLinks(snapshot, links);
+        for (int level = 0; level < count; ++level) {
+            ProConBlock *proConBlock = links[level]->headProConBlock->aftProConBlock;
+            while (proConBlock != NULL) {
+                ProConBlock *aftProConBlock = proConBlock->aftProConBlock;
+                detachProConBlockFromLink(links[level], proConBlock);
+                if (!isSnapshotProConBlock(snapshot, proConBlock)) {
+                    destroyProConBlock(proConBlock, allocator);
+                }
+                proConBlock = aftProConBlock;
+            }
+        }
+        if (snapshot->runQueue != NULL) {
+            destroyPriorityRunQueue(snapshot->runQueue, allocator);
+        } else {
+            destroyProConBlockLink(snapshot->proConBlockLink, allocator);
+        }
+        unmapCheckpointFile(snapshot->base, snapshot->length);
+        allocator->deallocate(allocator, snapshot, sizeof(SchedulerSnapshot));
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ User: Redskaber
+ Date: 2024/1/14
+ Time: 16:20
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SCHEDULER_CHECKPOINT_H
+#define OPERATORSYSTEM_SCHEDULER_CHECKPOINT_H
+/*
+ * 调度器状态检查点
+        文件布局: [SchedulerCheckpointHeader][ProConBlock 记录...][进程名字符串池]
+        记录中的 perProConBlock / aftProConBlock / p_name 保存为相对文件起始处的偏移(0 表示 NULL),
+        恢复时 mmap 整个文件(写时复制), 再做一遍偏移 -> 指针的修正, 不需要逐个重新创建/插入进程。
+
+        恢复出的 ProConBlock 位于映射内存中, 只能通过 releaseSchedulerSnapshot 释放,
+        不能对它们调用 destroyProConBlock; 需要单独持有时用 detachSnapshotProConBlock 复制出来。
+        callback 不能持久化, 恢复时统一设置。
+        检查点可以保存 PriorityRunQueue(虚拟时钟、老化配置、各级等待的进程), 也可以保存普通的 ProConBlockLink
+        (FCFS / SJN / 优先级 / 时间片轮转调度的就绪队列); 正在运行的进程、统计与跟踪不在其中。
+        恢复前校验每条记录的偏移、优先级和进程名, 文件被截断或损坏时返回 NULL, 不会越界访问映射。
+ */
+
+#include <stdint.h>
+#include "../run_queue/priority_run_queue.h"
+
+#define SCHEDULER_CHECKPOINT_MAGIC "OSCKPT02"
+
+typedef enum SchedulerCheckpointKind {
+    checkpoint_run_queue,   // PriorityRunQueue, 每个优先级一条链
+    checkpoint_link,        // 普通 ProConBlockLink, 只有一条链
+} SchedulerCheckpointKind;
+
+typedef struct SchedulerCheckpointHeader {
+    char magic[8];
+    int32_t blockSize;      // sizeof(ProConBlock), 防止不同编译产物之间误用
+    int32_t levels;
+    int32_t kind;
+    int32_t reserved;
+    int64_t clock;
+    int64_t agingTicks;
+    int64_t member;
+    int64_t first[PRIORITY_LEVELS];
+    int64_t last[PRIORITY_LEVELS];
+    int64_t length;
+} SchedulerCheckpointHeader;
+
+typedef struct SchedulerSnapshot {
+    void *base;
+    size_t length;
+    PriorityRunQueue *runQueue;             // checkpoint_run_queue, 否则为 NULL
+    ProConBlockLink *proConBlockLink;       // checkpoint_link, 否则为 NULL
+} SchedulerSnapshot;
+
+
+extern _Bool checkpointPriorityRunQueue(PriorityRunQueue *runQueue, const char *path);
+
+extern _Bool checkpointProConBlockLink(ProConBlockLink *proConBlockLink, const char *path);
+
+extern SchedulerSnapshot *restoreSchedulerSnapshot(const char *path, CallBack callBack, Allocator *allocator);
+
+extern SchedulerSnapshot *restoreProConBlockLinkSnapshot(const char *path, CallBack callBack, Allocator *allocator);
+
+extern ProConBlock *detachSnapshotProConBlock(SchedulerSnapshot *snapshot, ProConBlock *proConBlock, Allocator *allocator);
+
+extern void releaseSchedulerSnapshot(SchedulerSnapshot *snapshot, Allocator *allocator);
+
+#endif //OPERATORSYSTEM_SCHEDULER_CHECKPOINT_H
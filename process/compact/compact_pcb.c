@@ -0,0 +1,308 @@
+/*
+ User: Redskaber
+ Date: 2024/1/20
+ Time: 11:17
+*/
+#include "compact_pcb.h"
+
+
+/**
+ * @brief Converts a time into integer ticks, rounded to the nearest tick.
+ *
+ * The result saturates instead of wrapping around: negative times (and NaN) become 0,
+ * times beyond COMPACT_TICKS_MAX ticks become COMPACT_TICKS_MAX, so a huge job never looks like a short one.
+ *
+ * @param time The time in time units.
+ * @return The time in ticks, within [0, COMPACT_TICKS_MAX].
+ */
+uint32_t toCompactTicks(double time) {
+
+    double ticks = time * COMPACT_TICKS_PER_UNIT + 0.5;
+    if (!(ticks >= 0)) {
+        return 0;
+    }
+    return ticks >= (double) COMPACT_TICKS_MAX ? COMPACT_TICKS_MAX : (uint32_t) ticks;
+}
+
+/**
+ * @brief Converts the hot fields of a ProConBlock into a CompactProConBlock.
+ *
+ * Times are rounded to integer ticks (COMPACT_TICKS_PER_UNIT per time unit) by toCompactTicks, state and priority are narrowed to one byte.
+ * The link fields are set to COMPACT_NIL; they are indexes chosen by the container of the CompactProConBlock.
+ *
+ * @param proConBlock Pointer to the ProConBlock to be converted.
+ * @param cold Index of the ProConBlockCold holding the name and callback of the ProConBlock.
+ * @param compact Pointer to the CompactProConBlock to be filled.
+ */
+void compactProConBlock(ProConBlock *proConBlock, uint32_t cold, CompactProConBlock *compact) {
+
+    compact->p_id = proConBlock->p_id;
+    compact->p_execute_ticks = toCompactTicks(proConBlock->p_execute_time);
+    compact->p_total_ticks = toCompactTicks(proConBlock->p_total_time);
+    compact->p_ready_tick = (uint32_t) proConBlock->p_ready_tick;
+    compact->perProConBlock = COMPACT_NIL;
+    compact->aftProConBlock = COMPACT_NIL;
+    compact->cold = cold;
+    compact->p_state = (uint8_t) proConBlock->p_state;
+    compact->p_priority = (uint8_t) proConBlock->p_priority;
+    compact->reserved = 0;
+}
+
+/**
+ * @brief Allocates the columns of a ProConBlockTable for a given capacity.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param capacity The number of rows.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+static void allocateColumns(ProConBlockTable *table, int capacity, Allocator *allocator) {
+
+    table->p_id = allocator->allocate(allocator, capacity * sizeof(int32_t));
+    table->p_state = allocator->allocate(allocator, capacity * sizeof(uint8_t));
+    table->p_priority = allocator->allocate(allocator, capacity * sizeof(uint8_t));
+    table->p_execute_ticks = allocator->allocate(allocator, capacity * sizeof(uint32_t));
+    table->p_total_ticks = allocator->allocate(allocator, capacity * sizeof(uint32_t));
+    table->p_ready_tick = allocator->allocate(allocator, capacity * sizeof(uint32_t));
+    table->cold = allocator->allocate(allocator, capacity * sizeof(ProConBlockCold));
+    assert(table->p_id != NULL && table->p_state != NULL && table->p_priority != NULL &&
+           table->p_execute_ticks != NULL && table->p_total_ticks != NULL && table->p_ready_tick != NULL &&
+           table->cold != NULL);
+    table->capacity = capacity;
+}
+
+/**
+ * @brief Doubles the capacity of a ProConBlockTable.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+static void upCapacity(ProConBlockTable *table, Allocator *allocator) {
+
+    int oldCapacity = table->capacity;
+    int newCapacity = oldCapacity << 1;
+    table->p_id = allocator->reallocate(allocator, table->p_id,
+                                        oldCapacity * sizeof(int32_t), newCapacity * sizeof(int32_t));
+    table->p_state = allocator->reallocate(allocator, table->p_state,
+                                           oldCapacity * sizeof(uint8_t), newCapacity * sizeof(uint8_t));
+    table->p_priority = allocator->reallocate(allocator, table->p_priority,
+                                              oldCapacity * sizeof(uint8_t), newCapacity * sizeof(uint8_t));
+    table->p_execute_ticks = allocator->reallocate(allocator, table->p_execute_ticks,
+                                                   oldCapacity * sizeof(uint32_t), newCapacity * sizeof(uint32_t));
+    table->p_total_ticks = allocator->reallocate(allocator, table->p_total_ticks,
+                                                 oldCapacity * sizeof(uint32_t), newCapacity * sizeof(uint32_t));
+    table->p_ready_tick = allocator->reallocate(allocator, table->p_ready_tick,
+                                                oldCapacity * sizeof(uint32_t), newCapacity * sizeof(uint32_t));
+    table->cold = allocator->reallocate(allocator, table->cold,
+                                        oldCapacity * sizeof(ProConBlockCold), newCapacity * sizeof(ProConBlockCold));
+    table->capacity = newCapacity;
+}
+
+/**
+ * @brief Initializes an empty ProConBlockTable.
+ *
+ * @param capacity The initial number of rows, at least PRO_CON_BLOCK_TABLE_INIT_SIZE.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created ProConBlockTable structure.
+ */
+ProConBlockTable *initProConBlockTable(int capacity, Allocator *allocator) {
+
+    ProConBlockTable *table = allocator->allocate(allocator, sizeof(ProConBlockTable));
+    assert(table != NULL);
+    allocateColumns(table, capacity > PRO_CON_BLOCK_TABLE_INIT_SIZE ? capacity : PRO_CON_BLOCK_TABLE_INIT_SIZE, allocator);
+    table->size = 0;
+    return table;
+}
+
+/**
+ * @brief Destroys a ProConBlockTable structure and all its columns.
+ *
+ * @param table Pointer to the ProConBlockTable structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyProConBlockTable(ProConBlockTable *table, Allocator *allocator) {
+
+    if (table != NULL) {
+        int capacity = table->capacity;
+        allocator->deallocate(allocator, table->p_id, capacity * sizeof(int32_t));
+        allocator->deallocate(allocator, table->p_state, capacity * sizeof(uint8_t));
+        allocator->deallocate(allocator, table->p_priority, capacity * sizeof(uint8_t));
+        allocator->deallocate(allocator, table->p_execute_ticks, capacity * sizeof(uint32_t));
+        allocator->deallocate(allocator, table->p_total_ticks, capacity * sizeof(uint32_t));
+        allocator->deallocate(allocator, table->p_ready_tick, capacity * sizeof(uint32_t));
+        allocator->deallocate(allocator, table->cold, capacity * sizeof(ProConBlockCold));
+        allocator->deallocate(allocator, table, sizeof(ProConBlockTable));
+    }
+}
+
+/**
+ * @brief Appends a ProConBlock to a ProConBlockTable.
+ *
+ * The hot fields are converted as in compactProConBlock and written to their columns; name and callback go to the cold column.
+ * The ProConBlock itself is not referenced afterwards.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param proConBlock Pointer to the ProConBlock to be appended.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return The row of the new entry.
+ */
+int pushProConBlockTable(ProConBlockTable *table, ProConBlock *proConBlock, Allocator *allocator) {
+
+    if (table->size == table->capacity) {
+        upCapacity(table, allocator);
+    }
+    int row = table->size++;
+    table->p_id[row] = proConBlock->p_id;
+    table->p_state[row] = (uint8_t) proConBlock->p_state;
+    table->p_priority[row] = (uint8_t) proConBlock->p_priority;
+    table->p_execute_ticks[row] = toCompactTicks(proConBlock->p_execute_time);
+    table->p_total_ticks[row] = toCompactTicks(proConBlock->p_total_time);
+    table->p_ready_tick[row] = (uint32_t) proConBlock->p_ready_tick;
+    table->cold[row].p_name = proConBlock->p_name;
+    table->cold[row].callback = proConBlock->callback;
+    return row;
+}
+
+/**
+ * @brief Appends every ProConBlock of a ProConBlockLink to a ProConBlockTable, in link order.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param proConBlockLink Pointer to the ProConBlockLink to be loaded.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void loadProConBlockTable(ProConBlockTable *table, ProConBlockLink *proConBlockLink, Allocator *allocator) {
+
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        pushProConBlockTable(table, proConBlock, allocator);
+        proConBlock = proConBlock->aftProConBlock;
+    }
+}
+
+/**
+ * @brief Gathers one row of a ProConBlockTable into a CompactProConBlock.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param row The row to be read.
+ * @param compact Pointer to the CompactProConBlock to be filled; its cold index is the row.
+ */
+void readProConBlockTable(ProConBlockTable *table, int row, CompactProConBlock *compact) {
+
+    assert(row >= 0 && row < table->size);
+    compact->p_id = table->p_id[row];
+    compact->p_execute_ticks = table->p_execute_ticks[row];
+    compact->p_total_ticks = table->p_total_ticks[row];
+    compact->p_ready_tick = table->p_ready_tick[row];
+    compact->perProConBlock = COMPACT_NIL;
+    compact->aftProConBlock = COMPACT_NIL;
+    compact->cold = (uint32_t) row;
+    compact->p_state = table->p_state[row];
+    compact->p_priority = table->p_priority[row];
+    compact->reserved = 0;
+}
+
+/**
+ * @brief Removes a row from a ProConBlockTable in O(1).
+ *
+ * The last row is moved into the removed one, so the rows after it are not shifted; the order of the table is not preserved.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param row The row to be removed.
+ */
+void removeProConBlockTable(ProConBlockTable *table, int row) {
+
+    assert(row >= 0 && row < table->size);
+    int last = --table->size;
+    if (row != last) {
+        table->p_id[row] = table->p_id[last];
+        table->p_state[row] = table->p_state[last];
+        table->p_priority[row] = table->p_priority[last];
+        table->p_execute_ticks[row] = table->p_execute_ticks[last];
+        table->p_total_ticks[row] = table->p_total_ticks[last];
+        table->p_ready_tick[row] = table->p_ready_tick[last];
+        table->cold[row] = table->cold[last];
+    }
+}
+
+/**
+ * @brief Executes a row for a number of ticks.
+ *
+ * Like runningProConBlockTask, a row that reaches its total time becomes suspended_ready, otherwise it becomes suspended_blocked.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @param row The row to be executed.
+ * @param ticks The number of ticks executed.
+ * @return Boolean value indicating whether the row has finished.
+ */
+_Bool runProConBlockTable(ProConBlockTable *table, int row, uint32_t ticks) {
+
+    uint32_t remain = table->p_total_ticks[row] - table->p_execute_ticks[row];
+    if (ticks >= remain) {
+        table->p_execute_ticks[row] = table->p_total_ticks[row];
+        table->p_state[row] = suspended_ready;
+        return true;
+    }
+    table->p_execute_ticks[row] += ticks;
+    table->p_state[row] = suspended_blocked;
+    return false;
+}
+
+/**
+ * @brief Finds the shortest job of a ProConBlockTable.
+ *
+ * This function selects like shortestJobNext: the smallest total time, earlier rows first, skipping finished rows.
+ * The first pass reads only the state and total time columns and keeps a running minimum without branches,
+ * so the compiler can vectorise it and the scan is bound by memory bandwidth. The second pass stops at the first row with that minimum.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @return The row of the shortest job, -1 if every row has finished.
+ */
+int shortestJobFromTable(ProConBlockTable *table) {
+
+    const uint8_t *state = table->p_state;
+    const uint32_t *total = table->p_total_ticks;
+    int size = table->size;
+
+    uint32_t best = UINT32_MAX;
+    for (int row = 0; row < size; ++row) {
+        uint32_t key = state[row] == suspended_ready || state[row] == terminated ? UINT32_MAX : total[row];
+        best = key < best ? key : best;
+    }
+    for (int row = 0; row < size; ++row) {
+        if (total[row] == best && state[row] != suspended_ready && state[row] != terminated) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Finds the job with the highest priority of a ProConBlockTable.
+ *
+ * This function selects like priorityScheduling: the highest priority, earlier rows first, skipping finished rows.
+ * It scans the one-byte state and priority columns in two branch free passes, as shortestJobFromTable does.
+ *
+ * @param table Pointer to the ProConBlockTable.
+ * @return The row of the selected job, -1 if every row has finished.
+ */
+int highestPriorityFromTable(ProConBlockTable *table) {
+
+    const uint8_t *state = table->p_state;
+    const uint8_t *priority = table->p_priority;
+    int size = table->size;
+
+    // key 0 marks a finished row
+    uint8_t best = 0;
+    for (int row = 0; row < size; ++row) {
+        uint8_t key = state[row] == suspended_ready || state[row] == terminated ? 0 : (uint8_t) (priority[row] + 1);
+        best = key > best ? key : best;
+    }
+    if (best == 0) {
+        return -1;
+    }
+    for (int row = 0; row < size; ++row) {
+        if (priority[row] + 1 == best && state[row] != suspended_ready && state[row] != terminated) {
+            return row;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,88 @@
+/*
+ User: Redskaber
+ Date: 2024/1/20
+ Time: 11:17
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_COMPACT_PCB_H
+#define OPERATORSYSTEM_COMPACT_PCB_H
+/*
+ * 紧凑进程控制块(冷热分离)
+        ProConBlock 把调度常用字段(状态、优先级、时间、链接)和很少访问的字段(进程名、callback)放在一起,
+        时间使用 8 字节 double, 状态/优先级使用 4 字节枚举。
+
+        CompactProConBlock: 只保留热字段, 时间换成整数 tick, 状态/优先级 1 字节, 链接换成 32 位下标, 共 32 字节(一条缓存行两个)。
+        ProConBlockCold:    进程名与 callback, 按同一下标放在单独的数组里。
+        ProConBlockTable:   列式(SoA)进程表, 每个字段一段连续数组,
+                            SJN / 优先级 选择只顺序扫描 1~2 列, 受内存带宽限制而不是指针追逐。
+ */
+
+#include <stdint.h>
+#include "../process_scheduling.h"
+
+#define COMPACT_TICKS_PER_UNIT 1000     // 1.0 个时间单位 = 1000 tick
+#define COMPACT_NIL UINT32_MAX
+#define PRO_CON_BLOCK_TABLE_INIT_SIZE 16
+
+#define COMPACT_TICKS_MAX (UINT32_MAX - 1)   // 超出的时间饱和到这里(约 429 万个时间单位), UINT32_MAX 留给已完成的行
+#define fromCompactTicks(ticks) ((double) (ticks) / COMPACT_TICKS_PER_UNIT)
+
+// 热字段
+typedef struct CompactProConBlock {
+    int32_t p_id;
+    uint32_t p_execute_ticks;
+    uint32_t p_total_ticks;
+    uint32_t p_ready_tick;
+    uint32_t perProConBlock;    // 下标, COMPACT_NIL 表示没有
+    uint32_t aftProConBlock;
+    uint32_t cold;              // ProConBlockCold 下标
+    uint8_t p_state;            // ProcessState
+    uint8_t p_priority;         // ProcessPriority
+    uint16_t reserved;
+} CompactProConBlock;
+
+_Static_assert(sizeof(CompactProConBlock) == 32, "CompactProConBlock must stay half a cache line");
+
+// 冷字段
+typedef struct ProConBlockCold {
+    char *p_name;
+    CallBack callback;
+} ProConBlockCold;
+
+// 列式进程表
+typedef struct ProConBlockTable {
+    int32_t *p_id;
+    uint8_t *p_state;
+    uint8_t *p_priority;
+    uint32_t *p_execute_ticks;
+    uint32_t *p_total_ticks;
+    uint32_t *p_ready_tick;
+    ProConBlockCold *cold;
+    int size;
+    int capacity;
+} ProConBlockTable;
+
+
+extern void compactProConBlock(ProConBlock *proConBlock, uint32_t cold, CompactProConBlock *compact);
+
+extern ProConBlockTable *initProConBlockTable(int capacity, Allocator *allocator);
+
+extern void destroyProConBlockTable(ProConBlockTable *table, Allocator *allocator);
+
+extern int pushProConBlockTable(ProConBlockTable *table, ProConBlock *proConBlock, Allocator *allocator);
+
+extern void loadProConBlockTable(ProConBlockTable *table, ProConBlockLink *proConBlockLink, Allocator *allocator);
+
+extern void readProConBlockTable(ProConBlockTable *table, int row, CompactProConBlock *compact);
+
+extern void removeProConBlockTable(ProConBlockTable *table, int row);
+
+extern uint32_t toCompactTicks(double time);
+
+extern _Bool runProConBlockTable(ProConBlockTable *table, int row, uint32_t ticks);
+
+extern int shortestJobFromTable(ProConBlockTable *table);
+
+extern int highestPriorityFromTable(ProConBlockTable *table);
+
+#endif //OPERATORSYSTEM_COMPACT_PCB_H
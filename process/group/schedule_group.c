@@ -0,0 +1,399 @@
+/*
+ User: Redskaber
+ Date: 2024/1/23
+ Time: 19:48
+*/
+#include "schedule_group.h"
+
+
+typedef struct RefusedScheduleEntity {
+    ProConBlock *proConBlock;
+    ScheduleGroup *group;
+} RefusedScheduleEntity;
+
+
+/**
+ * @brief Swaps two heap positions of a ScheduleGroup and updates their heap indexes.
+ */
+static inline void swapEntity(ScheduleGroup *group, int i, int j) {
+    ScheduleEntity *temp = group->heap[i];
+    group->heap[i] = group->heap[j];
+    group->heap[j] = temp;
+    group->heap[i]->heapIndex = i;
+    group->heap[j]->heapIndex = j;
+}
+
+/**
+ * @brief Moves a heap entry towards the root while its vruntime is smaller than its parent's.
+ */
+static void siftUp(ScheduleGroup *group, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (group->heap[parent]->vruntime <= group->heap[i]->vruntime) {
+            break;
+        }
+        swapEntity(group, i, parent);
+        i = parent;
+    }
+}
+
+/**
+ * @brief Moves a heap entry towards the leaves while a child has a smaller vruntime.
+ */
+static void siftDown(ScheduleGroup *group, int i) {
+    while (true) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < group->size && group->heap[left]->vruntime < group->heap[smallest]->vruntime) {
+            smallest = left;
+        }
+        if (right < group->size && group->heap[right]->vruntime < group->heap[smallest]->vruntime) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        swapEntity(group, i, smallest);
+        i = smallest;
+    }
+}
+
+/**
+ * @brief Inserts a ScheduleEntity into the heap of a ScheduleGroup, growing the heap when full.
+ */
+static void heapPush(ScheduleGroup *group, ScheduleEntity *entity, Allocator *allocator) {
+    if (group->size == group->capacity) {
+        group->heap = allocator->reallocate(allocator, group->heap, group->capacity * sizeof(ScheduleEntity *),
+                                            2 * group->capacity * sizeof(ScheduleEntity *));
+        group->capacity *= 2;
+    }
+    entity->heapIndex = group->size;
+    group->heap[group->size++] = entity;
+    siftUp(group, entity->heapIndex);
+}
+
+/**
+ * @brief Removes a ScheduleEntity from any position of the heap of a ScheduleGroup in O(log n).
+ */
+static void heapRemove(ScheduleGroup *group, ScheduleEntity *entity) {
+    int i = entity->heapIndex;
+    int last = --group->size;
+    if (i != last) {
+        ScheduleEntity *moved = group->heap[last];
+        swapEntity(group, i, last);
+        siftDown(group, i);
+        siftUp(group, moved->heapIndex);
+    }
+    entity->heapIndex = -1;
+}
+
+/**
+ * @brief Advances the minVruntime of a ScheduleGroup to the vruntime of its leftmost entity; it never moves backwards.
+ */
+static inline void updateMinVruntime(ScheduleGroup *group) {
+    if (group->size > 0 && group->heap[0]->vruntime > group->minVruntime) {
+        group->minVruntime = group->heap[0]->vruntime;
+    }
+}
+
+/**
+ * @brief Returns the root of the tree of a ScheduleGroup.
+ */
+static ScheduleGroup *rootOf(ScheduleGroup *group) {
+    while (group->entity.parent != NULL) {
+        group = group->entity.parent;
+    }
+    return group;
+}
+
+/**
+ * @brief Initializes a ScheduleGroup and attaches it to its parent.
+ *
+ * This function allocates a ScheduleGroup with an empty heap. A root group (parent NULL) also owns the p_id index of the whole tree.
+ * The group only enters the heap of its parent once it holds a ready process, so empty groups are never picked.
+ *
+ * @param name The name of the ScheduleGroup.
+ * @param weight The share of the ScheduleGroup relative to its siblings; a non-positive weight falls back to SCHEDULE_NICE_0_WEIGHT.
+ * @param parent Pointer to the parent ScheduleGroup, NULL for a root group.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created ScheduleGroup structure.
+ */
+ScheduleGroup *initScheduleGroup(char *name, int weight, ScheduleGroup *parent, Allocator *allocator) {
+
+    ScheduleGroup *group = allocator->allocate(allocator, sizeof(ScheduleGroup));
+    assert(group != NULL);
+    group->heap = allocator->allocate(allocator, SCHEDULE_GROUP_HEAP_INIT_SIZE * sizeof(ScheduleEntity *));
+    assert(group->heap != NULL);
+
+    group->entity.vruntime = parent != NULL ? parent->minVruntime : 0;
+    group->entity.weight = weight > 0 ? weight : SCHEDULE_NICE_0_WEIGHT;
+    group->entity.heapIndex = -1;
+    group->entity.parent = parent;
+    group->entity.group = group;
+    group->entity.proConBlock = NULL;
+
+    group->name = name;
+    group->size = 0;
+    group->capacity = SCHEDULE_GROUP_HEAP_INIT_SIZE;
+    group->minVruntime = group->entity.vruntime;
+    group->member = 0;
+    group->firstChild = NULL;
+    group->nextSibling = NULL;
+    group->index = parent == NULL ? createHashMapProcess(HASH_MAP_PROCESS_INIT_SIZE) : NULL;
+
+    if (parent != NULL) {
+        group->nextSibling = parent->firstChild;
+        parent->firstChild = group;
+    }
+    return group;
+}
+
+/**
+ * @brief Destroys a ScheduleGroup subtree without touching the p_id index.
+ */
+static void destroyGroupTree(ScheduleGroup *group, Allocator *allocator) {
+
+    // 堆中的子组实体嵌在子组内, 先释放进程实体再递归子组
+    for (int i = 0; i < group->size; ++i) {
+        ScheduleEntity *entity = group->heap[i];
+        if (entity->proConBlock != NULL) {
+            entity->proConBlock->aftProConBlock = NULL;
+            destroyProConBlock(entity->proConBlock, allocator);
+            allocator->deallocate(allocator, entity, sizeof(ScheduleEntity));
+        }
+    }
+    ScheduleGroup *child = group->firstChild;
+    while (child != NULL) {
+        ScheduleGroup *nextSibling = child->nextSibling;
+        destroyGroupTree(child, allocator);
+        child = nextSibling;
+    }
+    allocator->deallocate(allocator, group->heap, group->capacity * sizeof(ScheduleEntity *));
+    allocator->deallocate(allocator, group, sizeof(ScheduleGroup));
+}
+
+/**
+ * @brief Destroys a tree of ScheduleGroups.
+ *
+ * This function destroys every ScheduleGroup below the root, including the ProConBlocks still waiting in them, and then the root and its p_id index.
+ *
+ * @param group Pointer to the root ScheduleGroup to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyScheduleGroup(ScheduleGroup *group, Allocator *allocator) {
+
+    if (group != NULL) {
+        assert(group->entity.parent == NULL);
+        HashMapProcess *index = group->index;
+        destroyGroupTree(group, allocator);
+        destroyHashMapProcess(index);
+    }
+}
+
+/**
+ * @brief Adds a ready ProConBlock to a ScheduleGroup.
+ *
+ * The ProConBlock gets a ScheduleEntity weighted by its priority that starts at the minVruntime of the group.
+ * Every ancestor counts one more ready process; a group that had none joins the heap of its parent, no earlier than the minVruntime there.
+ *
+ * @param group Pointer to the ScheduleGroup (any level of the tree).
+ * @param proConBlock Pointer to the ProConBlock to be enqueued.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void enqueueScheduleGroup(ScheduleGroup *group, ProConBlock *proConBlock, Allocator *allocator) {
+
+    ScheduleEntity *entity = allocator->allocate(allocator, sizeof(ScheduleEntity));
+    assert(entity != NULL);
+    entity->vruntime = group->minVruntime;
+    entity->weight = schedulePriorityWeight(proConBlock->p_priority);
+    entity->parent = group;
+    entity->group = NULL;
+    entity->proConBlock = proConBlock;
+    proConBlock->p_state = ready;
+
+    heapPush(group, entity, allocator);
+    appendProcess(rootOf(group)->index, proConBlock->p_id, entity);
+
+    for (ScheduleGroup *temp = group; temp != NULL; temp = temp->entity.parent) {
+        temp->member += 1;
+        ScheduleGroup *parent = temp->entity.parent;
+        if (temp->member == 1 && parent != NULL) {
+            if (temp->entity.vruntime < parent->minVruntime) {
+                temp->entity.vruntime = parent->minVruntime;
+            }
+            heapPush(parent, &temp->entity, allocator);
+        }
+    }
+}
+
+/**
+ * @brief Selects the next ProConBlock to run.
+ *
+ * Starting at the root, this function follows the entity with the smallest vruntime of every level until it reaches a process.
+ * It reads one heap top per level, O(depth), and does not change the tree.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @return Pointer to the selected ProConBlock, NULL if no process is ready.
+ */
+ProConBlock *pickScheduleGroup(ScheduleGroup *root) {
+
+    ScheduleGroup *group = root;
+    while (group->size > 0) {
+        ScheduleEntity *entity = group->heap[0];
+        if (entity->proConBlock != NULL) {
+            return entity->proConBlock;
+        }
+        group = entity->group;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Finds the ScheduleEntity of a ProConBlock in the tree of ScheduleGroups.
+ *
+ * Processes may share a p_id, so the entity whose proConBlock is this ProConBlock is looked for among them.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @param proConBlock Pointer to the ProConBlock.
+ * @return Pointer to the ScheduleEntity, NULL if the ProConBlock is not in the tree.
+ */
+static ScheduleEntity *findScheduleEntity(ScheduleGroup *root, ProConBlock *proConBlock) {
+
+    ScheduleEntity *entity = getProcess(root->index, proConBlock->p_id);
+    while (entity != NULL && entity->proConBlock != proConBlock) {
+        entity = nextProcess(root->index, proConBlock->p_id, entity);
+    }
+    return entity;
+}
+
+/**
+ * @brief Charges the time a ProConBlock has run to it and to all its ancestor groups.
+ *
+ * Each entity on the path to the root advances its vruntime by executed * SCHEDULE_NICE_0_WEIGHT / weight and sinks in the heap of its parent,
+ * O(depth · log n) in total. A heavier entity advances more slowly and is therefore picked more often.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @param proConBlock Pointer to the ProConBlock that has run.
+ * @param executed The time the ProConBlock has run.
+ */
+void chargeScheduleGroup(ScheduleGroup *root, ProConBlock *proConBlock, double executed) {
+
+    ScheduleEntity *entity = findScheduleEntity(root, proConBlock);
+    assert(entity != NULL);
+
+    long ticks = (long) (executed * 1000);
+    while (entity->parent != NULL) {
+        entity->vruntime += ticks * SCHEDULE_NICE_0_WEIGHT / entity->weight;
+        siftDown(entity->parent, entity->heapIndex);
+        updateMinVruntime(entity->parent);
+        entity = &entity->parent->entity;
+    }
+}
+
+/**
+ * @brief Removes a ScheduleEntity of a process from the tree of ScheduleGroups and deallocates it.
+ *
+ * Every ancestor counts one ready process less; a group left without ready processes leaves the heap of its parent and keeps its vruntime.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @param entity Pointer to the ScheduleEntity of the process.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the ProConBlock of the ScheduleEntity.
+ */
+static ProConBlock *removeScheduleEntity(ScheduleGroup *root, ScheduleEntity *entity, Allocator *allocator) {
+
+    removeProcessValue(root->index, entity->proConBlock->p_id, entity);
+    heapRemove(entity->parent, entity);
+    for (ScheduleGroup *temp = entity->parent; temp != NULL; temp = temp->entity.parent) {
+        temp->member -= 1;
+        if (temp->member == 0 && temp->entity.parent != NULL) {
+            heapRemove(temp->entity.parent, &temp->entity);
+        }
+    }
+
+    ProConBlock *proConBlock = entity->proConBlock;
+    allocator->deallocate(allocator, entity, sizeof(ScheduleEntity));
+    return proConBlock;
+}
+
+/**
+ * @brief Removes a ProConBlock from the tree of ScheduleGroups.
+ *
+ * The first ScheduleEntity with the process ID is removed, see removeScheduleEntity.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @param p_id The process ID of the ProConBlock to be removed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the removed ProConBlock, NULL if it is not in the tree.
+ */
+ProConBlock *dequeueScheduleGroup(ScheduleGroup *root, int p_id, Allocator *allocator) {
+
+    ScheduleEntity *entity = getProcess(root->index, p_id);
+    if (entity == NULL) {
+        return NULL;
+    }
+    return removeScheduleEntity(root, entity, allocator);
+}
+
+/**
+ * @brief Runs every ready ProConBlock of a tree of ScheduleGroups to completion.
+ *
+ * This function repeatedly picks a ProConBlock, executes one time slice by calling runningProConBlockTask and charges the executed time.
+ * The last ready ProConBlock is linked to itself before it runs, so runningProConBlockTask executes it to completion as roundRobinScheduling does.
+ * Finished ProConBlocks are removed from the tree and appended to finishLink in completion order.
+ * A ProConBlock refused by an attached ScheduleAdmission leaves the tree until another one finishes and releases its resources,
+ * then it is enqueued into its group again. The ones still refused at the end are enqueued back, blocked, and stay in the tree.
+ *
+ * @param root Pointer to the root ScheduleGroup.
+ * @param finishLink Pointer to the ProConBlockLink receiving the finished ProConBlocks.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void groupFairScheduling(ScheduleGroup *root, ProConBlockLink *finishLink, Allocator *allocator) {
+
+    // refused ProConBlocks and the groups they are enqueued into again
+    RefusedScheduleEntity *refused = NULL;
+    int refusedSize = 0;
+    int refusedCapacity = 0;
+
+    ProConBlock *proConBlock = NULL;
+    while ((proConBlock = pickScheduleGroup(root)) != NULL) {
+        double executeTime = proConBlock->p_execute_time;
+        if (root->member == 1) {
+            proConBlock->perProConBlock = proConBlock;
+            proConBlock->aftProConBlock = proConBlock;
+        }
+        ProConBlock *executed = runningProConBlockTask(proConBlock);
+        assert(executed == proConBlock);
+        proConBlock->perProConBlock = NULL;
+        proConBlock->aftProConBlock = NULL;
+
+        ScheduleEntity *entity = findScheduleEntity(root, proConBlock);
+        if (proConBlock->p_state == blocked) {
+            if (refusedSize == refusedCapacity) {
+                int capacity = refusedCapacity > 0 ? 2 * refusedCapacity : 4;
+                refused = allocator->reallocate(allocator, refused, refusedCapacity * sizeof(RefusedScheduleEntity),
+                                                capacity * sizeof(RefusedScheduleEntity));
+                refusedCapacity = capacity;
+            }
+            refused[refusedSize].proConBlock = proConBlock;
+            refused[refusedSize++].group = entity->parent;
+            removeScheduleEntity(root, entity, allocator);
+            continue;
+        }
+        chargeScheduleGroup(root, proConBlock, proConBlock->p_execute_time - executeTime);
+        if (proConBlock->p_execute_time >= proConBlock->p_total_time) {
+            appendToLink(removeScheduleEntity(root, entity, allocator), finishLink);
+            for (int i = 0; i < refusedSize; ++i) {
+                enqueueScheduleGroup(refused[i].group, refused[i].proConBlock, allocator);
+            }
+            refusedSize = 0;
+        }
+    }
+    for (int i = 0; i < refusedSize; ++i) {
+        enqueueScheduleGroup(refused[i].group, refused[i].proConBlock, allocator);
+        refused[i].proConBlock->p_state = blocked;
+    }
+    allocator->deallocate(allocator, refused, refusedCapacity * sizeof(RefusedScheduleEntity));
+    displayProConBlockLink(finishLink);
+}
@@ -0,0 +1,67 @@
+/*
+ User: Redskaber
+ Date: 2024/1/23
+ Time: 19:48
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SCHEDULE_GROUP_H
+#define OPERATORSYSTEM_SCHEDULE_GROUP_H
+/*
+ * 分组公平调度(类似 cgroup + CFS)
+        调度组组成一棵树, 每个组有权重, 组内的就绪实体(子组或进程)放在按虚拟运行时间 vruntime 排序的小根堆中。
+        选择: 从根开始每层取堆顶, 直到一个进程, O(depth)。
+        记账: 进程运行 t 后, 它和它的每个祖先组按 t * SCHEDULE_NICE_0_WEIGHT / weight 增加 vruntime 并在父堆中下沉, O(depth · log n)。
+
+        一个组内进程再多, 也只是这个组自己的堆变大; 组在父堆中只是一个实体, 按组权重分得 CPU,
+        所以一个租户大量创建进程不会挤占其它租户。没有就绪进程的组不在父堆中。
+        新实体的 vruntime 从所在组的 minVruntime 开始, 既不会饿死别人, 也不会因为之前没运行而长期独占。
+ */
+
+#include "../process_scheduling.h"
+
+#define SCHEDULE_NICE_0_WEIGHT 1024
+#define SCHEDULE_GROUP_HEAP_INIT_SIZE 8
+
+// 进程优先级 -> 权重
+#define schedulePriorityWeight(priority) (SCHEDULE_NICE_0_WEIGHT << (priority) >> 1)
+
+struct ScheduleGroup;
+
+typedef struct ScheduleEntity {
+    long vruntime;
+    int weight;
+    int heapIndex;                  // 在父组堆中的位置, -1 表示不在堆中
+    struct ScheduleGroup *parent;
+    struct ScheduleGroup *group;    // 子组实体
+    ProConBlock *proConBlock;       // 进程实体
+} ScheduleEntity;
+
+typedef struct ScheduleGroup {
+    ScheduleEntity entity;          // 本组在父组中的实体
+    char *name;
+    ScheduleEntity **heap;
+    int size;
+    int capacity;
+    long minVruntime;
+    int member;                     // 子树中的就绪进程数
+    struct ScheduleGroup *firstChild;
+    struct ScheduleGroup *nextSibling;
+    HashMapProcess *index;          // 仅根组: p_id -> ScheduleEntity
+} ScheduleGroup;
+
+
+extern ScheduleGroup *initScheduleGroup(char *name, int weight, ScheduleGroup *parent, Allocator *allocator);
+
+extern void destroyScheduleGroup(ScheduleGroup *group, Allocator *allocator);
+
+extern void enqueueScheduleGroup(ScheduleGroup *group, ProConBlock *proConBlock, Allocator *allocator);
+
+extern ProConBlock *pickScheduleGroup(ScheduleGroup *root);
+
+extern void chargeScheduleGroup(ScheduleGroup *root, ProConBlock *proConBlock, double executed);
+
+extern ProConBlock *dequeueScheduleGroup(ScheduleGroup *root, int p_id, Allocator *allocator);
+
+extern void groupFairScheduling(ScheduleGroup *root, ProConBlockLink *finishLink, Allocator *allocator);
+
+#endif //OPERATORSYSTEM_SCHEDULE_GROUP_H
@@ -4,6 +4,9 @@
  Time: 10:51
 */
 #include "process_scheduling.h"
+#include "trace/schedule_trace.h"
+#include "stats/schedule_stats.h"
+#include "ring_queue/ring_queue.h"
 
 
 
@@ -22,6 +25,43 @@
 //循环执行： 以上步骤循环执行，系统选择下一个要执行的进程。
 
 
+// 当前线程的调度时间线, NULL 表示不记录
+static _Thread_local ScheduleTrace *scheduleTrace = NULL;
+// 当前线程的派发准入检查, NULL 表示不检查
+static _Thread_local ScheduleAdmission *scheduleAdmission = NULL;
+
+
+/**
+ * @brief Asks the attached ScheduleAdmission whether a ProConBlock may be dispatched.
+ *
+ * A refused ProConBlock is marked blocked and, while a ScheduleTrace is attached, recorded as a block event; it is not run.
+ *
+ * @param proConBlock Pointer to the ProConBlock about to be dispatched.
+ * @return Boolean value indicating whether the ProConBlock may run, always true without an attached ScheduleAdmission.
+ */
+static inline _Bool admitDispatchedProConBlock(ProConBlock *proConBlock) {
+    if (scheduleAdmission == NULL || scheduleAdmission->admit(scheduleAdmission->context, proConBlock)) {
+        return true;
+    }
+    proConBlock->p_state = blocked;
+    if (scheduleTrace != NULL) {
+        traceScheduleInstant(scheduleTrace, trace_block, proConBlock);
+    }
+    return false;
+}
+
+/**
+ * @brief Tells the attached ScheduleAdmission that a ProConBlock has finished.
+ *
+ * @param proConBlock Pointer to the finished ProConBlock.
+ */
+static inline void releaseDispatchedProConBlock(ProConBlock *proConBlock) {
+    if (scheduleAdmission != NULL) {
+        scheduleAdmission->release(scheduleAdmission->context, proConBlock);
+    }
+}
+
+
 
 /**
  * @brief Creates a new ProConBlock structure and initializes it as the head of a linked list.
@@ -44,6 +84,7 @@ static ProConBlock *headProConBlock(Allocator *allocator) {
     head->p_priority = 0;
     head->p_total_time = 0;
     head->p_execute_time = 0;
+    head->p_ready_tick = 0;
     head->callback = NULL;
 
     head->perProConBlock = NULL;
@@ -87,6 +128,7 @@ initProConBlock(
     newProConBlock->p_priority = p_priority;
     newProConBlock->p_total_time = p_total_time;
     newProConBlock->p_execute_time = 0;
+    newProConBlock->p_ready_tick = 0;
 
     newProConBlock->callback = callBack;
 
@@ -149,6 +191,8 @@ void displayProConBlock(ProConBlock *proConBlock) {
  * This function allocates memory for a new ProConBlockLink structure and initializes its fields.
  * It creates a head ProConBlock by calling the headProConBlock function and assigns it to the headProConBlock field of the ProConBlockLink.
  * It also sets the lastProConBlock field of the ProConBlockLink to the headProConBlock, indicating that the ProConBlockLink currently contains only the head ProConBlock.
+ * Finally, it creates the p_id index of the ProConBlockLink, which is kept up to date by every insert and remove,
+ * and remembers the allocator, which scheduling functions use for their temporary memory.
  *
  * @param allocator Pointer to the Allocator structure used for memory management.
  * @return Pointer to the newly created ProConBlockLink structure.
@@ -159,6 +203,8 @@ ProConBlockLink *initProConBlockLink(Allocator *allocator) {
     newProConBlockLink = allocator->allocate(allocator, sizeof(ProConBlockLink));
     newProConBlockLink->headProConBlock = headProConBlock(allocator);
     newProConBlockLink->lastProConBlock = newProConBlockLink->headProConBlock;
+    newProConBlockLink->index = createHashMapProcess(HASH_MAP_PROCESS_INIT_SIZE);
+    newProConBlockLink->allocator = allocator;
 
     return newProConBlockLink;
 }
@@ -169,7 +215,7 @@ ProConBlockLink *initProConBlockLink(Allocator *allocator) {
  * This function deallocates the memory used by the ProConBlockLink structure.
  * It first checks if the ProConBlockLink pointer is not NULL.
  * If it is not NULL, it destroys the head ProConBlock in the ProConBlockLink by calling the destroyProConBlock function.
- * It then deallocates the memory used by the ProConBlockLink structure itself.
+ * It then destroys the p_id index and deallocates the memory used by the ProConBlockLink structure itself.
  *
  * @param proConBlockLink Pointer to the ProConBlockLink structure to be destroyed.
  * @param allocator Pointer to the Allocator structure used for memory management.
@@ -178,6 +224,7 @@ void destroyProConBlockLink(ProConBlockLink *proConBlockLink, Allocator *allocat
 
     if (proConBlockLink != NULL) {
         destroyProConBlock(proConBlockLink->headProConBlock, allocator);
+        destroyHashMapProcess(proConBlockLink->index);
         allocator->deallocate(allocator, proConBlockLink, sizeof(ProConBlockLink));
     }
 }
@@ -193,12 +240,15 @@ void destroyProConBlockLink(ProConBlockLink *proConBlockLink, Allocator *allocat
  * If the aftProConBlock field of the headProConBlock in the ProConBlockLink is not NULL,
  * it means the ProConBlockLink already contains ProConBlocks. In this case, it inserts
  * the ProConBlock at the beginning of the ProConBlockLink, right after the headProConBlock.
+ * In both cases the ProConBlock is registered in the p_id index of the ProConBlockLink.
  *
  * @param proConBlock Pointer to the ProConBlock to be added to the ProConBlockLink.
  * @param proConBlockLink Pointer to the ProConBlockLink where the ProConBlock will be added.
  */
 void pushToLink(ProConBlock *proConBlock, ProConBlockLink *proConBlockLink) {
 
+    uint64_t start = scheduleStatsNow();
+    appendProcess(proConBlockLink->index, proConBlock->p_id, proConBlock);
     if (proConBlockLink->headProConBlock->aftProConBlock == NULL) {
         // [] -> []
         proConBlockLink->headProConBlock->aftProConBlock = proConBlock;
@@ -213,6 +263,37 @@ void pushToLink(ProConBlock *proConBlock, ProConBlockLink *proConBlockLink) {
         proConBlockLink->headProConBlock->aftProConBlock->perProConBlock = proConBlock;
         proConBlockLink->headProConBlock->aftProConBlock = proConBlock;
     }
+    countScheduleStats(counter_enqueues, 1);
+    recordScheduleLatency(latency_enqueue, start);
+}
+
+/**
+ * @brief Appends a ProConBlock to the end of a ProConBlockLink.
+ *
+ * This function adds a ProConBlock after the lastProConBlock of a ProConBlockLink in O(1).
+ * If the ProConBlockLink is empty, the ProConBlock becomes the first ProConBlock after the headProConBlock.
+ * Unlike pushToLink, the ProConBlockLink keeps arrival order from front to back, so it can be used directly as a FIFO queue.
+ *
+ * @param proConBlock Pointer to the ProConBlock to be appended to the ProConBlockLink.
+ * @param proConBlockLink Pointer to the ProConBlockLink where the ProConBlock will be appended.
+ */
+void appendToLink(ProConBlock *proConBlock, ProConBlockLink *proConBlockLink) {
+
+    uint64_t start = scheduleStatsNow();
+    appendProcess(proConBlockLink->index, proConBlock->p_id, proConBlock);
+    proConBlock->aftProConBlock = NULL;
+    if (proConBlockLink->headProConBlock->aftProConBlock == NULL) {
+        // [h] -> [z]
+        proConBlock->perProConBlock = NULL;
+        proConBlockLink->headProConBlock->aftProConBlock = proConBlock;
+    } else {
+        // [h] -> [1] <-> [2] <-> [z]
+        proConBlock->perProConBlock = proConBlockLink->lastProConBlock;
+        proConBlockLink->lastProConBlock->aftProConBlock = proConBlock;
+    }
+    proConBlockLink->lastProConBlock = proConBlock;
+    countScheduleStats(counter_enqueues, 1);
+    recordScheduleLatency(latency_enqueue, start);
 }
 
 /**
@@ -276,13 +357,14 @@ void sortLinkFromLinkParam(ProConBlockLink *proConBlockLink, Compare compare) {
     ProConBlock *order = proConBlockLink->headProConBlock->aftProConBlock;
     ProConBlock *insertData = NULL;
     ProConBlock *insertIndex = NULL;
+    uint64_t comparisons = 0;
 
     while (order->aftProConBlock != NULL) {
         insertData = order->aftProConBlock;
         insertIndex = order;
 
         // Find the correct position for the insertData ProConBlock
-        while (insertIndex != NULL && compare(insertData, insertIndex)) {
+        while (insertIndex != NULL && (++comparisons, compare(insertData, insertIndex))) {
             insertIndex = insertIndex->perProConBlock;
         }
         if (insertIndex == NULL) {
@@ -298,12 +380,14 @@ void sortLinkFromLinkParam(ProConBlockLink *proConBlockLink, Compare compare) {
         }
 
     }
+    countScheduleStats(counter_comparisons, comparisons);
 }
 
 /**
  * @brief Removes the last ProConBlock from a ProConBlockLink.
  *
  * This function removes the last ProConBlock from a ProConBlockLink and deallocates the memory used by it.
+ * The ProConBlock is also removed from the p_id index of the ProConBlockLink.
  * If the last ProConBlock is not NULL, it checks if it is the only ProConBlock in the ProConBlockLink (i.e., it is the next ProConBlock of the headProConBlock).
  * If it is not the only ProConBlock, it retrieves the previous ProConBlock of the last ProConBlock, destroys the last ProConBlock, and updates the lastProConBlock field of the ProConBlockLink to the previous ProConBlock.
  * If it is the only ProConBlock, it destroys the last ProConBlock and sets the aftProConBlock field of the headProConBlock and the lastProConBlock field of the ProConBlockLink to NULL.
@@ -313,7 +397,9 @@ void sortLinkFromLinkParam(ProConBlockLink *proConBlockLink, Compare compare) {
  */
 void popBlackFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator) {
 
-    if (proConBlockLink->lastProConBlock != NULL) {
+    if (proConBlockLink->lastProConBlock != NULL &&
+        proConBlockLink->lastProConBlock != proConBlockLink->headProConBlock) {
+        removeProcessValue(proConBlockLink->index, proConBlockLink->lastProConBlock->p_id, proConBlockLink->lastProConBlock);
         if (proConBlockLink->headProConBlock->aftProConBlock != proConBlockLink->lastProConBlock) {
             // [h] -> [] <-> [] <-> []
             ProConBlock *popProConBlock = proConBlockLink->lastProConBlock;
@@ -335,6 +421,7 @@ void popBlackFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator) {
  * @brief Removes the first ProConBlock from a ProConBlockLink.
  *
  * This function removes the first ProConBlock (the one after the head) from a ProConBlockLink and deallocates the memory used by it.
+ * The ProConBlock is also removed from the p_id index of the ProConBlockLink.
  * If the aftProConBlock field of the headProConBlock in the ProConBlockLink is not NULL, it means the ProConBlockLink contains ProConBlocks.
  * In this case, it retrieves the next ProConBlock of the first ProConBlock, destroys the first ProConBlock, and sets the aftProConBlock field of the headProConBlock to the next ProConBlock.
  * If the next ProConBlock is not NULL, it sets the perProConBlock field of the next ProConBlock to NULL.
@@ -347,6 +434,8 @@ void popFrontFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator) {
 
     if (proConBlockLink->headProConBlock->aftProConBlock != NULL) {
         // [h] -> [] <-> [] <-> []
+        removeProcessValue(proConBlockLink->index, proConBlockLink->headProConBlock->aftProConBlock->p_id,
+                           proConBlockLink->headProConBlock->aftProConBlock);
         ProConBlock *aftProConBlock = proConBlockLink->headProConBlock->aftProConBlock->aftProConBlock;
         proConBlockLink->headProConBlock->aftProConBlock->aftProConBlock = NULL;
         destroyProConBlock(proConBlockLink->headProConBlock->aftProConBlock, allocator);
@@ -367,6 +456,7 @@ void popFrontFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator) {
  * If the ProConBlockLink is not empty, it finds the correct position for the ProConBlock by iterating over the ProConBlockLink and using the comparison function.
  * If the ProConBlock should be inserted at the beginning of the ProConBlockLink, it calls the pushToLink function to insert it.
  * If the ProConBlock should be inserted in the middle or at the end of the ProConBlockLink, it adjusts the perProConBlock and aftProConBlock pointers of the surrounding ProConBlocks to insert it.
+ * The ProConBlock is registered in the p_id index of the ProConBlockLink.
  *
  * @param proConBlockLink Pointer to the ProConBlockLink where the ProConBlock will be inserted.
  * @param proConBlock Pointer to the ProConBlock to be inserted into the ProConBlockLink.
@@ -374,19 +464,26 @@ void popFrontFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator) {
  */
 void insertToLinkFromParam(ProConBlockLink *proConBlockLink, ProConBlock *proConBlock, Compare compare) {
 
+    uint64_t start = scheduleStatsNow();
+    uint64_t comparisons = 0;
     if (proConBlockLink->headProConBlock->aftProConBlock == NULL) {
         // [] -> []
+        appendProcess(proConBlockLink->index, proConBlock->p_id, proConBlock);
         proConBlockLink->headProConBlock->aftProConBlock = proConBlock;
         proConBlockLink->lastProConBlock = proConBlock;
     } else {
         // <-[2]->
         // [h] -> [3] <->[2] <-> [1]
         // [h] -> [3] <->[2] <-> [2] <-> [1]
-        if (compare(proConBlock, proConBlockLink->headProConBlock->aftProConBlock)) {
+        if ((++comparisons, compare(proConBlock, proConBlockLink->headProConBlock->aftProConBlock))) {
+            countScheduleStats(counter_comparisons, comparisons);
+            // pushToLink records the enqueue itself
             pushToLink(proConBlock, proConBlockLink);
+            return;
         } else {
+            appendProcess(proConBlockLink->index, proConBlock->p_id, proConBlock);
             ProConBlock *temp = proConBlockLink->headProConBlock->aftProConBlock->aftProConBlock;
-            while (temp != NULL && compare(temp, proConBlock)) {
+            while (temp != NULL && (++comparisons, compare(temp, proConBlock))) {
                 temp = temp->aftProConBlock;
             }
             if (temp != NULL) {
@@ -402,6 +499,9 @@ void insertToLinkFromParam(ProConBlockLink *proConBlockLink, ProConBlock *proCon
             }
         }
     }
+    countScheduleStats(counter_comparisons, comparisons);
+    countScheduleStats(counter_enqueues, 1);
+    recordScheduleLatency(latency_enqueue, start);
 }
 
 /**
@@ -544,7 +644,9 @@ orderProConBlockThroughPriority(
         ProcessPriority priority
 ) {
 
+    uint64_t comparisons = 0;
     while (quick != NULL) {
+        comparisons += 1;
         if (quick->p_priority == priority) {
             if (slow != quick) {
                 insertProConBlockToSamePriorityAfter(proConBlockLink, slow, quick);
@@ -553,6 +655,7 @@ orderProConBlockThroughPriority(
         }
         quick = quick->aftProConBlock;
     }
+    countScheduleStats(counter_comparisons, comparisons);
     return slow;
 }
 
@@ -595,43 +698,48 @@ void priorityScheduling(ProConBlockLink *proConBlockLink) {
  * It then displays the details of the ProConBlock again and prints a message indicating the end of execution.
  * The function continues until all ProConBlocks have been executed.
  *
+ * While a ScheduleAdmission is attached, a ProConBlock it refuses is skipped and marked blocked. After the next ProConBlock finishes
+ * and releases its resources, the walk restarts at the first refused one, passing over the ones that already finished (suspended_ready).
+ * ProConBlocks still refused when the walk reaches the end stay blocked in the ProConBlockLink.
+ *
  * @param proConBlockLink Pointer to the ProConBlockLink whose ProConBlocks will be executed.
  */
 void executeOver(ProConBlockLink *proConBlockLink) {
 
+    // the first ProConBlock refused since the last one finished
+    ProConBlock *retry = NULL;
     ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
     while (proConBlock != NULL) {
+        if (scheduleAdmission != NULL && proConBlock->p_state == suspended_ready) {
+            proConBlock = proConBlock->aftProConBlock;
+            continue;
+        }
+        if (!admitDispatchedProConBlock(proConBlock)) {
+            retry = retry != NULL ? retry : proConBlock;
+            proConBlock = proConBlock->aftProConBlock;
+            continue;
+        }
         printf_s("Start running...\n");
         displayProConBlock(proConBlock);
 
+        double executeTime = proConBlock->p_execute_time;
         proConBlock->p_state = running;
         proConBlock = proConBlock->callback(proConBlock);
         proConBlock->p_execute_time = proConBlock->p_total_time;
         proConBlock->p_state = suspended_ready;
+        countScheduleStats(counter_dispatches, 1);
+        if (scheduleTrace != NULL) {
+            traceProConBlockSlice(scheduleTrace, proConBlock, proConBlock->p_execute_time - executeTime);
+        }
+        releaseDispatchedProConBlock(proConBlock);
 
         displayProConBlock(proConBlock);
         printf_s("End running...\n");
-        proConBlock = proConBlock->aftProConBlock;
+        proConBlock = retry != NULL ? retry : proConBlock->aftProConBlock;
+        retry = NULL;
     }
 }
 
-/**
- * @brief Removes a ProConBlock from a ProConBlockLink.
- *
- * This function removes a ProConBlock (referred to as loopLink) from a ProConBlockLink.
- * It first updates the aftProConBlock pointer of the previous ProConBlock and the perProConBlock pointer of the next ProConBlock to bypass the loopLink ProConBlock.
- * It then returns the loopLink ProConBlock, which has been removed from the ProConBlockLink but is still allocated.
- *
- * @param loopLink Pointer to the ProConBlock to be removed from the ProConBlockLink.
- * @return Pointer to the removed ProConBlock.
- */
-inline static ProConBlock *removeNextProConBlockFromLink(ProConBlock *loopLink) {
-
-    loopLink->perProConBlock->aftProConBlock = loopLink->aftProConBlock;
-    loopLink->aftProConBlock->perProConBlock = loopLink->perProConBlock;
-    return loopLink;
-}
-
 /**
  * @brief Executes a ProConBlock and updates its state and execution time.
  *
@@ -641,13 +749,18 @@ inline static ProConBlock *removeNextProConBlockFromLink(ProConBlock *loopLink)
  * If either condition is true, it calls the callback function of the ProConBlock, sets the execute time of the ProConBlock to the total time, and sets the process state to suspended_ready.
  * If neither condition is true, it calls the callback function of the ProConBlock, increments the execute time by a time slice, and sets the process state to suspended_blocked.
  * After the execution, it displays the details of the ProConBlock again and returns the ProConBlock.
+ * While a ScheduleAdmission is attached it is asked first; a refused ProConBlock does not run and is returned blocked, for the caller to requeue.
  *
  * @param loopLink Pointer to the ProConBlock to be executed.
  * @return Pointer to the executed ProConBlock.
  */
 ProConBlock *runningProConBlockTask(ProConBlock *loopLink) {
 
+    if (!admitDispatchedProConBlock(loopLink)) {
+        return loopLink;
+    }
     printf_s("Start running...\n");
+    double executeTime = loopLink->p_execute_time;
     loopLink->p_state = running;
     displayProConBlock(loopLink);
 
@@ -658,6 +771,7 @@ ProConBlock *runningProConBlockTask(ProConBlock *loopLink) {
         loopLink = loopLink->callback(loopLink);
         loopLink->p_execute_time = loopLink->p_total_time;
         loopLink->p_state = suspended_ready;
+        releaseDispatchedProConBlock(loopLink);
 
         displayProConBlock(loopLink);
         printf_s("End running...\n");
@@ -671,6 +785,11 @@ ProConBlock *runningProConBlockTask(ProConBlock *loopLink) {
         printf_s("Stop running...\n");
     }
 
+    countScheduleStats(counter_dispatches, 1);
+    countScheduleStats(counter_preemptions, loopLink->p_state == suspended_blocked);
+    if (scheduleTrace != NULL) {
+        traceProConBlockSlice(scheduleTrace, loopLink, loopLink->p_execute_time - executeTime);
+    }
     return loopLink;
 }
 
@@ -714,42 +833,105 @@ reconfigurationProConBlockLink(
  * @brief Implements the Round Robin scheduling algorithm for a ProConBlockLink.
  *
  * This function implements the Round Robin scheduling algorithm for a ProConBlockLink.
- * It first sets up a loop link by connecting the last ProConBlock in the ProConBlockLink to the first ProConBlock.
- * It then enters a loop where it executes each ProConBlock in the ProConBlockLink for a time slice.
- * If a ProConBlock finishes execution (i.e., its execution time plus a time slice is greater than or equal to its total time) or if it is the only ProConBlock in the ProConBlockLink, it is moved to the beginning of the ProConBlockLink.
- * If a ProConBlock does not finish execution, it remains in its current position in the ProConBlockLink.
- * The function continues until all ProConBlocks have been executed and moved to the beginning of the ProConBlockLink.
+ * It first copies the ProConBlocks into a contiguous array and puts their indexes into a RingQueue, in the order of the ProConBlockLink.
+ * Both are allocated from the allocator of the ProConBlockLink and grow while the link is walked, so every node gets a slot
+ * even when several ProConBlocks share a p_id.
+ * It then repeatedly executes the ProConBlock at the front of the RingQueue for a time slice by calling runningProConBlockTask.
+ * If the ProConBlock finishes execution (i.e., its execution time reaches its total time), its index is popped and the ProConBlock is moved to the beginning of the ProConBlockLink.
+ * If it does not finish, its index is rotated to the back of the RingQueue, which is a single store into the ring.
+ * Every dispatch records one pick-next latency, covering the pop or rotation of the previous slice and the peek of the next one.
+ * A ProConBlock refused by an attached ScheduleAdmission is rotated like an unfinished one. Once every waiting ProConBlock has been refused in a row,
+ * none of them can run; they are left blocked at the end of the ProConBlockLink, in ring order.
+ * The last remaining ProConBlock is linked to itself before it runs, so runningProConBlockTask executes it to completion as before.
+ * The function continues until the RingQueue is empty, so the ProConBlockLink ends in reverse completion order.
  * Finally, it updates the headProConBlock field of the ProConBlockLink to point to the first ProConBlock in the ProConBlockLink and displays the details of the ProConBlockLink.
  *
  * @param proConBlockLink Pointer to the ProConBlockLink to be scheduled.
  */
 void roundRobinScheduling(ProConBlockLink *proConBlockLink) {
 
-    ProConBlock *finishLink = NULL;
+    if (proConBlockLink->headProConBlock->aftProConBlock == NULL) {
+        displayProConBlockLink(proConBlockLink);
+        return;
+    }
+    // the member of the index is only the initial capacity, the arrays grow if the link holds more nodes
+    Allocator *allocator = proConBlockLink->allocator;
+    uint32_t capacity = proConBlockLink->index->member > 0 ? (uint32_t) proConBlockLink->index->member : 1;
+    ProConBlock **proConBlocks = allocator->allocate(allocator, capacity * sizeof(ProConBlock *));
+    assert(proConBlocks != NULL);
+    RingQueue *queue = initRingQueue(capacity, allocator);
+
+    // link -> array + ring
+    uint32_t slot = 0;
     ProConBlock *loopLink = proConBlockLink->headProConBlock->aftProConBlock;
-    // loop link
-    loopLink->perProConBlock = proConBlockLink->lastProConBlock;
-    proConBlockLink->lastProConBlock->aftProConBlock = loopLink;
+    while (loopLink != NULL) {
+        ProConBlock *aftProConBlock = loopLink->aftProConBlock;
+        loopLink->perProConBlock = NULL;
+        loopLink->aftProConBlock = NULL;
+        if (slot == capacity) {
+            proConBlocks = allocator->reallocate(allocator, proConBlocks,
+                                                 capacity * sizeof(ProConBlock *), 2 * capacity * sizeof(ProConBlock *));
+            assert(proConBlocks != NULL);
+            capacity *= 2;
+        }
+        proConBlocks[slot] = loopLink;
+        pushRingQueue(queue, slot++, allocator);
+        loopLink = aftProConBlock;
+    }
+    proConBlockLink->headProConBlock->aftProConBlock = NULL;
 
-    while (true) {
+    ProConBlock *finishLink = NULL;
+    uint32_t refused = 0;
+    uint64_t start = scheduleStatsNow();
+    while (queue->size > 0) {
+        slot = peekRingQueue(queue);
+        loopLink = proConBlocks[slot];
         // last node handle
-        if (loopLink->aftProConBlock == loopLink && loopLink->perProConBlock == loopLink) {
-            loopLink = runningProConBlockTask(loopLink);
+        if (queue->size == 1) {
+            loopLink->perProConBlock = loopLink;
+            loopLink->aftProConBlock = loopLink;
+        }
+        recordScheduleLatency(latency_pick_next, start);
+        loopLink = runningProConBlockTask(loopLink);
+        proConBlocks[slot] = loopLink;
+
+        if (loopLink->p_state == blocked) {
+            if (++refused == queue->size) {
+                break;
+            }
+            start = scheduleStatsNow();
+            rotateRingQueue(queue);
+            continue;
+        }
+        refused = 0;
+        if (loopLink->p_execute_time >= loopLink->p_total_time) {
             finishLink = reconfigurationProConBlockLink(proConBlockLink, finishLink, loopLink);
-            break;
+            start = scheduleStatsNow();
+            popRingQueue(queue);
+        } else {
+            start = scheduleStatsNow();
+            rotateRingQueue(queue);
         }
-        if (loopLink->p_execute_time + TIME_SLICE >= loopLink->p_total_time) {
-            loopLink = runningProConBlockTask(loopLink);
-            ProConBlock *cache = loopLink;
-            // remove
-            // <-> H <-> [1] <-> [2] <-> [3] -> [1] <->
-            loopLink = removeNextProConBlockFromLink(loopLink)->aftProConBlock;
-            finishLink = reconfigurationProConBlockLink(proConBlockLink, finishLink, cache);
+    }
+
+    // refused ProConBlocks follow the finished ones
+    ProConBlock *lastLink = finishLink != NULL ? proConBlockLink->lastProConBlock : NULL;
+    while (queue->size > 0) {
+        loopLink = proConBlocks[popRingQueue(queue)];
+        loopLink->perProConBlock = lastLink;
+        loopLink->aftProConBlock = NULL;
+        if (lastLink != NULL) {
+            lastLink->aftProConBlock = loopLink;
         } else {
-            loopLink = runningProConBlockTask(loopLink)->aftProConBlock;
+            finishLink = loopLink;
         }
+        lastLink = loopLink;
+        proConBlockLink->lastProConBlock = loopLink;
     }
 
+    destroyRingQueue(queue, allocator);
+    allocator->deallocate(allocator, proConBlocks, capacity * sizeof(ProConBlock *));
+
     // renew proConBlockLink headProConBlock
     proConBlockLink->headProConBlock->aftProConBlock = finishLink;
     displayProConBlockLink(proConBlockLink);
@@ -794,6 +976,9 @@ void shortestJobNext(ProConBlockLink *proConBlockLink) {
  * If proSortFunc is NULL, it defaults to the firstComeFirstServe function.
  * If proExeFunc is NULL, it defaults to the executeOver function.
  * It then calls the sorting function and the execution function in order.
+ * Everything recorded in between is attributed to the policy of the two functions in the schedule statistics.
+ * For the non-preemptive policies the time of the sorting function is recorded as the pick-next latency;
+ * round robin and priority aging record one pick-next latency per dispatch themselves.
  *
  * @param proConBlockLink Pointer to the ProConBlockLink to be executed.
  * @param proSortFunc Function pointer to the sorting function. If NULL, defaults to firstComeFirstServe.
@@ -805,10 +990,19 @@ void runningProConBlockFromLink(
         void (*proExeFunc)(ProConBlockLink *exeLink)
 ) {
     // order execute process link once
+    SchedulePolicy current = selectSchedulePolicy(proSortFunc, proExeFunc);
+    SchedulePolicy policy = switchSchedulePolicy(current);
     proSortFunc = proSortFunc != NULL ? proSortFunc : firstComeFirstServe;
     proExeFunc = proExeFunc != NULL ? proExeFunc : executeOver;
+
+    // the sort decides the order of the whole run: it is the pick-next decision of the non-preemptive policies
+    uint64_t start = scheduleStatsNow();
     proSortFunc(proConBlockLink);
+    if (current != policy_round_robin && current != policy_priority_aging) {
+        recordScheduleLatency(latency_pick_next, start);
+    }
     proExeFunc(proConBlockLink);
+    switchSchedulePolicy(policy);
 }
 
 /**
@@ -832,3 +1026,131 @@ void displayProConBlockLink(ProConBlockLink *proConBlockLink) {
     }
     printf_s("#############################################################\n");
 }
+
+/**
+ * @brief Finds a ProConBlock in a ProConBlockLink by its process ID.
+ *
+ * This function looks the process ID up in the p_id index of the ProConBlockLink instead of walking the link from the headProConBlock,
+ * so the lookup costs O(1) regardless of the length of the ProConBlockLink.
+ * The index keeps every ProConBlock of a shared process ID; if there are several, one of them is returned,
+ * and the others stay reachable after it is detached or killed.
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink to be searched.
+ * @param p_id The process ID of the ProConBlock.
+ * @return Pointer to the ProConBlock if found, NULL otherwise.
+ */
+ProConBlock *findProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id) {
+    return getProcess(proConBlockLink->index, p_id);
+}
+
+/**
+ * @brief Detaches a ProConBlock from a ProConBlockLink without deallocating it.
+ *
+ * This function unlinks a ProConBlock in O(1) using its perProConBlock and aftProConBlock pointers.
+ * The first ProConBlock of a ProConBlockLink has a NULL perProConBlock, so in that case the aftProConBlock field of the headProConBlock is updated instead.
+ * If the ProConBlock is the last one, the lastProConBlock field of the ProConBlockLink is moved back (or set to NULL when the ProConBlockLink becomes empty, as popFrontFromLink does).
+ * The ProConBlock is removed from the p_id index and its link pointers are cleared, so it can be destroyed or pushed to another ProConBlockLink.
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink that contains the ProConBlock.
+ * @param proConBlock Pointer to the ProConBlock to be detached.
+ * @return Pointer to the detached ProConBlock.
+ */
+ProConBlock *detachProConBlockFromLink(ProConBlockLink *proConBlockLink, ProConBlock *proConBlock) {
+
+    ProConBlock *perProConBlock = proConBlock->perProConBlock;
+    ProConBlock *aftProConBlock = proConBlock->aftProConBlock;
+
+    // [h] -> [per] <-> [x] <-> [aft]
+    if (perProConBlock != NULL) {
+        perProConBlock->aftProConBlock = aftProConBlock;
+    } else {
+        proConBlockLink->headProConBlock->aftProConBlock = aftProConBlock;
+    }
+    if (aftProConBlock != NULL) {
+        aftProConBlock->perProConBlock = perProConBlock;
+    } else {
+        proConBlockLink->lastProConBlock = perProConBlock;
+    }
+
+    removeProcessValue(proConBlockLink->index, proConBlock->p_id, proConBlock);
+    proConBlock->perProConBlock = NULL;
+    proConBlock->aftProConBlock = NULL;
+    return proConBlock;
+}
+
+/**
+ * @brief Changes the priority of a ProConBlock in a ProConBlockLink.
+ *
+ * This function finds the ProConBlock through the p_id index and updates its priority in O(1).
+ * The position of the ProConBlock is not changed; the next call of a sorting function (for example priorityScheduling) orders it by the new priority.
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink that contains the ProConBlock.
+ * @param p_id The process ID of the ProConBlock.
+ * @param p_priority The new priority of the ProConBlock.
+ * @return Pointer to the updated ProConBlock if found, NULL otherwise.
+ */
+ProConBlock *reniceProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id, ProcessPriority p_priority) {
+
+    ProConBlock *proConBlock = findProConBlockFromLink(proConBlockLink, p_id);
+    if (proConBlock != NULL) {
+        proConBlock->p_priority = p_priority;
+    }
+    return proConBlock;
+}
+
+/**
+ * @brief Terminates an arbitrary ProConBlock of a ProConBlockLink.
+ *
+ * This function finds the ProConBlock through the p_id index, detaches it by calling detachProConBlockFromLink,
+ * marks it as terminated and deallocates it. Every step is O(1).
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink that contains the ProConBlock.
+ * @param p_id The process ID of the ProConBlock to be terminated.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Boolean value indicating whether a ProConBlock with the process ID was found and terminated.
+ */
+_Bool killProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id, Allocator *allocator) {
+
+    ProConBlock *proConBlock = findProConBlockFromLink(proConBlockLink, p_id);
+    if (proConBlock == NULL) {
+        return false;
+    }
+    detachProConBlockFromLink(proConBlockLink, proConBlock);
+    proConBlock->p_state = terminated;
+    if (scheduleTrace != NULL) {
+        traceScheduleInstant(scheduleTrace, trace_terminate, proConBlock);
+    }
+    destroyProConBlock(proConBlock, allocator);
+    return true;
+}
+
+/**
+ * @brief Attaches a ScheduleAdmission to the scheduler of the calling thread.
+ *
+ * While a ScheduleAdmission is attached, executeOver and runningProConBlockTask ask it before every dispatch and tell it when a ProConBlock finishes,
+ * so every policy built on them (first come first serve, shortest job next, priority, round robin, priority aging and group fair) checks admission
+ * at the moment a slice is dispatched. The attachment is kept per thread, like the ScheduleTrace.
+ *
+ * @param admission Pointer to the ScheduleAdmission to be attached, NULL to stop checking. It must stay valid while attached.
+ */
+void attachScheduleAdmission(ScheduleAdmission *admission) {
+    scheduleAdmission = admission;
+}
+
+/**
+ * @brief Attaches a ScheduleTrace to the scheduler of the calling thread.
+ *
+ * While a ScheduleTrace is attached, executeOver and runningProConBlockTask record every executed slice and how it ended.
+ * The attachment is kept per thread, so schedulers running on different threads do not interfere.
+ * Every thread that dispatches is one simulated CPU: it gets its own lane the first time it attaches a ScheduleTrace, see scheduleTraceLane,
+ * and its events are recorded on that lane, so traces of several threads can be viewed side by side.
+ * The same ScheduleTrace may be attached on several threads at once; it serialises their events with its own lock.
+ *
+ * @param trace Pointer to the ScheduleTrace to be attached, NULL to stop tracing.
+ */
+void attachScheduleTrace(ScheduleTrace *trace) {
+    if (trace != NULL) {
+        scheduleTraceLane();
+    }
+    scheduleTrace = trace;
+}
@@ -73,11 +73,14 @@
 #include <stdarg.h>
 #include <string.h>
 #include "../allocator/systemResource.h"
+#include "../tools/hashMapProcess/hashMapProcess.h"
 
 #define TIME_SLICE  5
 
 typedef void *(*CallBack)(void *args);
 
+typedef struct ScheduleTrace ScheduleTrace;
+
 typedef _Bool (*Compare)(void *a, void *b);
 
 
@@ -111,6 +114,7 @@ typedef struct ProcessControlBlock {
     ProcessPriority p_priority;
     double p_execute_time;
     double p_total_time;
+    long p_ready_tick;      // 进入就绪队列时的虚拟时钟
 
     CallBack callback;
 
@@ -123,8 +127,18 @@ typedef struct ProcessControlBlock {
 typedef struct ProcessControlBlackLink {
     ProConBlock *headProConBlock;
     ProConBlock *lastProConBlock;
+    HashMapProcess *index;      // p_id -> ProConBlock
+    Allocator *allocator;       // 创建该链的分配器, 调度函数的临时内存也从这里分配
 } ProConBlockLink;
 
+// 派发准入检查: admit 在每次派发前调用, 返回 false 时进程这次不运行(状态置为 blocked, 由调度函数重新排队);
+// release 在进程运行结束后调用。例如银行家算法的 attachScheduleBanker
+typedef struct ScheduleAdmission {
+    _Bool (*admit)(void *context, ProConBlock *proConBlock);
+    void (*release)(void *context, ProConBlock *proConBlock);
+    void *context;
+} ScheduleAdmission;
+
 
 #define proStateToString(state) _Generic((state), \
     enum ProcessState:                            \
@@ -160,6 +174,8 @@ extern ProConBlockLink *initProConBlockLink(Allocator *allocator);
 
 extern void pushToLink(ProConBlock *proConBlock, ProConBlockLink *proConBlockLink);
 
+extern void appendToLink(ProConBlock *proConBlock, ProConBlockLink *proConBlockLink);
+
 extern void popBlackFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator);
 
 extern void popFrontFromLink(ProConBlockLink *proConBlockLink, Allocator *allocator);
@@ -190,4 +206,16 @@ extern void roundRobinScheduling(ProConBlockLink *proConBlockLink);
 
 extern void shortestJobNext(ProConBlockLink *proConBlockLink);
 
+extern ProConBlock *findProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id);
+
+extern ProConBlock *detachProConBlockFromLink(ProConBlockLink *proConBlockLink, ProConBlock *proConBlock);
+
+extern ProConBlock *reniceProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id, ProcessPriority p_priority);
+
+extern _Bool killProConBlockFromLink(ProConBlockLink *proConBlockLink, int p_id, Allocator *allocator);
+
+extern void attachScheduleTrace(ScheduleTrace *trace);
+
+extern void attachScheduleAdmission(ScheduleAdmission *admission);
+
 #endif //OPERATORSYSTEMALGORITHM_PROCESS_SCHEDULING_H
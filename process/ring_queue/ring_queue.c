@@ -0,0 +1,132 @@
+/*
+ User: Redskaber
+ Date: 2024/1/21
+ Time: 09:54
+*/
+#include "ring_queue.h"
+
+
+/**
+ * @brief Initializes an empty RingQueue.
+ *
+ * The capacity is rounded up to a power of two, at least RING_QUEUE_INIT_SIZE, so positions wrap with a mask.
+ *
+ * @param capacity The expected number of items.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created RingQueue structure.
+ */
+RingQueue *initRingQueue(uint32_t capacity, Allocator *allocator) {
+
+    uint32_t size = RING_QUEUE_INIT_SIZE;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    RingQueue *queue = allocator->allocate(allocator, sizeof(RingQueue));
+    assert(queue != NULL);
+    queue->items = allocator->allocate(allocator, size * sizeof(uint32_t));
+    assert(queue->items != NULL);
+    queue->head = 0;
+    queue->size = 0;
+    queue->capacity = size;
+    return queue;
+}
+
+/**
+ * @brief Destroys a RingQueue structure.
+ *
+ * @param queue Pointer to the RingQueue structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyRingQueue(RingQueue *queue, Allocator *allocator) {
+
+    if (queue != NULL) {
+        allocator->deallocate(allocator, queue->items, queue->capacity * sizeof(uint32_t));
+        allocator->deallocate(allocator, queue, sizeof(RingQueue));
+    }
+}
+
+/**
+ * @brief Doubles the capacity of a full RingQueue.
+ *
+ * The wrapped part of the ring is copied behind the rest, so the items are contiguous from position 0 afterwards.
+ *
+ * @param queue Pointer to the RingQueue.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+static void upCapacity(RingQueue *queue, Allocator *allocator) {
+
+    uint32_t capacity = queue->capacity;
+    uint32_t *items = allocator->allocate(allocator, 2 * capacity * sizeof(uint32_t));
+    assert(items != NULL);
+
+    uint32_t first = capacity - queue->head;
+    memcpy(items, queue->items + queue->head, first * sizeof(uint32_t));
+    memcpy(items + first, queue->items, queue->head * sizeof(uint32_t));
+
+    allocator->deallocate(allocator, queue->items, capacity * sizeof(uint32_t));
+    queue->items = items;
+    queue->head = 0;
+    queue->capacity = 2 * capacity;
+}
+
+/**
+ * @brief Appends an item to the back of a RingQueue, growing it when full.
+ *
+ * @param queue Pointer to the RingQueue.
+ * @param item The item to be appended.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void pushRingQueue(RingQueue *queue, uint32_t item, Allocator *allocator) {
+
+    if (queue->size == queue->capacity) {
+        upCapacity(queue, allocator);
+    }
+    queue->items[(queue->head + queue->size) & (queue->capacity - 1)] = item;
+    queue->size += 1;
+}
+
+/**
+ * @brief Removes the front item of a non-empty RingQueue.
+ *
+ * @param queue Pointer to the RingQueue.
+ * @return The removed item.
+ */
+uint32_t popRingQueue(RingQueue *queue) {
+
+    assert(queue->size > 0);
+    uint32_t item = queue->items[queue->head];
+    queue->head = (queue->head + 1) & (queue->capacity - 1);
+    queue->size -= 1;
+    return item;
+}
+
+/**
+ * @brief Returns the front item of a non-empty RingQueue without removing it.
+ *
+ * @param queue Pointer to the RingQueue.
+ * @return The front item.
+ */
+uint32_t peekRingQueue(RingQueue *queue) {
+
+    assert(queue->size > 0);
+    return queue->items[queue->head];
+}
+
+/**
+ * @brief Moves the front item of a non-empty RingQueue to its back.
+ *
+ * A slot is freed before it is used, so rotation never grows the RingQueue; it is one load, one store and a mask.
+ *
+ * @param queue Pointer to the RingQueue.
+ * @return The rotated item.
+ */
+uint32_t rotateRingQueue(RingQueue *queue) {
+
+    assert(queue->size > 0);
+    uint32_t mask = queue->capacity - 1;
+    uint32_t item = queue->items[queue->head];
+    queue->items[(queue->head + queue->size) & mask] = item;
+    queue->head = (queue->head + 1) & mask;
+    return item;
+}
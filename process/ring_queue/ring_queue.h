@@ -0,0 +1,40 @@
+/*
+ User: Redskaber
+ Date: 2024/1/21
+ Time: 09:54
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_RING_QUEUE_H
+#define OPERATORSYSTEM_RING_QUEUE_H
+/*
+ * 环形就绪队列(数组实现)
+        连续的 uint32 下标数组, 容量为 2 的幂, 用掩码取模; 满时容量翻倍并把环展开到新数组的开头。
+        轮转(队首移到队尾)、完成出队、新进程入队都是 O(1), 只顺序读写一段连续内存。
+ */
+
+#include <stdint.h>
+#include "../../allocator/memory/memory_allocator.h"
+
+#define RING_QUEUE_INIT_SIZE 16
+
+typedef struct RingQueue {
+    uint32_t *items;
+    uint32_t head;
+    uint32_t size;
+    uint32_t capacity;      // 2 的幂
+} RingQueue;
+
+
+extern RingQueue *initRingQueue(uint32_t capacity, Allocator *allocator);
+
+extern void destroyRingQueue(RingQueue *queue, Allocator *allocator);
+
+extern void pushRingQueue(RingQueue *queue, uint32_t item, Allocator *allocator);
+
+extern uint32_t popRingQueue(RingQueue *queue);
+
+extern uint32_t peekRingQueue(RingQueue *queue);
+
+extern uint32_t rotateRingQueue(RingQueue *queue);
+
+#endif //OPERATORSYSTEM_RING_QUEUE_H
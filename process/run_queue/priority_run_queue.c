@@ -0,0 +1,269 @@
+/*
+ User: Redskaber
+ Date: 2024/1/10
+ Time: 19:36
+*/
+#include "priority_run_queue.h"
+#include "../stats/schedule_stats.h"
+
+
+/**
+ * @brief Initializes a PriorityRunQueue structure.
+ *
+ * This function allocates memory for a new PriorityRunQueue structure and creates one ProConBlockLink per priority level.
+ * The virtual clock starts at 0. A non-positive agingTicks falls back to AGING_TICKS.
+ *
+ * @param agingTicks Number of clock ticks a ProConBlock has to wait to be boosted by one priority level.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created PriorityRunQueue structure.
+ */
+PriorityRunQueue *initPriorityRunQueue(long agingTicks, Allocator *allocator) {
+
+    PriorityRunQueue *runQueue = allocator->allocate(allocator, sizeof(PriorityRunQueue));
+    assert(runQueue != NULL);
+
+    for (int level = 0; level < PRIORITY_LEVELS; ++level) {
+        runQueue->levels[level] = initProConBlockLink(allocator);
+    }
+    runQueue->clock = 0;
+    runQueue->agingTicks = agingTicks > 0 ? agingTicks : AGING_TICKS;
+    runQueue->size = 0;
+    return runQueue;
+}
+
+/**
+ * @brief Destroys a PriorityRunQueue structure.
+ *
+ * This function destroys the ProConBlockLink of every priority level, including the ProConBlocks still waiting in them,
+ * and then deallocates the PriorityRunQueue structure itself.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue structure to be destroyed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroyPriorityRunQueue(PriorityRunQueue *runQueue, Allocator *allocator) {
+
+    if (runQueue != NULL) {
+        for (int level = 0; level < PRIORITY_LEVELS; ++level) {
+            destroyProConBlockLink(runQueue->levels[level], allocator);
+        }
+        allocator->deallocate(allocator, runQueue, sizeof(PriorityRunQueue));
+    }
+}
+
+/**
+ * @brief Adds a ProConBlock to the PriorityRunQueue.
+ *
+ * This function marks the ProConBlock as ready, stamps it with the current virtual clock
+ * and appends it to the FIFO of its base priority level, so every level stays ordered by p_ready_tick.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param proConBlock Pointer to the ProConBlock to be enqueued.
+ */
+void enqueuePriorityRunQueue(PriorityRunQueue *runQueue, ProConBlock *proConBlock) {
+
+    proConBlock->p_state = ready;
+    proConBlock->p_ready_tick = runQueue->clock;
+    appendToLink(proConBlock, runQueue->levels[proConBlock->p_priority]);
+    runQueue->size += 1;
+}
+
+/**
+ * @brief Computes the effective priority of a waiting ProConBlock.
+ *
+ * The effective priority is the base priority raised by one level for every agingTicks the ProConBlock has waited,
+ * capped at exigency. It is computed from the timestamp on demand, so nothing has to be updated while the clock runs.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param proConBlock Pointer to the waiting ProConBlock.
+ * @return The effective priority of the ProConBlock.
+ */
+ProcessPriority effectivePriorityRunQueue(PriorityRunQueue *runQueue, ProConBlock *proConBlock) {
+
+    long boost = (runQueue->clock - proConBlock->p_ready_tick) / runQueue->agingTicks;
+    long priority = (long) proConBlock->p_priority + boost;
+    return priority >= exigency ? exigency : (ProcessPriority) priority;
+}
+
+/**
+ * @brief Removes and returns the ProConBlock with the highest effective priority.
+ *
+ * Only the first ProConBlock of every level is examined: inside a level it has waited the longest and therefore has the highest effective priority.
+ * Ties are broken by the longer wait, then by the higher base priority, so a boosted ProConBlock eventually overtakes a stream of new arrivals.
+ * The cost is O(PRIORITY_LEVELS) per dispatch, independent of the number of waiting ProConBlocks; it is recorded as a pick-next latency.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @return Pointer to the dequeued ProConBlock, NULL if the PriorityRunQueue is empty.
+ */
+ProConBlock *dequeuePriorityRunQueue(PriorityRunQueue *runQueue) {
+
+    uint64_t start = scheduleStatsNow();
+    uint64_t comparisons = 0;
+    int bestLevel = -1;
+    ProcessPriority bestPriority = low;
+    ProConBlock *best = NULL;
+
+    for (int level = PRIORITY_LEVELS - 1; level >= 0; --level) {
+        ProConBlock *first = runQueue->levels[level]->headProConBlock->aftProConBlock;
+        if (first == NULL) {
+            continue;
+        }
+        ProcessPriority priority = effectivePriorityRunQueue(runQueue, first);
+        comparisons += best != NULL;
+        if (best == NULL || priority > bestPriority ||
+            (priority == bestPriority && first->p_ready_tick < best->p_ready_tick)) {
+            best = first;
+            bestPriority = priority;
+            bestLevel = level;
+        }
+    }
+
+    if (best != NULL) {
+        detachProConBlockFromLink(runQueue->levels[bestLevel], best);
+        runQueue->size -= 1;
+    }
+    countScheduleStats(counter_comparisons, comparisons);
+    recordScheduleLatency(latency_pick_next, start);
+    return best;
+}
+
+/**
+ * @brief Advances the virtual clock of the PriorityRunQueue.
+ *
+ * Aging is derived from the clock, so advancing it is O(1) and does not touch the waiting ProConBlocks.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param ticks Number of ticks to advance.
+ */
+void advancePriorityRunQueue(PriorityRunQueue *runQueue, long ticks) {
+    runQueue->clock += ticks;
+}
+
+/**
+ * @brief Finds a waiting ProConBlock by its process ID.
+ *
+ * This function asks the p_id index of every level, which is O(PRIORITY_LEVELS).
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param p_id The process ID of the ProConBlock.
+ * @return Pointer to the ProConBlock if found, NULL otherwise.
+ */
+ProConBlock *findFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id) {
+
+    for (int level = 0; level < PRIORITY_LEVELS; ++level) {
+        ProConBlock *proConBlock = findProConBlockFromLink(runQueue->levels[level], p_id);
+        if (proConBlock != NULL) {
+            return proConBlock;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Changes the base priority of a waiting ProConBlock.
+ *
+ * This function moves the ProConBlock to the end of the level of its new priority.
+ * Its p_ready_tick is restarted so that the new level stays ordered by waiting time.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param p_id The process ID of the ProConBlock.
+ * @param p_priority The new priority of the ProConBlock.
+ * @return Pointer to the updated ProConBlock if found, NULL otherwise.
+ */
+ProConBlock *reniceFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id, ProcessPriority p_priority) {
+
+    ProConBlock *proConBlock = findFromPriorityRunQueue(runQueue, p_id);
+    if (proConBlock != NULL) {
+        detachProConBlockFromLink(runQueue->levels[proConBlock->p_priority], proConBlock);
+        runQueue->size -= 1;
+        proConBlock->p_priority = p_priority;
+        enqueuePriorityRunQueue(runQueue, proConBlock);
+    }
+    return proConBlock;
+}
+
+/**
+ * @brief Terminates a waiting ProConBlock.
+ *
+ * @param runQueue Pointer to the PriorityRunQueue.
+ * @param p_id The process ID of the ProConBlock to be terminated.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Boolean value indicating whether a ProConBlock with the process ID was found and terminated.
+ */
+_Bool killFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id, Allocator *allocator) {
+
+    ProConBlock *proConBlock = findFromPriorityRunQueue(runQueue, p_id);
+    if (proConBlock == NULL) {
+        return false;
+    }
+    killProConBlockFromLink(runQueue->levels[proConBlock->p_priority], p_id, allocator);
+    runQueue->size -= 1;
+    return true;
+}
+
+/**
+ * @brief Implements preemptive priority scheduling with aging for a ProConBlockLink.
+ *
+ * This function moves all ProConBlocks of the ProConBlockLink into a PriorityRunQueue and then repeatedly dispatches the ProConBlock with
+ * the highest effective priority for one time slice by calling runningProConBlockTask.
+ * The virtual clock advances by the executed time; an unfinished ProConBlock is enqueued again, a finished one is appended back to the ProConBlockLink.
+ * Because waiting raises the effective priority, low priority ProConBlocks cannot starve behind a stream of higher priority work.
+ * After the function call the ProConBlockLink holds the ProConBlocks in completion order.
+ * A ProConBlock refused by an attached ScheduleAdmission waits outside the PriorityRunQueue until another one finishes and releases its resources;
+ * ProConBlocks still waiting when the PriorityRunQueue runs empty are appended blocked after the finished ones, in the order they were refused.
+ * The PriorityRunQueue is allocated from the allocator of the ProConBlockLink and released before the function returns.
+ *
+ * @param proConBlockLink Pointer to the ProConBlockLink to be scheduled.
+ */
+void priorityAgingScheduling(ProConBlockLink *proConBlockLink) {
+
+    Allocator *allocator = proConBlockLink->allocator;
+    PriorityRunQueue *runQueue = initPriorityRunQueue(AGING_TICKS, allocator);
+
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        ProConBlock *aftProConBlock = proConBlock->aftProConBlock;
+        enqueuePriorityRunQueue(runQueue, detachProConBlockFromLink(proConBlockLink, proConBlock));
+        proConBlock = aftProConBlock;
+    }
+
+    // refused ProConBlocks, chained through aftProConBlock in the order they were refused
+    ProConBlock *refused = NULL;
+    ProConBlock *lastRefused = NULL;
+    while ((proConBlock = dequeuePriorityRunQueue(runQueue)) != NULL) {
+        double executeTime = proConBlock->p_execute_time;
+        proConBlock = runningProConBlockTask(proConBlock);
+        if (proConBlock->p_state == blocked) {
+            if (lastRefused != NULL) {
+                lastRefused->aftProConBlock = proConBlock;
+            } else {
+                refused = proConBlock;
+            }
+            lastRefused = proConBlock;
+            continue;
+        }
+        long ticks = (long) (proConBlock->p_execute_time - executeTime);
+        advancePriorityRunQueue(runQueue, ticks > 0 ? ticks : 1);
+
+        if (proConBlock->p_execute_time >= proConBlock->p_total_time) {
+            appendToLink(proConBlock, proConBlockLink);
+            // resources were released: the refused ones compete again
+            while (refused != NULL) {
+                ProConBlock *aftProConBlock = refused->aftProConBlock;
+                refused->aftProConBlock = NULL;
+                enqueuePriorityRunQueue(runQueue, refused);
+                refused = aftProConBlock;
+            }
+            lastRefused = NULL;
+        } else {
+            enqueuePriorityRunQueue(runQueue, proConBlock);
+        }
+    }
+    while (refused != NULL) {
+        ProConBlock *aftProConBlock = refused->aftProConBlock;
+        appendToLink(refused, proConBlockLink);
+        refused = aftProConBlock;
+    }
+
+    destroyPriorityRunQueue(runQueue, allocator);
+    displayProConBlockLink(proConBlockLink);
+}
@@ -0,0 +1,51 @@
+/*
+ User: Redskaber
+ Date: 2024/1/10
+ Time: 19:36
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_PRIORITY_RUN_QUEUE_H
+#define OPERATORSYSTEM_PRIORITY_RUN_QUEUE_H
+/*
+ * 多级就绪队列 + 优先级老化(aging)
+        每个优先级一条 FIFO 就绪队列, 进程入队时记录虚拟时钟 p_ready_tick。
+        有效优先级 = 基础优先级 + (clock - p_ready_tick) / agingTicks, 最高为 exigency。
+
+        同一队列按入队时间排序, 队首等待最久、有效优先级最高,
+        所以调度只需比较各级队首(PRIORITY_LEVELS 个), 时钟前进也不需要遍历等待进程。
+ */
+
+#include "../process_scheduling.h"
+
+#define PRIORITY_LEVELS (exigency + 1)
+#define AGING_TICKS 20
+
+typedef struct PriorityRunQueue {
+    ProConBlockLink *levels[PRIORITY_LEVELS];
+    long clock;
+    long agingTicks;
+    int size;
+} PriorityRunQueue;
+
+
+extern PriorityRunQueue *initPriorityRunQueue(long agingTicks, Allocator *allocator);
+
+extern void destroyPriorityRunQueue(PriorityRunQueue *runQueue, Allocator *allocator);
+
+extern void enqueuePriorityRunQueue(PriorityRunQueue *runQueue, ProConBlock *proConBlock);
+
+extern ProConBlock *dequeuePriorityRunQueue(PriorityRunQueue *runQueue);
+
+extern void advancePriorityRunQueue(PriorityRunQueue *runQueue, long ticks);
+
+extern ProcessPriority effectivePriorityRunQueue(PriorityRunQueue *runQueue, ProConBlock *proConBlock);
+
+extern ProConBlock *findFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id);
+
+extern ProConBlock *reniceFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id, ProcessPriority p_priority);
+
+extern _Bool killFromPriorityRunQueue(PriorityRunQueue *runQueue, int p_id, Allocator *allocator);
+
+extern void priorityAgingScheduling(ProConBlockLink *proConBlockLink);
+
+#endif //OPERATORSYSTEM_PRIORITY_RUN_QUEUE_H
@@ -0,0 +1,330 @@
+/*
+ User: Redskaber
+ Date: 2024/1/18
+ Time: 20:26
+*/
+#include "schedule_stats.h"
+#include "../run_queue/priority_run_queue.h"
+
+
+// 每个线程独占的统计分片
+typedef struct ScheduleStatsShard {
+    _Atomic uint64_t counters[SCHEDULE_POLICIES][SCHEDULE_COUNTERS];
+    _Atomic uint64_t count[SCHEDULE_POLICIES][SCHEDULE_LATENCIES];
+    _Atomic uint64_t sum[SCHEDULE_POLICIES][SCHEDULE_LATENCIES];
+    _Atomic uint64_t max[SCHEDULE_POLICIES][SCHEDULE_LATENCIES];
+    _Atomic uint64_t buckets[SCHEDULE_POLICIES][SCHEDULE_LATENCIES][SCHEDULE_STATS_BUCKETS];
+    struct ScheduleStatsShard *next;
+} ScheduleStatsShard;
+
+// 已退出线程的统计之和, 始终是链表的最后一个分片
+static ScheduleStatsShard retiredShard;
+
+static pthread_mutex_t shardMutex = PTHREAD_MUTEX_INITIALIZER;
+static ScheduleStatsShard *shards = &retiredShard;
+static pthread_once_t shardKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t shardKey;
+
+static _Thread_local ScheduleStatsShard *localShard = NULL;
+static _Thread_local SchedulePolicy localPolicy = policy_other;
+
+
+/**
+ * @brief Adds a value to a shard field.
+ *
+ * Only the owning thread writes a shard, so a relaxed load and store is enough and no locked instruction is needed.
+ *
+ * @param field Pointer to the field.
+ * @param amount The value to be added.
+ */
+static inline void addRelaxed(_Atomic uint64_t *field, uint64_t amount) {
+    atomic_store_explicit(field, atomic_load_explicit(field, memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Folds the shard of an exiting thread into the retired shard and frees it.
+ *
+ * This is the destructor of shardKey, so it runs on the exiting thread. The shard is unlinked and folded under the mutex,
+ * so a concurrent snapshot sees its statistics either in the shard or in the retired shard, never twice or not at all.
+ *
+ * @param args Pointer to the ScheduleStatsShard of the exiting thread.
+ */
+static void retireShard(void *args) {
+
+    ScheduleStatsShard *shard = args;
+    pthread_mutex_lock(&shardMutex);
+    ScheduleStatsShard **link = &shards;
+    while (*link != shard) {
+        link = &(*link)->next;
+    }
+    *link = shard->next;
+
+    for (int policy = 0; policy < SCHEDULE_POLICIES; ++policy) {
+        for (int counter = 0; counter < SCHEDULE_COUNTERS; ++counter) {
+            addRelaxed(&retiredShard.counters[policy][counter],
+                       atomic_load_explicit(&shard->counters[policy][counter], memory_order_relaxed));
+        }
+        for (int latency = 0; latency < SCHEDULE_LATENCIES; ++latency) {
+            uint64_t max = atomic_load_explicit(&shard->max[policy][latency], memory_order_relaxed);
+            addRelaxed(&retiredShard.count[policy][latency],
+                       atomic_load_explicit(&shard->count[policy][latency], memory_order_relaxed));
+            addRelaxed(&retiredShard.sum[policy][latency],
+                       atomic_load_explicit(&shard->sum[policy][latency], memory_order_relaxed));
+            if (max > atomic_load_explicit(&retiredShard.max[policy][latency], memory_order_relaxed)) {
+                atomic_store_explicit(&retiredShard.max[policy][latency], max, memory_order_relaxed);
+            }
+            for (int bucket = 0; bucket < SCHEDULE_STATS_BUCKETS; ++bucket) {
+                addRelaxed(&retiredShard.buckets[policy][latency][bucket],
+                           atomic_load_explicit(&shard->buckets[policy][latency][bucket], memory_order_relaxed));
+            }
+        }
+    }
+    pthread_mutex_unlock(&shardMutex);
+
+    localShard = NULL;
+    free(shard);
+}
+
+/**
+ * @brief Creates the thread key whose destructor retires the shard of an exiting thread.
+ */
+static void createShardKey(void) {
+    int result = pthread_key_create(&shardKey, retireShard);
+    assert(result == 0);
+    (void) result;
+}
+
+/**
+ * @brief Returns the shard of the calling thread, creating and registering it on first use.
+ *
+ * The mutex is only taken once per thread; every later update touches the shard of the thread alone.
+ * The shard is bound to shardKey, so it is folded into the retired shard and freed when the thread exits.
+ *
+ * @return Pointer to the ScheduleStatsShard of the calling thread.
+ */
+static ScheduleStatsShard *currentShard(void) {
+
+    if (localShard == NULL) {
+        pthread_once(&shardKeyOnce, createShardKey);
+        ScheduleStatsShard *shard = (ScheduleStatsShard *) calloc(1, sizeof(ScheduleStatsShard));
+        assert(shard != NULL);
+        pthread_mutex_lock(&shardMutex);
+        shard->next = shards;
+        shards = shard;
+        pthread_mutex_unlock(&shardMutex);
+        pthread_setspecific(shardKey, shard);
+        localShard = shard;
+    }
+    return localShard;
+}
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return The current value of CLOCK_MONOTONIC in nanoseconds.
+ */
+uint64_t scheduleStatsNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief Maps the sorting and execution functions of runningProConBlockFromLink to a SchedulePolicy.
+ *
+ * The preemptive policies are identified by their execution function, the others by their sorting function.
+ * A NULL sorting function means firstComeFirstServe, as in runningProConBlockFromLink.
+ *
+ * @param proSortFunc Function pointer to the sorting function.
+ * @param proExeFunc Function pointer to the execution function.
+ * @return The SchedulePolicy, policy_other for unknown functions.
+ */
+SchedulePolicy selectSchedulePolicy(
+        void (*proSortFunc)(ProConBlockLink *sortLink),
+        void (*proExeFunc)(ProConBlockLink *exeLink)
+) {
+    if (proExeFunc == roundRobinScheduling) {
+        return policy_round_robin;
+    }
+    if (proExeFunc == priorityAgingScheduling) {
+        return policy_priority_aging;
+    }
+    if (proSortFunc == NULL || proSortFunc == firstComeFirstServe) {
+        return policy_first_come_first_serve;
+    }
+    if (proSortFunc == shortestJobNext) {
+        return policy_shortest_job_next;
+    }
+    if (proSortFunc == priorityScheduling) {
+        return policy_priority;
+    }
+    return policy_other;
+}
+
+/**
+ * @brief Sets the policy that the statistics of the calling thread are attributed to.
+ *
+ * @param policy The new SchedulePolicy.
+ * @return The previous SchedulePolicy, to be restored by the caller.
+ */
+SchedulePolicy switchSchedulePolicy(SchedulePolicy policy) {
+    SchedulePolicy previous = localPolicy;
+    localPolicy = policy;
+    return previous;
+}
+
+/**
+ * @brief Adds to a counter of the current policy.
+ *
+ * @param counter The counter to be increased.
+ * @param amount The value to be added.
+ */
+void countScheduleStats(ScheduleCounter counter, uint64_t amount) {
+    addRelaxed(&currentShard()->counters[localPolicy][counter], amount);
+}
+
+/**
+ * @brief Records a latency sample of the current policy.
+ *
+ * The elapsed time since start goes into the log2 bucket of its highest set bit, so recording is O(1) and the histogram has a fixed size.
+ *
+ * @param latency The latency histogram to be updated.
+ * @param start Timestamp returned by scheduleStatsNow when the measured operation began.
+ */
+void recordScheduleLatency(ScheduleLatency latency, uint64_t start) {
+
+    uint64_t elapsed = scheduleStatsNow() - start;
+    ScheduleStatsShard *shard = currentShard();
+    int bucket = elapsed == 0 ? 0 : 63 - __builtin_clzll(elapsed);
+
+    addRelaxed(&shard->count[localPolicy][latency], 1);
+    addRelaxed(&shard->sum[localPolicy][latency], elapsed);
+    addRelaxed(&shard->buckets[localPolicy][latency][bucket], 1);
+    if (elapsed > atomic_load_explicit(&shard->max[localPolicy][latency], memory_order_relaxed)) {
+        atomic_store_explicit(&shard->max[localPolicy][latency], elapsed, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Sums the shards of all threads into a snapshot.
+ *
+ * The shards are read while their threads keep running, so a snapshot taken during a run is consistent per field but not across fields.
+ *
+ * @param snapshot Pointer to the ScheduleStats to be filled.
+ */
+void snapshotScheduleStats(ScheduleStats *snapshot) {
+
+    memset(snapshot, 0, sizeof(ScheduleStats));
+    pthread_mutex_lock(&shardMutex);
+    for (ScheduleStatsShard *shard = shards; shard != NULL; shard = shard->next) {
+        for (int policy = 0; policy < SCHEDULE_POLICIES; ++policy) {
+            for (int counter = 0; counter < SCHEDULE_COUNTERS; ++counter) {
+                snapshot->counters[policy][counter] +=
+                        atomic_load_explicit(&shard->counters[policy][counter], memory_order_relaxed);
+            }
+            for (int latency = 0; latency < SCHEDULE_LATENCIES; ++latency) {
+                ScheduleHistogram *histogram = &snapshot->latencies[policy][latency];
+                uint64_t max = atomic_load_explicit(&shard->max[policy][latency], memory_order_relaxed);
+                histogram->count += atomic_load_explicit(&shard->count[policy][latency], memory_order_relaxed);
+                histogram->sum += atomic_load_explicit(&shard->sum[policy][latency], memory_order_relaxed);
+                histogram->max = max > histogram->max ? max : histogram->max;
+                for (int bucket = 0; bucket < SCHEDULE_STATS_BUCKETS; ++bucket) {
+                    histogram->buckets[bucket] +=
+                            atomic_load_explicit(&shard->buckets[policy][latency][bucket], memory_order_relaxed);
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&shardMutex);
+}
+
+/**
+ * @brief Clears the statistics of all threads.
+ *
+ * Samples recorded concurrently with the reset may survive it.
+ */
+void resetScheduleStats(void) {
+
+    pthread_mutex_lock(&shardMutex);
+    for (ScheduleStatsShard *shard = shards; shard != NULL; shard = shard->next) {
+        for (int policy = 0; policy < SCHEDULE_POLICIES; ++policy) {
+            for (int counter = 0; counter < SCHEDULE_COUNTERS; ++counter) {
+                atomic_store_explicit(&shard->counters[policy][counter], 0, memory_order_relaxed);
+            }
+            for (int latency = 0; latency < SCHEDULE_LATENCIES; ++latency) {
+                atomic_store_explicit(&shard->count[policy][latency], 0, memory_order_relaxed);
+                atomic_store_explicit(&shard->sum[policy][latency], 0, memory_order_relaxed);
+                atomic_store_explicit(&shard->max[policy][latency], 0, memory_order_relaxed);
+                for (int bucket = 0; bucket < SCHEDULE_STATS_BUCKETS; ++bucket) {
+                    atomic_store_explicit(&shard->buckets[policy][latency][bucket], 0, memory_order_relaxed);
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&shardMutex);
+}
+
+/**
+ * @brief Estimates a percentile of a latency histogram.
+ *
+ * The percentile is located by nearest rank, the sample at rank ceil(percentile * count).
+ * The result is the upper bound of the bucket that contains that sample, capped at the recorded maximum,
+ * so it never under-reports a regression.
+ *
+ * @param histogram Pointer to the ScheduleHistogram.
+ * @param percentile The percentile in (0, 1], for example 0.99.
+ * @return The estimated latency in nanoseconds, 0 if the histogram is empty.
+ */
+uint64_t percentileScheduleHistogram(const ScheduleHistogram *histogram, double percentile) {
+
+    if (histogram->count == 0) {
+        return 0;
+    }
+    // nearest rank: the smallest rank covering the percentile, ceil(percentile * count), within [1, count]
+    double exact = percentile * (double) histogram->count - 1e-9;
+    uint64_t rank = exact > 0 ? (uint64_t) exact : 0;
+    rank += (double) rank < exact ? 1 : 0;
+    rank = rank == 0 ? 1 : rank > histogram->count ? histogram->count : rank;
+
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < SCHEDULE_STATS_BUCKETS; ++bucket) {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank) {
+            uint64_t upper = bucket >= 63 ? UINT64_MAX : ((uint64_t) 1 << (bucket + 1)) - 1;
+            return upper < histogram->max ? upper : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/**
+ * @brief Displays the counters and latency summaries of every policy that has recorded anything.
+ *
+ * @param snapshot Pointer to the ScheduleStats to be displayed.
+ */
+void displayScheduleStats(const ScheduleStats *snapshot) {
+
+    printf_s("##########################################################################################################\n");
+    printf_s("%-24s %9s %10s %11s %11s | %11s %11s %11s %11s\n", "policy", "enqueues", "dispatches", "preemptions",
+             "comparisons", "pick p50", "pick p99", "enq p50", "enq p99");
+    for (SchedulePolicy policy = policy_first_come_first_serve; policy < SCHEDULE_POLICIES; ++policy) {
+        const uint64_t *counters = snapshot->counters[policy];
+        const ScheduleHistogram *pickNext = &snapshot->latencies[policy][latency_pick_next];
+        const ScheduleHistogram *enqueue = &snapshot->latencies[policy][latency_enqueue];
+        if (counters[counter_enqueues] == 0 && counters[counter_dispatches] == 0 &&
+            pickNext->count == 0 && enqueue->count == 0) {
+            continue;
+        }
+        printf_s("%-24s %9llu %10llu %11llu %11llu | %9lluns %9lluns %9lluns %9lluns\n",
+                 schedulePolicyToString(policy),
+                 (unsigned long long) counters[counter_enqueues],
+                 (unsigned long long) counters[counter_dispatches],
+                 (unsigned long long) counters[counter_preemptions],
+                 (unsigned long long) counters[counter_comparisons],
+                 (unsigned long long) percentileScheduleHistogram(pickNext, 0.50),
+                 (unsigned long long) percentileScheduleHistogram(pickNext, 0.99),
+                 (unsigned long long) percentileScheduleHistogram(enqueue, 0.50),
+                 (unsigned long long) percentileScheduleHistogram(enqueue, 0.99));
+    }
+    printf_s("##########################################################################################################\n");
+}
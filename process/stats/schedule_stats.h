@@ -0,0 +1,101 @@
+/*
+ User: Redskaber
+ Date: 2024/1/18
+ Time: 20:26
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SCHEDULE_STATS_H
+#define OPERATORSYSTEM_SCHEDULE_STATS_H
+/*
+ * 调度器热路径统计(常开)
+        按调度策略分别统计:
+            - 计数: 入队、调度(执行一个时间片)、抢占、比较次数
+            - 延迟直方图: 选择下一个进程(pick-next)、入队(enqueue), clock_gettime 纳秒, log2 分桶
+
+        每个线程第一次记录时创建自己的分片(shard)并登记到全局链表, 之后只写自己的分片(relaxed 原子读写, 无锁、无竞争),
+        snapshotScheduleStats 把所有分片相加得到快照。
+        线程结束时(pthread_key 析构函数)分片的统计并入已退出线程的总和, 分片随即释放, 它的统计仍计入快照。
+        当前策略由 runningProConBlockFromLink 按排序/执行函数设置, 其它入口记在 policy_other。
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "../process_scheduling.h"
+
+#define SCHEDULE_STATS_BUCKETS 64
+
+typedef enum SchedulePolicy {
+    policy_first_come_first_serve,
+    policy_shortest_job_next,
+    policy_priority,
+    policy_round_robin,
+    policy_priority_aging,
+    policy_other,
+} SchedulePolicy;
+
+typedef enum ScheduleCounter {
+    counter_enqueues,
+    counter_dispatches,
+    counter_preemptions,
+    counter_comparisons,
+} ScheduleCounter;
+
+typedef enum ScheduleLatency {
+    latency_pick_next,
+    latency_enqueue,
+} ScheduleLatency;
+
+#define SCHEDULE_POLICIES (policy_other + 1)
+#define SCHEDULE_COUNTERS (counter_comparisons + 1)
+#define SCHEDULE_LATENCIES (latency_enqueue + 1)
+
+// 直方图: buckets[i] 统计 [2^i, 2^(i+1)) 纳秒, buckets[0] 还包含 0
+typedef struct ScheduleHistogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[SCHEDULE_STATS_BUCKETS];
+} ScheduleHistogram;
+
+// 快照
+typedef struct ScheduleStats {
+    uint64_t counters[SCHEDULE_POLICIES][SCHEDULE_COUNTERS];
+    ScheduleHistogram latencies[SCHEDULE_POLICIES][SCHEDULE_LATENCIES];
+} ScheduleStats;
+
+
+#define schedulePolicyToString(policy) _Generic((policy),                   \
+    enum SchedulePolicy:                                                    \
+        (policy == policy_first_come_first_serve) ? "firstComeFirstServe" : \
+        (policy == policy_shortest_job_next) ? "shortestJobNext" :          \
+        (policy == policy_priority) ? "priorityScheduling" :                \
+        (policy == policy_round_robin) ? "roundRobinScheduling" :           \
+        (policy == policy_priority_aging) ? "priorityAgingScheduling" :     \
+        (policy == policy_other) ? "other" : "UNKNOWN"                      \
+)
+
+
+extern uint64_t scheduleStatsNow(void);
+
+extern SchedulePolicy selectSchedulePolicy(
+        void (*proSortFunc)(ProConBlockLink *sortLink),
+        void (*proExeFunc)(ProConBlockLink *exeLink)
+);
+
+extern SchedulePolicy switchSchedulePolicy(SchedulePolicy policy);
+
+extern void countScheduleStats(ScheduleCounter counter, uint64_t amount);
+
+extern void recordScheduleLatency(ScheduleLatency latency, uint64_t start);
+
+extern void snapshotScheduleStats(ScheduleStats *snapshot);
+
+extern void resetScheduleStats(void);
+
+extern uint64_t percentileScheduleHistogram(const ScheduleHistogram *histogram, double percentile);
+
+extern void displayScheduleStats(const ScheduleStats *snapshot);
+
+#endif //OPERATORSYSTEM_SCHEDULE_STATS_H
@@ -0,0 +1,300 @@
+/*
+ User: Redskaber
+ Date: 2024/1/16
+ Time: 10:42
+*/
+#include "policy_sweep.h"
+
+
+typedef struct SweepTask {
+    ProConBlockLink *workload;
+    SweepConfig config;
+    SweepResult *result;
+} SweepTask;
+
+
+/**
+ * @brief Creates a private copy of a workload.
+ *
+ * This function copies every ProConBlock of the workload into a new ProConBlockLink, keeping the order of the workload.
+ * Only the ProConBlock structures are copied; the process name and the callback are shared with the workload, which is never written.
+ *
+ * @param workload Pointer to the ProConBlockLink holding the workload.
+ * @param allocator Pointer to the Allocator structure of the calling thread.
+ * @return Pointer to the private ProConBlockLink.
+ */
+static ProConBlockLink *copyWorkload(ProConBlockLink *workload, Allocator *allocator) {
+
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlock = workload->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        ProConBlock *copy = allocator->allocate(allocator, sizeof(ProConBlock));
+        assert(copy != NULL);
+        *copy = *proConBlock;
+        copy->p_state = new;
+        copy->p_ready_tick = 0;
+        appendToLink(copy, proConBlockLink);
+        proConBlock = proConBlock->aftProConBlock;
+    }
+    return proConBlockLink;
+}
+
+/**
+ * @brief Counts the ProConBlocks of a workload.
+ *
+ * The link is walked instead of reading the size of the index, so the count always matches the number of copies copyWorkload makes.
+ *
+ * @param workload Pointer to the ProConBlockLink holding the workload.
+ * @return Number of ProConBlocks in the workload.
+ */
+static int countWorkload(ProConBlockLink *workload) {
+
+    int member = 0;
+    for (ProConBlock *proConBlock = workload->headProConBlock->aftProConBlock;
+         proConBlock != NULL; proConBlock = proConBlock->aftProConBlock) {
+        member += 1;
+    }
+    return member;
+}
+
+/**
+ * @brief Releases a private ProConBlockLink.
+ *
+ * The ProConBlocks are released one by one instead of through the recursive destroyProConBlock, so large workloads do not exhaust the stack.
+ *
+ * @param proConBlockLink Pointer to the private ProConBlockLink.
+ * @param allocator Pointer to the Allocator structure of the calling thread.
+ */
+static void releaseWorkload(ProConBlockLink *proConBlockLink, Allocator *allocator) {
+
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        ProConBlock *aftProConBlock = proConBlock->aftProConBlock;
+        allocator->deallocate(allocator, detachProConBlockFromLink(proConBlockLink, proConBlock), sizeof(ProConBlock));
+        proConBlock = aftProConBlock;
+    }
+    destroyProConBlockLink(proConBlockLink, allocator);
+}
+
+/**
+ * @brief Runs one time slice of a ProConBlock in the silent simulation.
+ *
+ * The length of the slice follows runningProConBlockTask: a ProConBlock that would finish within the slice, or that is alone, runs to completion.
+ * The response time is recorded the first time a ProConBlock is dispatched, the waiting and turnaround times when it finishes.
+ *
+ * @param proConBlock Pointer to the dispatched ProConBlock.
+ * @param timeSlice Length of the time slice, 0 for run to completion.
+ * @param alone Boolean value indicating whether no other ProConBlock is waiting.
+ * @param now Pointer to the simulated time, advanced by the executed time.
+ * @param lastId Pointer to the process ID of the previously dispatched ProConBlock.
+ * @param result Pointer to the SweepResult accumulating the sums.
+ * @return Boolean value indicating whether the ProConBlock has finished.
+ */
+static _Bool runSlice(ProConBlock *proConBlock, int timeSlice, _Bool alone, double *now, int *lastId, SweepResult *result) {
+
+    if (proConBlock->p_execute_time == 0) {
+        result->avgResponse += *now;
+    }
+    if (result->dispatches > 0 && *lastId != proConBlock->p_id) {
+        result->contextSwitches += 1;
+    }
+    result->dispatches += 1;
+    *lastId = proConBlock->p_id;
+
+    if (timeSlice <= 0 || alone || proConBlock->p_execute_time + timeSlice >= proConBlock->p_total_time) {
+        *now += proConBlock->p_total_time - proConBlock->p_execute_time;
+        proConBlock->p_execute_time = proConBlock->p_total_time;
+        proConBlock->p_state = terminated;
+
+        double waiting = *now - proConBlock->p_total_time;
+        result->avgTurnaround += *now;
+        result->avgWaiting += waiting;
+        result->maxWaiting = waiting > result->maxWaiting ? waiting : result->maxWaiting;
+        return true;
+    }
+    *now += timeSlice;
+    proConBlock->p_execute_time += timeSlice;
+    proConBlock->p_state = suspended_blocked;
+    return false;
+}
+
+/**
+ * @brief Simulates one scheduling policy over a workload without side effects.
+ *
+ * This function creates its own Allocator and a private copy of the workload, so it can run on any thread.
+ * The non-preemptive policies reuse the ordering functions of the scheduler (firstComeFirstServe, shortestJobNext, priorityScheduling)
+ * and run every ProConBlock to completion. Round robin and priority aging start from the firstComeFirstServe order, as runningProConBlockFromLink does,
+ * and use the time slice of the SweepConfig instead of TIME_SLICE; aging dispatches through a PriorityRunQueue.
+ * Callbacks are not invoked. With the default time slice and aging interval the results equal those of the real policy functions,
+ * which the tests check against a ScheduleTrace of the scheduler.
+ *
+ * @param workload Pointer to the ProConBlockLink holding the workload, read only.
+ * @param config The policy and its parameters.
+ * @param result Pointer to the SweepResult to be filled.
+ */
+void simulatePolicy(ProConBlockLink *workload, SweepConfig config, SweepResult *result) {
+
+    memset(result, 0, sizeof(SweepResult));
+    result->config = config;
+    result->member = countWorkload(workload);
+    int timeSlice = config.timeSlice > 0 ? config.timeSlice : TIME_SLICE;
+
+    Allocator *allocator = createAllocator(SWEEP_ALLOCATE_SIZE(result->member));
+    ProConBlockLink *proConBlockLink = copyWorkload(workload, allocator);
+    double now = 0;
+    int lastId = 0;
+
+    switch (config.policy) {
+        case sweep_shortest_job_next:
+            shortestJobNext(proConBlockLink);
+            break;
+        case sweep_priority:
+            priorityScheduling(proConBlockLink);
+            break;
+        default:
+            firstComeFirstServe(proConBlockLink);
+            break;
+    }
+
+    ProConBlock *proConBlock = NULL;
+    if (config.policy == sweep_round_robin) {
+        while ((proConBlock = proConBlockLink->headProConBlock->aftProConBlock) != NULL) {
+            detachProConBlockFromLink(proConBlockLink, proConBlock);
+            _Bool alone = proConBlockLink->headProConBlock->aftProConBlock == NULL;
+            if (runSlice(proConBlock, timeSlice, alone, &now, &lastId, result)) {
+                allocator->deallocate(allocator, proConBlock, sizeof(ProConBlock));
+            } else {
+                appendToLink(proConBlock, proConBlockLink);
+            }
+        }
+
+    } else if (config.policy == sweep_priority_aging) {
+        PriorityRunQueue *runQueue = initPriorityRunQueue(config.agingTicks, allocator);
+        while ((proConBlock = proConBlockLink->headProConBlock->aftProConBlock) != NULL) {
+            enqueuePriorityRunQueue(runQueue, detachProConBlockFromLink(proConBlockLink, proConBlock));
+        }
+        while ((proConBlock = dequeuePriorityRunQueue(runQueue)) != NULL) {
+            double start = now;
+            // as in priorityAgingScheduling, a dequeued ProConBlock is never linked to itself, so it is not run to completion when alone
+            _Bool finished = runSlice(proConBlock, timeSlice, false, &now, &lastId, result);
+            long ticks = (long) (now - start);
+            advancePriorityRunQueue(runQueue, ticks > 0 ? ticks : 1);
+            if (finished) {
+                allocator->deallocate(allocator, proConBlock, sizeof(ProConBlock));
+            } else {
+                enqueuePriorityRunQueue(runQueue, proConBlock);
+            }
+        }
+        destroyPriorityRunQueue(runQueue, allocator);
+
+    } else {
+        proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+        while (proConBlock != NULL) {
+            runSlice(proConBlock, 0, true, &now, &lastId, result);
+            proConBlock = proConBlock->aftProConBlock;
+        }
+    }
+
+    releaseWorkload(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+
+    result->makespan = now;
+    if (result->member > 0) {
+        result->avgTurnaround /= result->member;
+        result->avgWaiting /= result->member;
+        result->avgResponse /= result->member;
+    }
+}
+
+/**
+ * @brief Thread entry point of runPolicySweep.
+ *
+ * @param args Pointer to the SweepTask of the thread.
+ * @return NULL.
+ */
+static void *sweepWorker(void *args) {
+    SweepTask *task = args;
+    simulatePolicy(task->workload, task->config, task->result);
+    return NULL;
+}
+
+/**
+ * @brief Runs several scheduling policies over one workload concurrently.
+ *
+ * This function starts one thread per SweepConfig. Every thread copies the workload with its own Allocator and fills its own SweepResult,
+ * so the threads share nothing but the read-only workload and the sweep takes about as long as its slowest configuration.
+ * If a thread cannot be started, its configuration is simulated on the calling thread instead.
+ * The workload must not be modified until the function returns.
+ *
+ * @param workload Pointer to the ProConBlockLink holding the workload.
+ * @param configs Array of the configurations to be compared.
+ * @param count Number of configurations.
+ * @param allocator Pointer to the Allocator structure used for the results.
+ * @return Array of count SweepResults in the order of configs, released with destroySweepResults.
+ */
+SweepResult *runPolicySweep(ProConBlockLink *workload, const SweepConfig *configs, int count, Allocator *allocator) {
+
+    assert(count > 0);
+    SweepResult *results = allocator->allocate(allocator, count * sizeof(SweepResult));
+    SweepTask *tasks = allocator->allocate(allocator, count * sizeof(SweepTask));
+    pthread_t *threads = allocator->allocate(allocator, count * sizeof(pthread_t));
+    _Bool *started = allocator->allocate(allocator, count * sizeof(_Bool));
+    assert(results != NULL && tasks != NULL && threads != NULL && started != NULL);
+
+    for (int i = 0; i < count; ++i) {
+        tasks[i].workload = workload;
+        tasks[i].config = configs[i];
+        tasks[i].result = &results[i];
+        started[i] = pthread_create(&threads[i], NULL, sweepWorker, &tasks[i]) == 0;
+        if (!started[i]) {
+            sweepWorker(&tasks[i]);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    allocator->deallocate(allocator, started, count * sizeof(_Bool));
+    allocator->deallocate(allocator, threads, count * sizeof(pthread_t));
+    allocator->deallocate(allocator, tasks, count * sizeof(SweepTask));
+    return results;
+}
+
+/**
+ * @brief Displays a comparison table of SweepResults.
+ *
+ * @param results Array of SweepResults.
+ * @param count Number of SweepResults.
+ */
+void displaySweepResults(const SweepResult *results, int count) {
+
+    printf_s("###############################################################################################################\n");
+    printf_s("%-24s %6s %6s | %11s %11s %11s %11s %11s %9s\n",
+             "policy", "slice", "aging", "turnaround", "waiting", "response", "maxWaiting", "makespan", "switches");
+    for (int i = 0; i < count; ++i) {
+        const SweepResult *result = &results[i];
+        printf_s("%-24s %6d %6ld | %11.2f %11.2f %11.2f %11.2f %11.2f %9ld\n",
+                 sweepPolicyToString(result->config.policy),
+                 result->config.timeSlice > 0 ? result->config.timeSlice : TIME_SLICE,
+                 result->config.agingTicks > 0 ? result->config.agingTicks : AGING_TICKS,
+                 result->avgTurnaround, result->avgWaiting, result->avgResponse,
+                 result->maxWaiting, result->makespan, result->contextSwitches);
+    }
+    printf_s("###############################################################################################################\n");
+}
+
+/**
+ * @brief Destroys the SweepResults returned by runPolicySweep.
+ *
+ * @param results Array of SweepResults.
+ * @param count Number of SweepResults.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ */
+void destroySweepResults(SweepResult *results, int count, Allocator *allocator) {
+    if (results != NULL) {
+        allocator->deallocate(allocator, results, count * sizeof(SweepResult));
+    }
+}
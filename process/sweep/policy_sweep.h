@@ -0,0 +1,75 @@
+/*
+ User: Redskaber
+ Date: 2024/1/16
+ Time: 10:42
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_POLICY_SWEEP_H
+#define OPERATORSYSTEM_POLICY_SWEEP_H
+/*
+ * 调度策略并行对比(sweep)
+        同一份工作负载(只读), K 组 策略/参数 组合在 K 个线程上同时运行。
+        每个线程有自己的 Allocator 和 ProConBlock 私有副本: 只复制调度会修改的结构体本身,
+        进程名和 callback 与工作负载共享(写时复制视图), 线程之间没有任何共享的可写状态。
+
+        模拟是静默的: 不调用 callback, 不打印, 只按时间片推进虚拟时钟并统计指标。
+        所有进程在 0 时刻到达, 指标:
+            - 周转时间 = 完成时刻
+            - 等待时间 = 周转时间 - 总需时间
+            - 响应时间 = 第一次被调度的时刻
+            - 上下文切换 = 相邻两次调度的进程不同的次数
+ */
+
+#include <pthread.h>
+#include "../run_queue/priority_run_queue.h"
+
+// 私有副本所需的内存预算
+#define SWEEP_ALLOCATE_SIZE(member) \
+    ((int) (((member) + PRIORITY_LEVELS + 2) * sizeof(ProConBlock) + (PRIORITY_LEVELS + 2) * sizeof(ProConBlockLink) + sizeof(PriorityRunQueue)))
+
+typedef enum SweepPolicy {
+    sweep_first_come_first_serve,
+    sweep_shortest_job_next,
+    sweep_priority,
+    sweep_round_robin,
+    sweep_priority_aging,
+} SweepPolicy;
+
+typedef struct SweepConfig {
+    SweepPolicy policy;
+    int timeSlice;          // round robin / aging 的时间片, <= 0 使用 TIME_SLICE
+    long agingTicks;        // aging 的老化间隔, <= 0 使用 AGING_TICKS
+} SweepConfig;
+
+typedef struct SweepResult {
+    SweepConfig config;
+    int member;
+    double avgTurnaround;
+    double avgWaiting;
+    double avgResponse;
+    double maxWaiting;
+    double makespan;
+    long dispatches;
+    long contextSwitches;
+} SweepResult;
+
+
+#define sweepPolicyToString(policy) _Generic((policy),                        \
+    enum SweepPolicy:                                                         \
+        (policy == sweep_first_come_first_serve) ? "firstComeFirstServe" :    \
+        (policy == sweep_shortest_job_next) ? "shortestJobNext" :             \
+        (policy == sweep_priority) ? "priorityScheduling" :                   \
+        (policy == sweep_round_robin) ? "roundRobinScheduling" :              \
+        (policy == sweep_priority_aging) ? "priorityAgingScheduling" : "UNKNOWN" \
+)
+
+
+extern SweepResult *runPolicySweep(ProConBlockLink *workload, const SweepConfig *configs, int count, Allocator *allocator);
+
+extern void simulatePolicy(ProConBlockLink *workload, SweepConfig config, SweepResult *result);
+
+extern void displaySweepResults(const SweepResult *results, int count);
+
+extern void destroySweepResults(SweepResult *results, int count, Allocator *allocator);
+
+#endif //OPERATORSYSTEM_POLICY_SWEEP_H
@@ -0,0 +1,18 @@
+/*
+ User: Redskaber
+ Date: 2024/1/20
+ Time: 15:02
+*/
+#ifndef OPERATORSYSTEM_TEST_COMPACTPROCONBLOCK_H
+#define OPERATORSYSTEM_TEST_COMPACTPROCONBLOCK_H
+
+#include <assert.h>
+#include "../../compact/compact_pcb.h"
+
+extern void test_shortestJobFromTable_whenLoadedFromLink_matchesShortestJobNext();
+
+extern void test_highestPriorityFromTable_whenRowsFinish_skipsFinishedRows();
+
+extern void test_toCompactTicks_whenTimeOutOfRange_saturates();
+
+#endif //OPERATORSYSTEM_TEST_COMPACTPROCONBLOCK_H
@@ -0,0 +1,21 @@
+/*
+ User: Redskaber
+ Date: 2024/1/8
+ Time: 21:02
+*/
+#ifndef OPERATORSYSTEM_TEST_FINDPROCONBLOCKFROMLINK_H
+#define OPERATORSYSTEM_TEST_FINDPROCONBLOCKFROMLINK_H
+
+#include <assert.h>
+#include <stdlib.h>
+#include "../../process_scheduling.h"
+
+extern void test_findProConBlockFromLink_whenProcessExists_returnsProConBlock();
+
+extern void test_killProConBlockFromLink_whenProcessInMiddle_relinksNeighbours();
+
+extern void test_reniceProConBlockFromLink_whenProcessExists_changesPriority();
+
+extern void test_killProConBlockFromLink_whenProcessesShareId_keepsTheOthersIndexed();
+
+#endif //OPERATORSYSTEM_TEST_FINDPROCONBLOCKFROMLINK_H
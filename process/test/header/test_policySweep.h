@@ -0,0 +1,21 @@
+/*
+ User: Redskaber
+ Date: 2024/1/16
+ Time: 14:05
+*/
+#ifndef OPERATORSYSTEM_TEST_POLICYSWEEP_H
+#define OPERATORSYSTEM_TEST_POLICYSWEEP_H
+
+#include <assert.h>
+#include "../../sweep/policy_sweep.h"
+#include "../../trace/schedule_trace.h"
+
+extern void test_runPolicySweep_whenGridOfPolicies_matchesSerialSimulation();
+
+extern void test_runPolicySweep_whenSliceCoversEveryJob_roundRobinEqualsFirstComeFirstServe();
+
+extern void test_runPolicySweep_whenDefaultParameters_matchesRealScheduler();
+
+extern void test_simulatePolicy_whenProcessesShareId_countsEveryProcess();
+
+#endif //OPERATORSYSTEM_TEST_POLICYSWEEP_H
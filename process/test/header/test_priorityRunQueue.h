@@ -0,0 +1,18 @@
+/*
+ User: Redskaber
+ Date: 2024/1/10
+ Time: 21:15
+*/
+#ifndef OPERATORSYSTEM_TEST_PRIORITYRUNQUEUE_H
+#define OPERATORSYSTEM_TEST_PRIORITYRUNQUEUE_H
+
+#include <assert.h>
+#include "../../run_queue/priority_run_queue.h"
+
+extern void test_dequeuePriorityRunQueue_whenLowWaitsLongEnough_overtakesExigencyStream();
+
+extern void test_reniceFromPriorityRunQueue_whenProcessWaiting_movesLevel();
+
+extern void test_priorityAgingScheduling_whenLinkScheduled_usesLinkAllocator();
+
+#endif //OPERATORSYSTEM_TEST_PRIORITYRUNQUEUE_H
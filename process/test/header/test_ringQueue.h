@@ -0,0 +1,19 @@
+/*
+ User: Redskaber
+ Date: 2024/1/21
+ Time: 14:20
+*/
+#ifndef OPERATORSYSTEM_TEST_RINGQUEUE_H
+#define OPERATORSYSTEM_TEST_RINGQUEUE_H
+
+#include <assert.h>
+#include "../../ring_queue/ring_queue.h"
+#include "../../process_scheduling.h"
+
+extern void test_pushRingQueue_whenWrappedAndFull_growsInOrder();
+
+extern void test_roundRobinScheduling_whenJobsFinish_linksReverseCompletionOrder();
+
+extern void test_roundRobinScheduling_whenProcessesShareId_schedulesEveryNode();
+
+#endif //OPERATORSYSTEM_TEST_RINGQUEUE_H
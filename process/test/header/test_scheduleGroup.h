@@ -0,0 +1,16 @@
+/*
+ User: Redskaber
+ Date: 2024/1/24
+ Time: 10:31
+*/
+#ifndef OPERATORSYSTEM_TEST_SCHEDULEGROUP_H
+#define OPERATORSYSTEM_TEST_SCHEDULEGROUP_H
+
+#include <assert.h>
+#include "../../group/schedule_group.h"
+
+extern void test_pickScheduleGroup_whenTenantFloods_othersKeepTheirShare();
+
+extern void test_groupFairScheduling_whenNestedGroups_finishesEveryProcess();
+
+#endif //OPERATORSYSTEM_TEST_SCHEDULEGROUP_H
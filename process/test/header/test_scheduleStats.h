@@ -0,0 +1,20 @@
+/*
+ User: Redskaber
+ Date: 2024/1/18
+ Time: 22:10
+*/
+#ifndef OPERATORSYSTEM_TEST_SCHEDULESTATS_H
+#define OPERATORSYSTEM_TEST_SCHEDULESTATS_H
+
+#include <assert.h>
+#include "../../stats/schedule_stats.h"
+
+extern void test_snapshotScheduleStats_whenPoliciesRun_countsPerPolicy();
+
+extern void test_snapshotScheduleStats_whenOtherThreadRecords_sumsShards();
+
+extern void test_snapshotScheduleStats_whenThreadsExit_keepsRetiredCounts();
+
+extern void test_percentileScheduleHistogram_whenSkewed_returnsBucketUpperBound();
+
+#endif //OPERATORSYSTEM_TEST_SCHEDULESTATS_H
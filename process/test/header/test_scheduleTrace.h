@@ -0,0 +1,19 @@
+/*
+ User: Redskaber
+ Date: 2024/1/17
+ Time: 17:30
+*/
+#ifndef OPERATORSYSTEM_TEST_SCHEDULETRACE_H
+#define OPERATORSYSTEM_TEST_SCHEDULETRACE_H
+
+#include <assert.h>
+#include <pthread.h>
+#include "../../trace/schedule_trace.h"
+
+extern void test_attachScheduleTrace_whenRoundRobin_recordsEverySlice();
+
+extern void test_attachScheduleTrace_whenThreadsDispatch_recordsOneLanePerThread();
+
+extern void test_attachScheduleTrace_whenSharedByThreads_recordsEveryEventOnItsLane();
+
+#endif //OPERATORSYSTEM_TEST_SCHEDULETRACE_H
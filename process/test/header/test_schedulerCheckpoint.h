@@ -0,0 +1,19 @@
+/*
+ User: Redskaber
+ Date: 2024/1/14
+ Time: 17:05
+*/
+#ifndef OPERATORSYSTEM_TEST_SCHEDULERCHECKPOINT_H
+#define OPERATORSYSTEM_TEST_SCHEDULERCHECKPOINT_H
+
+#include <assert.h>
+#include <stddef.h>
+#include "../../checkpoint/scheduler_checkpoint.h"
+
+extern void test_restoreSchedulerSnapshot_whenCheckpointed_restoresRunQueue();
+
+extern void test_restoreSchedulerSnapshot_whenFileCorrupt_returnsNull();
+
+extern void test_restoreProConBlockLinkSnapshot_whenCheckpointed_restoresLinkOrder();
+
+#endif //OPERATORSYSTEM_TEST_SCHEDULERCHECKPOINT_H
@@ -0,0 +1,96 @@
+/*
+ User: Redskaber
+ Date: 2024/1/20
+ Time: 15:02
+*/
+#include "../header/test_compactProConBlock.h"
+
+
+void test_shortestJobFromTable_whenLoadedFromLink_matchesShortestJobNext() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    for (int p_id = 1; p_id <= 40; ++p_id) {
+        double p_total_time = (double) ((p_id * 7) % 23) + 0.5;
+        pushToLink(initProConBlock(p_id, "test", p_total_time, (ProcessPriority) (p_id % 4), NULL, allocator), proConBlockLink);
+    }
+
+    ProConBlockTable *table = initProConBlockTable(0, allocator);
+    loadProConBlockTable(table, proConBlockLink, allocator);
+    assert(table->size == 40);
+    assert(table->capacity >= 40);
+
+    CompactProConBlock compact;
+    readProConBlockTable(table, shortestJobFromTable(table), &compact);
+    shortestJobNext(proConBlockLink);
+    ProConBlock *shortest = proConBlockLink->headProConBlock->aftProConBlock;
+    assert(compact.p_id == shortest->p_id);
+    assert(compact.p_total_ticks == toCompactTicks(shortest->p_total_time));
+    assert(table->cold[compact.cold].p_name == shortest->p_name);
+
+    CompactProConBlock converted;
+    compactProConBlock(shortest, 0, &converted);
+    assert(converted.p_total_ticks == compact.p_total_ticks);
+    assert(converted.p_priority == compact.p_priority);
+
+    destroyProConBlockTable(table, allocator);
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_highestPriorityFromTable_whenRowsFinish_skipsFinishedRows() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockTable *table = initProConBlockTable(0, allocator);
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 5.0, normal, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 5.0, exigency, NULL, allocator);
+    ProConBlock *proConBlock3 = initProConBlock(3, "test3", 5.0, exigency, NULL, allocator);
+    pushProConBlockTable(table, proConBlock1, allocator);
+    pushProConBlockTable(table, proConBlock2, allocator);
+    pushProConBlockTable(table, proConBlock3, allocator);
+
+    assert(highestPriorityFromTable(table) == 1);
+    assert(runProConBlockTable(table, 1, toCompactTicks(TIME_SLICE)) == true);
+    assert(highestPriorityFromTable(table) == 2);
+    assert(runProConBlockTable(table, 2, toCompactTicks(2.0)) == false);
+    assert(highestPriorityFromTable(table) == 2);
+
+    // the last row moves into the removed one
+    removeProConBlockTable(table, 1);
+    assert(table->size == 2);
+    assert(table->p_id[1] == 3);
+    assert(highestPriorityFromTable(table) == 1);
+    runProConBlockTable(table, 1, toCompactTicks(3.0));
+    runProConBlockTable(table, 0, toCompactTicks(5.0));
+    assert(highestPriorityFromTable(table) == -1);
+    assert(shortestJobFromTable(table) == -1);
+
+    destroyProConBlock(proConBlock1, allocator);
+    destroyProConBlock(proConBlock2, allocator);
+    destroyProConBlock(proConBlock3, allocator);
+    destroyProConBlockTable(table, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_toCompactTicks_whenTimeOutOfRange_saturates() {
+    assert(toCompactTicks(2.5) == 2500);
+    assert(toCompactTicks(-1.0) == 0);
+    assert(toCompactTicks(5.0e6) == COMPACT_TICKS_MAX);
+    assert(toCompactTicks(1.0e300) == COMPACT_TICKS_MAX);
+
+    // a saturated job stays the longest one and is still picked once the short one finished
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockTable *table = initProConBlockTable(0, allocator);
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 1.0e7, normal, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 3.0, normal, NULL, allocator);
+    pushProConBlockTable(table, proConBlock1, allocator);
+    pushProConBlockTable(table, proConBlock2, allocator);
+    assert(table->p_total_ticks[0] == COMPACT_TICKS_MAX);
+    assert(shortestJobFromTable(table) == 1);
+    assert(runProConBlockTable(table, 1, toCompactTicks(3.0)) == true);
+    assert(shortestJobFromTable(table) == 0);
+
+    destroyProConBlock(proConBlock1, allocator);
+    destroyProConBlock(proConBlock2, allocator);
+    destroyProConBlockTable(table, allocator);
+    destroyAllocator(allocator);
+}
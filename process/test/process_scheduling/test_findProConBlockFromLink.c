@@ -0,0 +1,113 @@
+/*
+ User: Redskaber
+ Date: 2024/1/8
+ Time: 21:02
+*/
+#include "../header/test_findProConBlockFromLink.h"
+
+
+void test_findProConBlockFromLink_whenProcessExists_returnsProConBlock() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 100);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlockArr[64];
+    for (int i = 0; i < 64; ++i) {
+        proConBlockArr[i] = initProConBlock(i + 1, "test", 1.0, normal, NULL, allocator);
+        pushToLink(proConBlockArr[i], proConBlockLink);
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        assert(findProConBlockFromLink(proConBlockLink, i + 1) == proConBlockArr[i]);
+    }
+    assert(findProConBlockFromLink(proConBlockLink, 65) == NULL);
+
+    popFrontFromLink(proConBlockLink, allocator);
+    popBlackFromLink(proConBlockLink, allocator);
+    assert(findProConBlockFromLink(proConBlockLink, 64) == NULL);
+    assert(findProConBlockFromLink(proConBlockLink, 1) == NULL);
+    assert(findProConBlockFromLink(proConBlockLink, 32) == proConBlockArr[31]);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_killProConBlockFromLink_whenProcessInMiddle_relinksNeighbours() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 1.0, normal, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 2.0, normal, NULL, allocator);
+    ProConBlock *proConBlock3 = initProConBlock(3, "test3", 3.0, normal, NULL, allocator);
+    pushToLink(proConBlock1, proConBlockLink);
+    pushToLink(proConBlock2, proConBlockLink);
+    pushToLink(proConBlock3, proConBlockLink);
+
+    // [h] -> [3] <-> [2] <-> [1]
+    assert(killProConBlockFromLink(proConBlockLink, 2, allocator) == true);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == proConBlock3);
+    assert(proConBlock3->aftProConBlock == proConBlock1);
+    assert(proConBlock1->perProConBlock == proConBlock3);
+    assert(findProConBlockFromLink(proConBlockLink, 2) == NULL);
+    assert(killProConBlockFromLink(proConBlockLink, 2, allocator) == false);
+
+    assert(killProConBlockFromLink(proConBlockLink, 1, allocator) == true);
+    assert(proConBlockLink->lastProConBlock == proConBlock3);
+    assert(killProConBlockFromLink(proConBlockLink, 3, allocator) == true);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == NULL);
+    assert(proConBlockLink->lastProConBlock == NULL);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_reniceProConBlockFromLink_whenProcessExists_changesPriority() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 1.0, low, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 2.0, normal, NULL, allocator);
+    pushToLink(proConBlock1, proConBlockLink);
+    pushToLink(proConBlock2, proConBlockLink);
+
+    assert(reniceProConBlockFromLink(proConBlockLink, 1, exigency) == proConBlock1);
+    assert(reniceProConBlockFromLink(proConBlockLink, 3, exigency) == NULL);
+    priorityScheduling(proConBlockLink);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == proConBlock1);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_killProConBlockFromLink_whenProcessesShareId_keepsTheOthersIndexed() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlock1 = initProConBlock(5, "test1", 1.0, normal, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(5, "test2", 2.0, normal, NULL, allocator);
+    ProConBlock *proConBlock3 = initProConBlock(5, "test3", 3.0, normal, NULL, allocator);
+    pushToLink(proConBlock1, proConBlockLink);
+    appendToLink(proConBlock2, proConBlockLink);
+    pushToLink(proConBlock3, proConBlockLink);
+    assert(proConBlockLink->index->member == 3);
+
+    // every kill removes exactly the ProConBlock it detached, the others stay reachable
+    for (int remain = 3; remain > 0; --remain) {
+        ProConBlock *proConBlock = findProConBlockFromLink(proConBlockLink, 5);
+        assert(proConBlock == proConBlock1 || proConBlock == proConBlock2 || proConBlock == proConBlock3);
+        assert(reniceProConBlockFromLink(proConBlockLink, 5, high) == proConBlock);
+        assert(killProConBlockFromLink(proConBlockLink, 5, allocator) == true);
+        assert(proConBlockLink->index->member == remain - 1);
+    }
+    assert(findProConBlockFromLink(proConBlockLink, 5) == NULL);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == NULL);
+
+    // popping removes the popped ProConBlock, not another one with its p_id
+    pushToLink(initProConBlock(6, "test4", 1.0, normal, NULL, allocator), proConBlockLink);
+    ProConBlock *proConBlock5 = initProConBlock(6, "test5", 1.0, normal, NULL, allocator);
+    appendToLink(proConBlock5, proConBlockLink);
+    popFrontFromLink(proConBlockLink, allocator);
+    assert(findProConBlockFromLink(proConBlockLink, 6) == proConBlock5);
+    popBlackFromLink(proConBlockLink, allocator);
+    assert(findProConBlockFromLink(proConBlockLink, 6) == NULL);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
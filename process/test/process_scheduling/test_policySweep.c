@@ -0,0 +1,186 @@
+/*
+ User: Redskaber
+ Date: 2024/1/16
+ Time: 14:05
+*/
+#include "../header/test_policySweep.h"
+
+
+static void *sweepCallBack(void *args) {
+    return args;
+}
+
+static ProConBlockLink *initSweepWorkload(Allocator *allocator) {
+    ProConBlockLink *workload = initProConBlockLink(allocator);
+    pushToLink(initProConBlock(1, "test1", 24.0, low, sweepCallBack, allocator), workload);
+    pushToLink(initProConBlock(2, "test2", 3.0, high, sweepCallBack, allocator), workload);
+    pushToLink(initProConBlock(3, "test3", 3.0, normal, sweepCallBack, allocator), workload);
+    pushToLink(initProConBlock(4, "test4", 12.0, exigency, sweepCallBack, allocator), workload);
+    return workload;
+}
+
+/**
+ * @brief Derives the metrics of a SweepResult from the events the real scheduler recorded in a ScheduleTrace.
+ */
+static void replaySweepTrace(const ScheduleTrace *trace, ProConBlockLink *workload, SweepResult *result) {
+    memset(result, 0, sizeof(SweepResult));
+    for (ProConBlock *proConBlock = workload->headProConBlock->aftProConBlock;
+         proConBlock != NULL; proConBlock = proConBlock->aftProConBlock) {
+        result->member += 1;
+    }
+    _Bool dispatched[8] = {false};
+    int lastId = 0;
+    for (int i = 0; i < trace->size; ++i) {
+        const ScheduleTraceEvent *event = &trace->events[i];
+        if (event->kind == trace_run) {
+            if (!dispatched[event->p_id]) {
+                dispatched[event->p_id] = true;
+                result->avgResponse += event->start;
+            }
+            if (result->dispatches > 0 && lastId != event->p_id) {
+                result->contextSwitches += 1;
+            }
+            result->dispatches += 1;
+            lastId = event->p_id;
+        } else if (event->kind == trace_terminate) {
+            double waiting = event->start - findProConBlockFromLink(workload, event->p_id)->p_total_time;
+            result->avgTurnaround += event->start;
+            result->avgWaiting += waiting;
+            result->maxWaiting = waiting > result->maxWaiting ? waiting : result->maxWaiting;
+            result->makespan = event->start;
+        }
+    }
+    result->avgTurnaround /= result->member;
+    result->avgWaiting /= result->member;
+    result->avgResponse /= result->member;
+}
+
+void test_runPolicySweep_whenGridOfPolicies_matchesSerialSimulation() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *workload = initSweepWorkload(allocator);
+
+    SweepConfig configs[] = {
+            {sweep_first_come_first_serve, 0, 0},
+            {sweep_shortest_job_next,      0, 0},
+            {sweep_priority,               0, 0},
+            {sweep_round_robin,            2, 0},
+            {sweep_round_robin,            4, 0},
+            {sweep_priority_aging,         4, 5},
+            {sweep_priority_aging,         4, 50},
+    };
+    int count = sizeof(configs) / sizeof(SweepConfig);
+    SweepResult *results = runPolicySweep(workload, configs, count, allocator);
+
+    for (int i = 0; i < count; ++i) {
+        SweepResult serial;
+        simulatePolicy(workload, configs[i], &serial);
+        assert(results[i].member == 4);
+        assert(results[i].avgWaiting == serial.avgWaiting);
+        assert(results[i].contextSwitches == serial.contextSwitches);
+        assert(results[i].makespan == 42.0);
+    }
+    // FCFS: 24, 27, 30, 42
+    assert(results[0].avgTurnaround == (24.0 + 27.0 + 30.0 + 42.0) / 4);
+    // SJN has the shortest average waiting time of all non-preemptive orders
+    assert(results[1].avgWaiting <= results[0].avgWaiting);
+    assert(results[1].avgWaiting <= results[2].avgWaiting);
+    // the workload is not modified
+    assert(workload->headProConBlock->aftProConBlock->p_id == 4);
+    assert(workload->headProConBlock->aftProConBlock->p_execute_time == 0);
+    displaySweepResults(results, count);
+
+    destroySweepResults(results, count, allocator);
+    destroyProConBlockLink(workload, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_runPolicySweep_whenSliceCoversEveryJob_roundRobinEqualsFirstComeFirstServe() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *workload = initSweepWorkload(allocator);
+
+    SweepConfig configs[] = {
+            {sweep_first_come_first_serve, 0,  0},
+            {sweep_round_robin,            24, 0},
+    };
+    SweepResult *results = runPolicySweep(workload, configs, 2, allocator);
+    assert(results[0].avgTurnaround == results[1].avgTurnaround);
+    assert(results[0].avgResponse == results[1].avgResponse);
+    assert(results[1].contextSwitches == 3);
+
+    destroySweepResults(results, 2, allocator);
+    destroyProConBlockLink(workload, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_runPolicySweep_whenDefaultParameters_matchesRealScheduler() {
+    const char *path = "test_policy_sweep.json";
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *workload = initSweepWorkload(allocator);
+
+    SweepConfig configs[] = {
+            {sweep_first_come_first_serve, 0, 0},
+            {sweep_shortest_job_next,      0, 0},
+            {sweep_priority,               0, 0},
+            {sweep_round_robin,            0, 0},
+            {sweep_priority_aging,         0, 0},
+    };
+    void (*sortFunctions[])(ProConBlockLink *) = {
+            firstComeFirstServe, shortestJobNext, priorityScheduling, NULL, NULL
+    };
+    void (*executeFunctions[])(ProConBlockLink *) = {
+            NULL, NULL, NULL, roundRobinScheduling, priorityAgingScheduling
+    };
+    int count = sizeof(configs) / sizeof(SweepConfig);
+    SweepResult *results = runPolicySweep(workload, configs, count, allocator);
+
+    // the real policy functions run on a fresh copy of the workload, traced slice by slice
+    for (int i = 0; i < count; ++i) {
+        ProConBlockLink *copy = initSweepWorkload(allocator);
+        ScheduleTrace *trace = openScheduleTrace(path, 64, allocator);
+        assert(trace != NULL);
+        attachScheduleTrace(trace);
+        runningProConBlockFromLink(copy, sortFunctions[i], executeFunctions[i]);
+        attachScheduleTrace(NULL);
+
+        SweepResult real;
+        replaySweepTrace(trace, workload, &real);
+        assert(results[i].avgTurnaround == real.avgTurnaround);
+        assert(results[i].avgWaiting == real.avgWaiting);
+        assert(results[i].avgResponse == real.avgResponse);
+        assert(results[i].maxWaiting == real.maxWaiting);
+        assert(results[i].makespan == real.makespan);
+        assert(results[i].dispatches == real.dispatches);
+        assert(results[i].contextSwitches == real.contextSwitches);
+
+        assert(closeScheduleTrace(trace, allocator) == true);
+        destroyProConBlockLink(copy, allocator);
+    }
+    remove(path);
+
+    destroySweepResults(results, count, allocator);
+    destroyProConBlockLink(workload, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_simulatePolicy_whenProcessesShareId_countsEveryProcess() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *workload = initSweepWorkload(allocator);
+    pushToLink(initProConBlock(2, "test5", 6.0, normal, sweepCallBack, allocator), workload);
+
+    SweepResult result;
+    simulatePolicy(workload, (SweepConfig) {sweep_first_come_first_serve, 0, 0}, &result);
+    assert(result.member == 5);
+    // FCFS: 24, 27, 30, 42, 48
+    assert(result.avgTurnaround == (24.0 + 27.0 + 30.0 + 42.0 + 48.0) / 5);
+    assert(result.makespan == 48.0);
+
+    simulatePolicy(workload, (SweepConfig) {sweep_round_robin, 4, 0}, &result);
+    assert(result.member == 5);
+    assert(result.makespan == 48.0);
+
+    destroyProConBlockLink(workload, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
@@ -0,0 +1,86 @@
+/*
+ User: Redskaber
+ Date: 2024/1/10
+ Time: 21:15
+*/
+#include "../header/test_priorityRunQueue.h"
+
+
+static void *agingCallBack(void *args) {
+    return args;
+}
+
+void test_dequeuePriorityRunQueue_whenLowWaitsLongEnough_overtakesExigencyStream() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    PriorityRunQueue *runQueue = initPriorityRunQueue(10, allocator);
+
+    ProConBlock *lowProConBlock = initProConBlock(1, "low", 5.0, low, NULL, allocator);
+    enqueuePriorityRunQueue(runQueue, lowProConBlock);
+
+    // a new exigency process arrives every 5 ticks; without aging low would never run
+    int dispatched = 0;
+    ProConBlock *proConBlock = NULL;
+    for (int p_id = 2; p_id < 40; ++p_id) {
+        enqueuePriorityRunQueue(runQueue, initProConBlock(p_id, "exigency", 5.0, exigency, NULL, allocator));
+        proConBlock = dequeuePriorityRunQueue(runQueue);
+        advancePriorityRunQueue(runQueue, 5);
+        dispatched += 1;
+        if (proConBlock == lowProConBlock) {
+            break;
+        }
+        destroyProConBlock(proConBlock, allocator);
+    }
+    assert(proConBlock == lowProConBlock);
+    // low -> exigency takes 3 levels * 10 ticks, one dispatch per 5 ticks
+    assert(dispatched <= 8);
+    destroyProConBlock(lowProConBlock, allocator);
+
+    destroyPriorityRunQueue(runQueue, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_reniceFromPriorityRunQueue_whenProcessWaiting_movesLevel() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    PriorityRunQueue *runQueue = initPriorityRunQueue(AGING_TICKS, allocator);
+
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 5.0, low, NULL, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 5.0, normal, NULL, allocator);
+    enqueuePriorityRunQueue(runQueue, proConBlock1);
+    enqueuePriorityRunQueue(runQueue, proConBlock2);
+
+    assert(reniceFromPriorityRunQueue(runQueue, 1, high) == proConBlock1);
+    assert(findFromPriorityRunQueue(runQueue, 1) == proConBlock1);
+    assert(dequeuePriorityRunQueue(runQueue) == proConBlock1);
+    destroyProConBlock(proConBlock1, allocator);
+
+    assert(killFromPriorityRunQueue(runQueue, 2, allocator) == true);
+    assert(runQueue->size == 0);
+    assert(dequeuePriorityRunQueue(runQueue) == NULL);
+
+    destroyPriorityRunQueue(runQueue, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_priorityAgingScheduling_whenLinkScheduled_usesLinkAllocator() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    appendToLink(initProConBlock(1, "test1", 12.0, low, agingCallBack, allocator), proConBlockLink);
+    appendToLink(initProConBlock(2, "test2", 3.0, exigency, agingCallBack, allocator), proConBlockLink);
+    appendToLink(initProConBlock(3, "test3", 6.0, normal, agingCallBack, allocator), proConBlockLink);
+
+    // the run queue is charged to the allocator of the link and fully returned
+    int used = allocator->used;
+    priorityAgingScheduling(proConBlockLink);
+    assert(allocator->used == used);
+    assert(proConBlockLink->headProConBlock->aftProConBlock->p_id == 2);
+    assert(proConBlockLink->index->member == 3);
+    for (ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+         proConBlock != NULL; proConBlock = proConBlock->aftProConBlock) {
+        assert(proConBlock->p_execute_time == proConBlock->p_total_time);
+    }
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
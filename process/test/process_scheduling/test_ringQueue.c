@@ -0,0 +1,92 @@
+/*
+ User: Redskaber
+ Date: 2024/1/21
+ Time: 14:20
+*/
+#include "../header/test_ringQueue.h"
+
+
+static void *ringCallBack(void *args) {
+    return args;
+}
+
+void test_pushRingQueue_whenWrappedAndFull_growsInOrder() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE);
+    RingQueue *queue = initRingQueue(0, allocator);
+    assert(queue->capacity == RING_QUEUE_INIT_SIZE);
+
+    // move head into the middle of the ring, then fill it
+    for (uint32_t item = 0; item < 10; ++item) {
+        pushRingQueue(queue, item, allocator);
+    }
+    for (uint32_t item = 0; item < 10; ++item) {
+        assert(rotateRingQueue(queue) == item);
+    }
+    for (uint32_t item = 10; item < 40; ++item) {
+        pushRingQueue(queue, item, allocator);
+    }
+    assert(queue->capacity == 4 * RING_QUEUE_INIT_SIZE);
+    assert(queue->size == 40);
+    for (uint32_t item = 0; item < 40; ++item) {
+        assert(popRingQueue(queue) == item);
+    }
+    assert(queue->size == 0);
+
+    destroyRingQueue(queue, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_roundRobinScheduling_whenJobsFinish_linksReverseCompletionOrder() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    ProConBlock *proConBlock1 = initProConBlock(1, "test1", 12.0, low, ringCallBack, allocator);
+    ProConBlock *proConBlock2 = initProConBlock(2, "test2", 3.0, low, ringCallBack, allocator);
+    ProConBlock *proConBlock3 = initProConBlock(3, "test3", 6.0, low, ringCallBack, allocator);
+    appendToLink(proConBlock1, proConBlockLink);
+    appendToLink(proConBlock2, proConBlockLink);
+    appendToLink(proConBlock3, proConBlockLink);
+
+    // completion order: test2, test3, test1
+    roundRobinScheduling(proConBlockLink);
+    assert(proConBlockLink->headProConBlock->aftProConBlock == proConBlock1);
+    assert(proConBlock1->perProConBlock == NULL);
+    assert(proConBlock1->aftProConBlock == proConBlock3);
+    assert(proConBlock3->aftProConBlock == proConBlock2);
+    assert(proConBlock2->perProConBlock == proConBlock3);
+    assert(proConBlock2->aftProConBlock == NULL);
+    assert(proConBlockLink->lastProConBlock == proConBlock2);
+    assert(proConBlock1->p_execute_time == proConBlock1->p_total_time);
+    assert(findProConBlockFromLink(proConBlockLink, 3) == proConBlock3);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_roundRobinScheduling_whenProcessesShareId_schedulesEveryNode() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    // the p_id index keeps one entry per node, even though they share the p_id
+    for (int i = 0; i < 20; ++i) {
+        appendToLink(initProConBlock(7, "test7", (double) (i % 3 + 1) * TIME_SLICE, low, ringCallBack, allocator), proConBlockLink);
+    }
+    assert(proConBlockLink->index->member == 20);
+
+    int used = allocator->used;
+    roundRobinScheduling(proConBlockLink);
+    assert(allocator->used == used);
+
+    int count = 0;
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        assert(proConBlock->p_execute_time == proConBlock->p_total_time);
+        count += 1;
+        proConBlock = proConBlock->aftProConBlock;
+    }
+    assert(count == 20);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
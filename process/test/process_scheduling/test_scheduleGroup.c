@@ -0,0 +1,83 @@
+/*
+ User: Redskaber
+ Date: 2024/1/24
+ Time: 10:31
+*/
+#include "../header/test_scheduleGroup.h"
+
+
+static void *groupCallBack(void *args) {
+    return args;
+}
+
+void test_pickScheduleGroup_whenTenantFloods_othersKeepTheirShare() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 100);
+    ScheduleGroup *root = initScheduleGroup("root", 0, NULL, allocator);
+    ScheduleGroup *flood = initScheduleGroup("flood", SCHEDULE_NICE_0_WEIGHT, root, allocator);
+    ScheduleGroup *quiet = initScheduleGroup("quiet", SCHEDULE_NICE_0_WEIGHT, root, allocator);
+    ScheduleGroup *heavy = initScheduleGroup("heavy", 2 * SCHEDULE_NICE_0_WEIGHT, root, allocator);
+
+    for (int p_id = 1; p_id <= 300; ++p_id) {
+        enqueueScheduleGroup(flood, initProConBlock(p_id, "flood", 1000.0, exigency, NULL, allocator), allocator);
+    }
+    enqueueScheduleGroup(quiet, initProConBlock(1001, "quiet", 1000.0, low, NULL, allocator), allocator);
+    enqueueScheduleGroup(heavy, initProConBlock(1002, "heavy", 1000.0, low, NULL, allocator), allocator);
+    assert(root->member == 302);
+
+    // quiet : flood : heavy = 1 : 1 : 2, whatever the number of processes in flood
+    int picks[3] = {0, 0, 0};
+    for (int slice = 0; slice < 400; ++slice) {
+        ProConBlock *proConBlock = pickScheduleGroup(root);
+        picks[proConBlock->p_id == 1001 ? 0 : proConBlock->p_id == 1002 ? 2 : 1] += 1;
+        chargeScheduleGroup(root, proConBlock, TIME_SLICE);
+    }
+    assert(picks[0] >= 95 && picks[0] <= 105);
+    assert(picks[1] >= 95 && picks[1] <= 105);
+    assert(picks[2] >= 195 && picks[2] <= 205);
+
+    // an empty group leaves the heap of its parent
+    ProConBlock *quietProConBlock = dequeueScheduleGroup(root, 1001, allocator);
+    assert(quietProConBlock != NULL);
+    destroyProConBlock(quietProConBlock, allocator);
+    assert(quiet->member == 0 && quiet->entity.heapIndex == -1);
+    for (int slice = 0; slice < 30; ++slice) {
+        assert(pickScheduleGroup(root)->p_id != 1001);
+        chargeScheduleGroup(root, pickScheduleGroup(root), TIME_SLICE);
+    }
+    assert(dequeueScheduleGroup(root, 1001, allocator) == NULL);
+
+    destroyScheduleGroup(root, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_groupFairScheduling_whenNestedGroups_finishesEveryProcess() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ScheduleGroup *root = initScheduleGroup("root", 0, NULL, allocator);
+    ScheduleGroup *tenant = initScheduleGroup("tenant", 0, root, allocator);
+    ScheduleGroup *service = initScheduleGroup("service", 0, tenant, allocator);
+
+    enqueueScheduleGroup(service, initProConBlock(1, "test1", 12.0, normal, groupCallBack, allocator), allocator);
+    enqueueScheduleGroup(tenant, initProConBlock(2, "test2", 3.0, normal, groupCallBack, allocator), allocator);
+    enqueueScheduleGroup(root, initProConBlock(3, "test3", 6.0, normal, groupCallBack, allocator), allocator);
+    // shares its p_id with test2, so charging must find its own entity
+    enqueueScheduleGroup(service, initProConBlock(2, "test4", 4.0, normal, groupCallBack, allocator), allocator);
+
+    ProConBlockLink *finishLink = initProConBlockLink(allocator);
+    groupFairScheduling(root, finishLink, allocator);
+    assert(root->member == 0);
+    assert(pickScheduleGroup(root) == NULL);
+    int finished = 0;
+    for (ProConBlock *proConBlock = finishLink->headProConBlock->aftProConBlock;
+         proConBlock != NULL; proConBlock = proConBlock->aftProConBlock) {
+        assert(proConBlock->p_execute_time == proConBlock->p_total_time);
+        finished += 1;
+    }
+    assert(finished == 4);
+    // the longest process finishes last
+    assert(finishLink->lastProConBlock->p_id == 1);
+
+    destroyProConBlockLink(finishLink, allocator);
+    destroyScheduleGroup(root, allocator);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
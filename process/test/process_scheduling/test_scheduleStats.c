@@ -0,0 +1,113 @@
+/*
+ User: Redskaber
+ Date: 2024/1/18
+ Time: 22:10
+*/
+#include "../header/test_scheduleStats.h"
+
+
+static void *statsCallBack(void *args) {
+    return args;
+}
+
+static ProConBlockLink *initStatsWorkload(Allocator *allocator) {
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    pushToLink(initProConBlock(1, "test1", 12.0, low, statsCallBack, allocator), proConBlockLink);
+    pushToLink(initProConBlock(2, "test2", 3.0, high, statsCallBack, allocator), proConBlockLink);
+    pushToLink(initProConBlock(3, "test3", 6.0, normal, statsCallBack, allocator), proConBlockLink);
+    return proConBlockLink;
+}
+
+static void *statsWorker(void *args) {
+    SchedulePolicy policy = switchSchedulePolicy(policy_other);
+    countScheduleStats(counter_enqueues, *(int *) args);
+    switchSchedulePolicy(policy);
+    return NULL;
+}
+
+void test_snapshotScheduleStats_whenPoliciesRun_countsPerPolicy() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initStatsWorkload(allocator);
+
+    resetScheduleStats();
+    runningProConBlockFromLink(proConBlockLink, shortestJobNext, NULL);
+    ScheduleStats snapshot;
+    snapshotScheduleStats(&snapshot);
+    assert(snapshot.counters[policy_shortest_job_next][counter_dispatches] == 3);
+    assert(snapshot.counters[policy_shortest_job_next][counter_preemptions] == 0);
+    assert(snapshot.counters[policy_shortest_job_next][counter_comparisons] > 0);
+    assert(snapshot.latencies[policy_shortest_job_next][latency_pick_next].count == 1);
+
+    // test1 is preempted twice, test3 once: 3 preemptions, 6 slices
+    ProConBlockLink *roundRobinLink = initStatsWorkload(allocator);
+    runningProConBlockFromLink(roundRobinLink, NULL, roundRobinScheduling);
+    snapshotScheduleStats(&snapshot);
+    assert(snapshot.counters[policy_round_robin][counter_preemptions] == 3);
+    assert(snapshot.counters[policy_round_robin][counter_dispatches] == 6);
+    // one pick per slice, not one for the initial order
+    assert(snapshot.latencies[policy_round_robin][latency_pick_next].count == 6);
+    assert(snapshot.counters[policy_shortest_job_next][counter_dispatches] == 3);
+    displayScheduleStats(&snapshot);
+
+    destroyProConBlockLink(roundRobinLink, allocator);
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+}
+
+void test_snapshotScheduleStats_whenOtherThreadRecords_sumsShards() {
+    resetScheduleStats();
+    int amount = 7;
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, statsWorker, &amount) == 0);
+    pthread_join(thread, NULL);
+    countScheduleStats(counter_enqueues, 1);
+
+    ScheduleStats snapshot;
+    snapshotScheduleStats(&snapshot);
+    assert(snapshot.counters[policy_other][counter_enqueues] == 8);
+}
+
+void test_snapshotScheduleStats_whenThreadsExit_keepsRetiredCounts() {
+    resetScheduleStats();
+    int amount = 3;
+    pthread_t threads[16];
+    for (int t = 0; t < 16; ++t) {
+        assert(pthread_create(&threads[t], NULL, statsWorker, &amount) == 0);
+    }
+    for (int t = 0; t < 16; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    // the shards of the exited threads are freed, their counts live on in the retired total
+    ScheduleStats snapshot;
+    snapshotScheduleStats(&snapshot);
+    assert(snapshot.counters[policy_other][counter_enqueues] == 48);
+    resetScheduleStats();
+    snapshotScheduleStats(&snapshot);
+    assert(snapshot.counters[policy_other][counter_enqueues] == 0);
+}
+
+void test_percentileScheduleHistogram_whenSkewed_returnsBucketUpperBound() {
+    ScheduleHistogram histogram;
+    memset(&histogram, 0, sizeof(ScheduleHistogram));
+    assert(percentileScheduleHistogram(&histogram, 0.99) == 0);
+
+    // 98 samples in [64, 128), 2 samples in [4096, 8192)
+    histogram.count = 100;
+    histogram.buckets[6] = 98;
+    histogram.buckets[12] = 2;
+    histogram.max = 5000;
+    assert(percentileScheduleHistogram(&histogram, 0.50) == 127);
+    assert(percentileScheduleHistogram(&histogram, 0.98) == 127);
+    assert(percentileScheduleHistogram(&histogram, 0.99) == 5000);
+
+    // nearest rank: p95 of 10 samples is the 10th sample, not the 9th
+    memset(&histogram, 0, sizeof(ScheduleHistogram));
+    histogram.count = 10;
+    histogram.buckets[3] = 9;
+    histogram.buckets[10] = 1;
+    histogram.max = 1500;
+    assert(percentileScheduleHistogram(&histogram, 0.90) == 15);
+    assert(percentileScheduleHistogram(&histogram, 0.95) == 1500);
+    assert(percentileScheduleHistogram(&histogram, 1.00) == 1500);
+}
@@ -0,0 +1,149 @@
+/*
+ User: Redskaber
+ Date: 2024/1/17
+ Time: 17:30
+*/
+#include "../header/test_scheduleTrace.h"
+
+
+static void *traceCallBack(void *args) {
+    return args;
+}
+
+static int countOccurrence(const char *path, const char *pattern) {
+    FILE *fp = fopen(path, "r");
+    assert(fp != NULL);
+    char line[512];
+    int count = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        count += strstr(line, pattern) != NULL;
+    }
+    fclose(fp);
+    return count;
+}
+
+void test_attachScheduleTrace_whenRoundRobin_recordsEverySlice() {
+    const char *path = "test_schedule_trace.json";
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    pushToLink(initProConBlock(1, "test1", 12.0, low, traceCallBack, allocator), proConBlockLink);
+    pushToLink(initProConBlock(2, "test\"2", 3.0, high, traceCallBack, allocator), proConBlockLink);
+
+    // a buffer of 2 events forces several flushes
+    ScheduleTrace *trace = openScheduleTrace(path, 2, allocator);
+    assert(trace != NULL);
+    attachScheduleTrace(trace);
+    runningProConBlockFromLink(proConBlockLink, NULL, roundRobinScheduling);
+    attachScheduleTrace(NULL);
+
+    // test1 runs 5, test2 runs 3 and terminates, test1 is alone and runs the remaining 7
+    assert(trace->clock == 15.0);
+    assert(closeScheduleTrace(trace, allocator) == true);
+    assert(countOccurrence(path, "\"ph\":\"X\"") == 3);
+    assert(countOccurrence(path, "\"cat\":\"preempt\"") == 1);
+    assert(countOccurrence(path, "\"cat\":\"terminate\"") == 2);
+    assert(countOccurrence(path, "test\\\"2") == 2);
+    assert(countOccurrence(path, "]}") == 1);
+    remove(path);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+}
+
+/**
+ * @brief Runs one process under a fresh ScheduleTrace on the calling thread and returns the lane of its events.
+ */
+static int traceLaneOfThread(const char *path) {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    pushToLink(initProConBlock(1, "test1", 3.0, normal, traceCallBack, allocator), proConBlockLink);
+
+    ScheduleTrace *trace = openScheduleTrace(path, 8, allocator);
+    assert(trace != NULL);
+    attachScheduleTrace(trace);
+    runningProConBlockFromLink(proConBlockLink, NULL, NULL);
+    attachScheduleTrace(NULL);
+    assert(trace->size == 2);
+    int lane = trace->events[0].lane;
+    assert(trace->events[1].lane == lane);
+
+    assert(closeScheduleTrace(trace, allocator) == true);
+    remove(path);
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+    return lane;
+}
+
+static void *traceLaneWorker(void *args) {
+    *(int *) args = traceLaneOfThread("test_schedule_trace_worker.json");
+    return NULL;
+}
+
+void test_attachScheduleTrace_whenThreadsDispatch_recordsOneLanePerThread() {
+    int lane = traceLaneOfThread("test_schedule_trace_main.json");
+    // the same thread keeps its lane
+    assert(traceLaneOfThread("test_schedule_trace_main.json") == lane);
+
+    int workerLane = -1;
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, traceLaneWorker, &workerLane) == 0);
+    pthread_join(thread, NULL);
+    assert(workerLane >= 0);
+    assert(workerLane != lane);
+}
+
+/**
+ * @brief Runs the round robin workload of the first test on the calling thread under a shared ScheduleTrace.
+ */
+static void *sharedTraceWorker(void *args) {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    pushToLink(initProConBlock(1, "test1", 12.0, low, traceCallBack, allocator), proConBlockLink);
+    pushToLink(initProConBlock(2, "test2", 3.0, high, traceCallBack, allocator), proConBlockLink);
+
+    attachScheduleTrace((ScheduleTrace *) args);
+    runningProConBlockFromLink(proConBlockLink, NULL, roundRobinScheduling);
+    attachScheduleTrace(NULL);
+
+    destroyProConBlockLink(proConBlockLink, allocator);
+    destroyAllocator(allocator);
+    return NULL;
+}
+
+void test_attachScheduleTrace_whenSharedByThreads_recordsEveryEventOnItsLane() {
+    const char *path = "test_schedule_trace_shared.json";
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ScheduleTrace *trace = openScheduleTrace(path, 64, allocator);
+    assert(trace != NULL);
+
+    pthread_t threads[2];
+    for (int i = 0; i < 2; ++i) {
+        assert(pthread_create(&threads[i], NULL, sharedTraceWorker, trace) == 0);
+    }
+    for (int i = 0; i < 2; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // every thread records 3 runs, 1 preempt and 2 terminates on its own lane
+    assert(trace->size == 12);
+    assert(trace->clock == 30.0);
+    int lane = trace->events[0].lane;
+    int laneEvents = 0;
+    int otherLane = -1;
+    for (int i = 0; i < trace->size; ++i) {
+        if (trace->events[i].lane == lane) {
+            laneEvents += 1;
+        } else {
+            assert(otherLane < 0 || otherLane == trace->events[i].lane);
+            otherLane = trace->events[i].lane;
+        }
+    }
+    assert(laneEvents == 6 && otherLane >= 0);
+
+    assert(closeScheduleTrace(trace, allocator) == true);
+    assert(countOccurrence(path, "\"ph\":\"X\"") == 6);
+    assert(countOccurrence(path, "]}") == 1);
+    remove(path);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
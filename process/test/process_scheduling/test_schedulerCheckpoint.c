@@ -0,0 +1,193 @@
+/*
+ User: Redskaber
+ Date: 2024/1/14
+ Time: 17:05
+*/
+#include "../header/test_schedulerCheckpoint.h"
+
+#define CHECKPOINT_TEST_PATH "scheduler_checkpoint.test"
+#define CHECKPOINT_CORRUPT_PATH "scheduler_checkpoint_corrupt.test"
+
+
+static void *checkpointCallBack(void *args) {
+    return args;
+}
+
+static PriorityRunQueue *initCheckpointRunQueue(Allocator *allocator) {
+    PriorityRunQueue *runQueue = initPriorityRunQueue(AGING_TICKS, allocator);
+    enqueuePriorityRunQueue(runQueue, initProConBlock(1, "test1", 5.0, low, NULL, allocator));
+    enqueuePriorityRunQueue(runQueue, initProConBlock(2, "test2", 3.0, exigency, NULL, allocator));
+    advancePriorityRunQueue(runQueue, 3);
+    enqueuePriorityRunQueue(runQueue, initProConBlock(3, "test3", 4.0, normal, NULL, allocator));
+    enqueuePriorityRunQueue(runQueue, initProConBlock(4, "test4", 2.0, exigency, NULL, allocator));
+    return runQueue;
+}
+
+/**
+ * @brief Writes a copy of a checkpoint file with length bytes, after patching size bytes at offset.
+ */
+static void writeCorruptCheckpoint(const char *bytes, size_t length, size_t offset, const void *patch, size_t size) {
+    char copy[length];
+    memcpy(copy, bytes, length);
+    if (patch != NULL) {
+        memcpy(copy + offset, patch, size);
+    }
+    FILE *fp = fopen(CHECKPOINT_CORRUPT_PATH, "wb");
+    assert(fp != NULL);
+    assert(fwrite(copy, 1, length, fp) == length);
+    fclose(fp);
+}
+
+void test_restoreSchedulerSnapshot_whenCheckpointed_restoresRunQueue() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    PriorityRunQueue *runQueue = initCheckpointRunQueue(allocator);
+    assert(checkpointPriorityRunQueue(runQueue, CHECKPOINT_TEST_PATH) == true);
+
+    SchedulerSnapshot *snapshot = restoreSchedulerSnapshot(CHECKPOINT_TEST_PATH, NULL, allocator);
+    assert(snapshot != NULL);
+    PriorityRunQueue *restored = snapshot->runQueue;
+    assert(restored->clock == runQueue->clock);
+    assert(restored->agingTicks == runQueue->agingTicks);
+    assert(restored->size == runQueue->size);
+    assert(findFromPriorityRunQueue(restored, 3) != NULL);
+
+    // both queues dispatch the same processes in the same order
+    for (int i = 0; i < 4; ++i) {
+        ProConBlock *proConBlock = dequeuePriorityRunQueue(runQueue);
+        ProConBlock *restoredProConBlock = dequeuePriorityRunQueue(restored);
+        assert(restoredProConBlock->p_id == proConBlock->p_id);
+        assert(restoredProConBlock->p_priority == proConBlock->p_priority);
+        assert(restoredProConBlock->p_total_time == proConBlock->p_total_time);
+        assert(strcmp(restoredProConBlock->p_name, proConBlock->p_name) == 0);
+        destroyProConBlock(proConBlock, allocator);
+        // a dequeued record is copied out of the mapping before it is destroyed
+        ProConBlock *owned = detachSnapshotProConBlock(snapshot, restoredProConBlock, allocator);
+        assert(owned != restoredProConBlock && owned->p_id == restoredProConBlock->p_id);
+        destroyProConBlock(owned, allocator);
+    }
+    assert(dequeuePriorityRunQueue(restored) == NULL);
+
+    releaseSchedulerSnapshot(snapshot, allocator);
+    destroyPriorityRunQueue(runQueue, allocator);
+    remove(CHECKPOINT_TEST_PATH);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
+
+void test_restoreSchedulerSnapshot_whenFileCorrupt_returnsNull() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    PriorityRunQueue *runQueue = initCheckpointRunQueue(allocator);
+    assert(checkpointPriorityRunQueue(runQueue, CHECKPOINT_TEST_PATH) == true);
+    destroyPriorityRunQueue(runQueue, allocator);
+
+    FILE *fp = fopen(CHECKPOINT_TEST_PATH, "rb");
+    assert(fp != NULL);
+    fseek(fp, 0, SEEK_END);
+    size_t length = (size_t) ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char bytes[length];
+    assert(fread(bytes, 1, length, fp) == length);
+    fclose(fp);
+
+    size_t recordOffset = sizeof(SchedulerCheckpointHeader);
+    int used = allocator->used;
+
+    // the untouched copy restores
+    writeCorruptCheckpoint(bytes, length, 0, NULL, 0);
+    SchedulerSnapshot *snapshot = restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator);
+    assert(snapshot != NULL);
+    releaseSchedulerSnapshot(snapshot, allocator);
+
+    // truncated: the last name loses its terminator, the header is patched to the shorter length
+    int64_t truncated = (int64_t) length - 1;
+    writeCorruptCheckpoint(bytes, length - 1, offsetof(SchedulerCheckpointHeader, length), &truncated, sizeof(int64_t));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // truncated without patching the header
+    writeCorruptCheckpoint(bytes, length / 2, 0, NULL, 0);
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // more records than the file holds
+    int64_t member = INT64_C(1) << 40;
+    writeCorruptCheckpoint(bytes, length, offsetof(SchedulerCheckpointHeader, member), &member, sizeof(int64_t));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // a priority outside the levels
+    ProcessPriority priority = (ProcessPriority) PRIORITY_LEVELS;
+    writeCorruptCheckpoint(bytes, length, recordOffset + offsetof(ProConBlock, p_priority), &priority, sizeof(ProcessPriority));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // a neighbour outside the mapping
+    ProConBlock *aftProConBlock = (ProConBlock *) (intptr_t) (length * 4);
+    writeCorruptCheckpoint(bytes, length, recordOffset + offsetof(ProConBlock, aftProConBlock), &aftProConBlock, sizeof(ProConBlock *));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // a name outside the string pool
+    char *p_name = (char *) (intptr_t) recordOffset;
+    writeCorruptCheckpoint(bytes, length, recordOffset + offsetof(ProConBlock, p_name), &p_name, sizeof(char *));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    // a level whose last record is not where its walk ends
+    int64_t first[PRIORITY_LEVELS];
+    int64_t last[PRIORITY_LEVELS];
+    memcpy(first, bytes + offsetof(SchedulerCheckpointHeader, first), sizeof(first));
+    memcpy(last, bytes + offsetof(SchedulerCheckpointHeader, last), sizeof(last));
+    assert(first[exigency] != last[exigency]);
+    last[exigency] = first[exigency];
+    writeCorruptCheckpoint(bytes, length, offsetof(SchedulerCheckpointHeader, last), last, sizeof(last));
+    assert(restoreSchedulerSnapshot(CHECKPOINT_CORRUPT_PATH, NULL, allocator) == NULL);
+
+    assert(allocator->used == used);
+    remove(CHECKPOINT_TEST_PATH);
+    remove(CHECKPOINT_CORRUPT_PATH);
+    destroyAllocator(allocator);
+}
+
+void test_restoreProConBlockLinkSnapshot_whenCheckpointed_restoresLinkOrder() {
+    Allocator *allocator = createAllocator(ALLOCATE_TOTAL_SIZE * 10);
+    ProConBlockLink *proConBlockLink = initProConBlockLink(allocator);
+    appendToLink(initProConBlock(1, "test1", 12.0, low, checkpointCallBack, allocator), proConBlockLink);
+    appendToLink(initProConBlock(2, "test2", 3.0, exigency, checkpointCallBack, allocator), proConBlockLink);
+    appendToLink(initProConBlock(2, "test3", 6.0, normal, checkpointCallBack, allocator), proConBlockLink);
+    appendToLink(initProConBlock(4, "test4", 2.0, high, checkpointCallBack, allocator), proConBlockLink);
+    assert(checkpointProConBlockLink(proConBlockLink, CHECKPOINT_TEST_PATH) == true);
+    // a link checkpoint is not a run queue checkpoint
+    assert(restoreSchedulerSnapshot(CHECKPOINT_TEST_PATH, checkpointCallBack, allocator) == NULL);
+
+    SchedulerSnapshot *snapshot = restoreProConBlockLinkSnapshot(CHECKPOINT_TEST_PATH, checkpointCallBack, allocator);
+    assert(snapshot != NULL && snapshot->runQueue == NULL);
+    ProConBlockLink *restored = snapshot->proConBlockLink;
+    assert(restored->index->member == 4);
+    ProConBlock *proConBlock = proConBlockLink->headProConBlock->aftProConBlock;
+    ProConBlock *restoredProConBlock = restored->headProConBlock->aftProConBlock;
+    while (proConBlock != NULL) {
+        assert(restoredProConBlock->p_id == proConBlock->p_id);
+        assert(restoredProConBlock->p_priority == proConBlock->p_priority);
+        assert(strcmp(restoredProConBlock->p_name, proConBlock->p_name) == 0);
+        proConBlock = proConBlock->aftProConBlock;
+        restoredProConBlock = restoredProConBlock->aftProConBlock;
+    }
+    assert(restoredProConBlock == NULL);
+
+    // once every record is taken over in place, the restored link is scheduled like any other
+    restoredProConBlock = restored->headProConBlock->aftProConBlock;
+    while (restoredProConBlock != NULL) {
+        restoredProConBlock = detachSnapshotProConBlock(snapshot, restoredProConBlock, allocator)->aftProConBlock;
+    }
+    assert(restored->index->member == 4);
+    assert(findProConBlockFromLink(restored, 4) == restored->lastProConBlock);
+    runningProConBlockFromLink(restored, NULL, roundRobinScheduling);
+    int finished = 0;
+    for (restoredProConBlock = restored->headProConBlock->aftProConBlock;
+         restoredProConBlock != NULL; restoredProConBlock = restoredProConBlock->aftProConBlock) {
+        assert(restoredProConBlock->p_execute_time >= restoredProConBlock->p_total_time);
+        finished += 1;
+    }
+    assert(finished == 4);
+
+    releaseSchedulerSnapshot(snapshot, allocator);
+    destroyProConBlockLink(proConBlockLink, allocator);
+    remove(CHECKPOINT_TEST_PATH);
+    assert(allocator->used == 0);
+    destroyAllocator(allocator);
+}
@@ -0,0 +1,247 @@
+/*
+ User: Redskaber
+ Date: 2024/1/17
+ Time: 15:08
+*/
+#include "schedule_trace.h"
+
+
+// 当前线程(模拟的一个 CPU)的时间线 lane, 第一次使用时分配, -1 表示尚未分配
+static _Thread_local int scheduleLane = -1;
+static atomic_int scheduleLanes = 0;
+
+
+/**
+ * @brief Returns the lane of the calling thread.
+ *
+ * Every thread that records events is one simulated CPU. Its lane is assigned from a process wide counter the first time it is needed
+ * and kept in thread local storage, so a ScheduleTrace shared by several threads records each event on the lane of its own thread.
+ *
+ * @return The lane of the calling thread.
+ */
+int scheduleTraceLane() {
+    if (scheduleLane < 0) {
+        scheduleLane = atomic_fetch_add(&scheduleLanes, 1);
+    }
+    return scheduleLane;
+}
+
+/**
+ * @brief Opens a Chrome Trace Event file and allocates the event buffer.
+ *
+ * This function writes the beginning of the JSON document and allocates the event buffer once.
+ * A non-positive capacity falls back to SCHEDULE_TRACE_BUFFER. Events are recorded on the lane of the thread that records them, see scheduleTraceLane.
+ *
+ * @param path Path of the trace file, overwritten if it exists.
+ * @param capacity Number of events buffered before they are written to the file.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Pointer to the newly created ScheduleTrace structure, NULL if the file cannot be opened.
+ */
+ScheduleTrace *openScheduleTrace(const char *path, int capacity, Allocator *allocator) {
+
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    ScheduleTrace *trace = allocator->allocate(allocator, sizeof(ScheduleTrace));
+    assert(trace != NULL);
+    trace->capacity = capacity > 0 ? capacity : SCHEDULE_TRACE_BUFFER;
+    trace->events = allocator->allocate(allocator, trace->capacity * sizeof(ScheduleTraceEvent));
+    assert(trace->events != NULL);
+    trace->fp = fp;
+    trace->size = 0;
+    trace->clock = 0;
+    trace->emitted = 0;
+    pthread_mutex_init(&trace->lock, NULL);
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"scheduler\"}}");
+    return trace;
+}
+
+static void writeScheduleTrace(ScheduleTrace *trace);
+
+/**
+ * @brief Appends one event to the buffer; the caller holds the lock of the ScheduleTrace.
+ */
+static void appendScheduleEvent(ScheduleTrace *trace, ScheduleTraceKind kind, ProConBlock *proConBlock, double start, double duration) {
+
+    if (trace->size == trace->capacity) {
+        writeScheduleTrace(trace);
+    }
+    ScheduleTraceEvent *event = &trace->events[trace->size++];
+    event->kind = kind;
+    event->p_id = proConBlock->p_id;
+    event->p_priority = proConBlock->p_priority;
+    event->lane = scheduleTraceLane();
+    event->start = start;
+    event->duration = duration;
+    if (proConBlock->p_name != NULL) {
+        strncpy(event->p_name, proConBlock->p_name, SCHEDULE_TRACE_NAME - 1);
+        event->p_name[SCHEDULE_TRACE_NAME - 1] = '\0';
+    } else {
+        event->p_name[0] = '\0';
+    }
+}
+
+/**
+ * @brief Records one scheduling event.
+ *
+ * This function copies the event into the buffer; the process name is truncated into the event so the ProConBlock may be destroyed before the flush.
+ * The file is only written when the buffer is full, so the function performs no allocation and, most of the time, no I/O.
+ * The event is recorded on the lane of the calling thread under the lock of the ScheduleTrace.
+ *
+ * @param trace Pointer to the ScheduleTrace.
+ * @param kind The kind of the event.
+ * @param proConBlock Pointer to the ProConBlock the event belongs to.
+ * @param start Virtual time of the event in ticks.
+ * @param duration Length of a run event in ticks, ignored for the other kinds.
+ */
+void traceScheduleEvent(ScheduleTrace *trace, ScheduleTraceKind kind, ProConBlock *proConBlock, double start, double duration) {
+
+    pthread_mutex_lock(&trace->lock);
+    appendScheduleEvent(trace, kind, proConBlock, start, duration);
+    pthread_mutex_unlock(&trace->lock);
+}
+
+/**
+ * @brief Records an instant event at the current virtual clock of the ScheduleTrace.
+ *
+ * The clock is read under the same lock as the event is recorded, so the event cannot fall between the run and end events of another thread.
+ *
+ * @param trace Pointer to the ScheduleTrace.
+ * @param kind The kind of the event.
+ * @param proConBlock Pointer to the ProConBlock the event belongs to.
+ */
+void traceScheduleInstant(ScheduleTrace *trace, ScheduleTraceKind kind, ProConBlock *proConBlock) {
+
+    pthread_mutex_lock(&trace->lock);
+    appendScheduleEvent(trace, kind, proConBlock, trace->clock, 0);
+    pthread_mutex_unlock(&trace->lock);
+}
+
+/**
+ * @brief Records a time slice executed by the scheduler.
+ *
+ * This function records a run event starting at the virtual clock of the ScheduleTrace and advances the clock by the executed time.
+ * It then records how the slice ended, derived from the state runningProConBlockTask and executeOver leave behind:
+ * suspended_ready or terminated means the ProConBlock finished, suspended_blocked means its time slice expired, blocked means it waits for an event.
+ * Both events and the clock update happen under one lock, so threads sharing the ScheduleTrace never interleave inside a slice.
+ *
+ * @param trace Pointer to the ScheduleTrace.
+ * @param proConBlock Pointer to the ProConBlock that has just run.
+ * @param executed Time executed in this slice, in ticks.
+ */
+void traceProConBlockSlice(ScheduleTrace *trace, ProConBlock *proConBlock, double executed) {
+
+    pthread_mutex_lock(&trace->lock);
+    appendScheduleEvent(trace, trace_run, proConBlock, trace->clock, executed);
+    trace->clock += executed;
+
+    switch (proConBlock->p_state) {
+        case suspended_ready:
+        case terminated:
+            appendScheduleEvent(trace, trace_terminate, proConBlock, trace->clock, 0);
+            break;
+        case suspended_blocked:
+            appendScheduleEvent(trace, trace_preempt, proConBlock, trace->clock, 0);
+            break;
+        case blocked:
+        case waiting:
+            appendScheduleEvent(trace, trace_block, proConBlock, trace->clock, 0);
+            break;
+        default:
+            break;
+    }
+    pthread_mutex_unlock(&trace->lock);
+}
+
+/**
+ * @brief Writes a string as a JSON string body, escaping quotes, backslashes and control characters.
+ *
+ * @param fp The file to write to.
+ * @param string The string to be written.
+ */
+static void writeJsonString(FILE *fp, const char *string) {
+    for (const char *c = string; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', fp);
+            fputc(*c, fp);
+        } else if ((unsigned char) *c < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char) *c);
+        } else {
+            fputc(*c, fp);
+        }
+    }
+}
+
+/**
+ * @brief Writes all buffered events to the trace file and empties the buffer; the caller holds the lock of the ScheduleTrace.
+ *
+ * Run events become complete events ("ph":"X") named after the process, the other kinds become thread scoped instant events ("ph":"i").
+ * Every event carries the process ID and priority in its args.
+ *
+ * @param trace Pointer to the ScheduleTrace.
+ */
+static void writeScheduleTrace(ScheduleTrace *trace) {
+
+    for (int i = 0; i < trace->size; ++i) {
+        ScheduleTraceEvent *event = &trace->events[i];
+        fprintf(trace->fp, ",\n{\"name\":\"");
+        if (event->kind == trace_run) {
+            writeJsonString(trace->fp, event->p_name);
+        } else {
+            fprintf(trace->fp, "%s", traceKindToString(event->kind));
+        }
+        fprintf(trace->fp, "\",\"cat\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+                traceKindToString(event->kind), event->lane, event->start * SCHEDULE_TRACE_TICK_US);
+        if (event->kind == trace_run) {
+            fprintf(trace->fp, ",\"ph\":\"X\",\"dur\":%.3f", event->duration * SCHEDULE_TRACE_TICK_US);
+        } else {
+            fprintf(trace->fp, ",\"ph\":\"i\",\"s\":\"t\"");
+        }
+        fprintf(trace->fp, ",\"args\":{\"p_id\":%d,\"p_name\":\"", event->p_id);
+        writeJsonString(trace->fp, event->p_name);
+        fprintf(trace->fp, "\",\"priority\":\"%s\"}}", proPriorityToString(event->p_priority));
+    }
+    trace->emitted += trace->size;
+    trace->size = 0;
+}
+
+/**
+ * @brief Writes all buffered events to the trace file and empties the buffer.
+ *
+ * @param trace Pointer to the ScheduleTrace.
+ */
+void flushScheduleTrace(ScheduleTrace *trace) {
+
+    pthread_mutex_lock(&trace->lock);
+    writeScheduleTrace(trace);
+    pthread_mutex_unlock(&trace->lock);
+}
+
+/**
+ * @brief Flushes the remaining events, closes the JSON document and destroys the ScheduleTrace.
+ *
+ * No thread may still have the ScheduleTrace attached.
+ *
+ * @param trace Pointer to the ScheduleTrace to be closed.
+ * @param allocator Pointer to the Allocator structure used for memory management.
+ * @return Boolean value indicating whether the trace file was written without error.
+ */
+_Bool closeScheduleTrace(ScheduleTrace *trace, Allocator *allocator) {
+
+    if (trace == NULL) {
+        return false;
+    }
+    flushScheduleTrace(trace);
+    fprintf(trace->fp, "\n]}\n");
+    _Bool flag = ferror(trace->fp) == 0;
+    flag = fclose(trace->fp) == 0 && flag;
+
+    pthread_mutex_destroy(&trace->lock);
+    allocator->deallocate(allocator, trace->events, trace->capacity * sizeof(ScheduleTraceEvent));
+    allocator->deallocate(allocator, trace, sizeof(ScheduleTrace));
+    return flag;
+}
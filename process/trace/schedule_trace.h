@@ -0,0 +1,82 @@
+/*
+ User: Redskaber
+ Date: 2024/1/17
+ Time: 15:08
+*/
+#pragma once
+#ifndef OPERATORSYSTEM_SCHEDULE_TRACE_H
+#define OPERATORSYSTEM_SCHEDULE_TRACE_H
+/*
+ * 调度时间线导出(Chrome Trace Event 格式, chrome://tracing 与 ui.perfetto.dev 均可打开)
+        run        -> "ph":"X" 区间事件, 持续时间 = 本次执行的时间
+        preempt    -> "ph":"i" 时间片用完被换下
+        block      -> "ph":"i" 因等待资源等被阻塞
+        terminate  -> "ph":"i" 执行完成
+        每个 CPU 对应一条 lane(tid): 调度线程就是模拟的 CPU, 第一次 attachScheduleTrace 或记录事件时分配 lane,
+        lane 保存在线程局部变量中, 之后挂接的时间线都记录在这条 lane 上。时间使用虚拟时钟, 1 tick 显示为 1 ms。
+        同一个时间线可以挂接到多个线程: 缓冲区、虚拟时钟和文件由时间线内的互斥锁保护, 每个事件记录它所在线程的 lane。
+
+        事件先写入打开时一次性分配的缓冲区(进程名截断复制, 不保存指针), 缓冲区满时才格式化写入文件,
+        记录事件的热路径上没有任何内存分配。
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../process_scheduling.h"
+
+#define SCHEDULE_TRACE_BUFFER 4096
+#define SCHEDULE_TRACE_NAME 24
+#define SCHEDULE_TRACE_TICK_US 1000
+
+typedef enum ScheduleTraceKind {
+    trace_run,
+    trace_preempt,
+    trace_block,
+    trace_terminate,
+} ScheduleTraceKind;
+
+typedef struct ScheduleTraceEvent {
+    ScheduleTraceKind kind;
+    int p_id;
+    ProcessPriority p_priority;
+    int lane;
+    double start;
+    double duration;
+    char p_name[SCHEDULE_TRACE_NAME];
+} ScheduleTraceEvent;
+
+typedef struct ScheduleTrace {
+    FILE *fp;
+    ScheduleTraceEvent *events;
+    int capacity;
+    int size;
+    double clock;           // 虚拟时钟(tick)
+    long long emitted;      // 已写入文件的事件数
+    pthread_mutex_t lock;   // 保护 events / size / clock / fp, 多个线程可共享同一个时间线
+} ScheduleTrace;
+
+
+#define traceKindToString(kind) _Generic((kind),         \
+    enum ScheduleTraceKind:                              \
+        (kind == trace_run) ? "run" :                    \
+        (kind == trace_preempt) ? "preempt" :            \
+        (kind == trace_block) ? "block" :                \
+        (kind == trace_terminate) ? "terminate" : "UNKNOWN" \
+)
+
+
+extern ScheduleTrace *openScheduleTrace(const char *path, int capacity, Allocator *allocator);
+
+extern int scheduleTraceLane();
+
+extern void traceScheduleEvent(ScheduleTrace *trace, ScheduleTraceKind kind, ProConBlock *proConBlock, double start, double duration);
+
+extern void traceScheduleInstant(ScheduleTrace *trace, ScheduleTraceKind kind, ProConBlock *proConBlock);
+
+extern void traceProConBlockSlice(ScheduleTrace *trace, ProConBlock *proConBlock, double executed);
+
+extern void flushScheduleTrace(ScheduleTrace *trace);
+
+extern _Bool closeScheduleTrace(ScheduleTrace *trace, Allocator *allocator);
+
+#endif //OPERATORSYSTEM_SCHEDULE_TRACE_H
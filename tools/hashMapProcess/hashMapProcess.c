@@ -0,0 +1,257 @@
+/*
+ User: Redskaber
+ Date: 2024/1/8
+ Time: 20:14
+*/
+#include "hashMapProcess.h"
+
+/**
+ * @brief Creates a new HashMapProcess structure.
+ *
+ * This function allocates memory for a new HashMapProcess structure and initializes its fields.
+ * The size is rounded up to a power of two so that a slot can be found with a mask instead of a modulo.
+ * All slots of the table start empty (value NULL).
+ *
+ * @param size The initial size of the HashMapProcess.
+ * @return Pointer to the newly created HashMapProcess structure.
+ */
+HashMapProcess *createHashMapProcess(int size) {
+    int capacity = HASH_MAP_PROCESS_INIT_SIZE;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+
+    HashMapProcess *map = (HashMapProcess *) malloc(sizeof(HashMapProcess));
+    map->size = capacity;
+    map->member = 0;
+    map->table = (HashNodeProcess *) calloc(capacity, sizeof(HashNodeProcess));
+    return map;
+}
+
+/**
+ * @brief Computes the home slot for a process id.
+ *
+ * This function uses Fibonacci hashing, so consecutive process ids are spread over the whole table.
+ *
+ * @param key The process id.
+ * @param size The size of the HashMapProcess (power of two).
+ * @return The home slot of the key.
+ */
+static inline unsigned int hash(int key, int size) {
+    return ((unsigned int) key * 2654435769u) & (unsigned int) (size - 1);
+}
+
+/**
+ * @brief Doubles the table of a HashMapProcess and re-inserts all occupied slots.
+ *
+ * @param map Pointer to the HashMapProcess to be grown.
+ */
+static void upCapacity(HashMapProcess *map) {
+    HashNodeProcess *oldTable = map->table;
+    int oldSize = map->size;
+
+    map->size = oldSize << 1;
+    map->table = (HashNodeProcess *) calloc(map->size, sizeof(HashNodeProcess));
+    for (int i = 0; i < oldSize; ++i) {
+        if (oldTable[i].value != NULL) {
+            unsigned int index = hash(oldTable[i].key, map->size);
+            while (map->table[index].value != NULL) {
+                index = (index + 1) & (map->size - 1);
+            }
+            map->table[index] = oldTable[i];
+        }
+    }
+    free(oldTable);
+}
+
+/**
+ * @brief Inserts a process id and its pointer into a HashMapProcess.
+ *
+ * This function probes linearly from the home slot of the key.
+ * If the key is already present, its value is replaced; otherwise the value is stored in the first empty slot.
+ * The table is doubled before the load factor would exceed one half, which keeps probe sequences short.
+ *
+ * @param map Pointer to the HashMapProcess where the key-value pair will be inserted.
+ * @param key The process id.
+ * @param value The pointer to be stored, must not be NULL.
+ */
+void insertProcess(HashMapProcess *map, int key, void *value) {
+    if (value == NULL) {
+        return;
+    }
+    if ((map->member + 1) * 2 > map->size) {
+        upCapacity(map);
+    }
+
+    unsigned int index = hash(key, map->size);
+    while (map->table[index].value != NULL) {
+        if (map->table[index].key == key) {
+            map->table[index].value = value;
+            return;
+        }
+        index = (index + 1) & (map->size - 1);
+    }
+    map->table[index].key = key;
+    map->table[index].value = value;
+    map->member += 1;
+}
+
+/**
+ * @brief Adds a process id and its pointer to a HashMapProcess without replacing other pointers of the same id.
+ *
+ * The HashMapProcess is used as a multimap: several ProConBlocks may share a process id, and each of them gets its own slot,
+ * so removing one of them with removeProcessValue leaves the others reachable. Adding a pair that is already present changes nothing.
+ * The table is doubled before the load factor would exceed one half, as in insertProcess.
+ *
+ * @param map Pointer to the HashMapProcess where the key-value pair will be added.
+ * @param key The process id.
+ * @param value The pointer to be stored, must not be NULL.
+ */
+void appendProcess(HashMapProcess *map, int key, void *value) {
+    if (value == NULL) {
+        return;
+    }
+    if ((map->member + 1) * 2 > map->size) {
+        upCapacity(map);
+    }
+
+    unsigned int index = hash(key, map->size);
+    while (map->table[index].value != NULL) {
+        if (map->table[index].key == key && map->table[index].value == value) {
+            return;
+        }
+        index = (index + 1) & (map->size - 1);
+    }
+    map->table[index].key = key;
+    map->table[index].value = value;
+    map->member += 1;
+}
+
+/**
+ * @brief Retrieves the pointer associated with a process id.
+ *
+ * If several pointers share the process id, the first one in probe order is returned, see nextProcess.
+ *
+ * @param map Pointer to the HashMapProcess from which the value will be retrieved.
+ * @param key The process id.
+ * @return The stored pointer if found, NULL otherwise.
+ */
+void *getProcess(HashMapProcess *map, int key) {
+    unsigned int index = hash(key, map->size);
+    while (map->table[index].value != NULL) {
+        if (map->table[index].key == key) {
+            return map->table[index].value;
+        }
+        index = (index + 1) & (map->size - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Iterates over the pointers stored under a process id.
+ *
+ * The pointers are returned in probe order; passing the previous result continues the iteration.
+ *
+ * @param map Pointer to the HashMapProcess.
+ * @param key The process id.
+ * @param value The previously returned pointer, NULL to start with the first one.
+ * @return The next pointer stored under the key, NULL when there is none.
+ */
+void *nextProcess(HashMapProcess *map, int key, void *value) {
+    unsigned int index = hash(key, map->size);
+    _Bool found = value == NULL;
+    while (map->table[index].value != NULL) {
+        if (map->table[index].key == key) {
+            if (found) {
+                return map->table[index].value;
+            }
+            found = map->table[index].value == value;
+        }
+        index = (index + 1) & (map->size - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Empties a slot and shifts the following entries of its probe run backwards.
+ *
+ * Lookups therefore never need tombstones and the table does not degrade after many kills.
+ *
+ * @param map Pointer to the HashMapProcess.
+ * @param index The occupied slot to be emptied.
+ */
+static void removeSlot(HashMapProcess *map, unsigned int index) {
+    unsigned int mask = (unsigned int) (map->size - 1);
+    unsigned int hole = index;
+    unsigned int next = (hole + 1) & mask;
+    while (map->table[next].value != NULL) {
+        unsigned int home = hash(map->table[next].key, map->size);
+        // move the entry if its home slot is not inside (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->table[hole] = map->table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    map->table[hole].key = 0;
+    map->table[hole].value = NULL;
+    map->member -= 1;
+}
+
+/**
+ * @brief Removes a process id from a HashMapProcess.
+ *
+ * This function empties the first slot of the key found in probe order, see removeSlot.
+ *
+ * @param map Pointer to the HashMapProcess from which the key will be removed.
+ * @param key The process id.
+ * @return The removed pointer if found, NULL otherwise.
+ */
+void *removeProcess(HashMapProcess *map, int key) {
+    unsigned int mask = (unsigned int) (map->size - 1);
+    unsigned int index = hash(key, map->size);
+    while (map->table[index].value != NULL && map->table[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    void *value = map->table[index].value;
+    if (value != NULL) {
+        removeSlot(map, index);
+    }
+    return value;
+}
+
+/**
+ * @brief Removes one key-value pair from a HashMapProcess, keeping the other pointers of the same process id.
+ *
+ * @param map Pointer to the HashMapProcess from which the pair will be removed.
+ * @param key The process id.
+ * @param value The pointer to be removed.
+ * @return Boolean value indicating whether the pair was found and removed.
+ */
+_Bool removeProcessValue(HashMapProcess *map, int key, void *value) {
+    unsigned int mask = (unsigned int) (map->size - 1);
+    unsigned int index = hash(key, map->size);
+    while (map->table[index].value != NULL) {
+        if (map->table[index].key == key && map->table[index].value == value) {
+            removeSlot(map, index);
+            return true;
+        }
+        index = (index + 1) & mask;
+    }
+    return false;
+}
+
+/**
+ * @brief Destroys a HashMapProcess structure.
+ *
+ * This function deallocates the table and the HashMapProcess structure itself.
+ * The stored pointers are owned by the caller and are not released.
+ *
+ * @param map Pointer to the HashMapProcess structure to be destroyed.
+ */
+void destroyHashMapProcess(HashMapProcess *map) {
+    if (map != NULL) {
+        free(map->table);
+        free(map);
+    }
+}
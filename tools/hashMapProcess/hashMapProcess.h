@@ -0,0 +1,45 @@
+/*
+ User: Redskaber
+ Date: 2024/1/8
+ Time: 20:14
+*/
+#ifndef OPERATORSYSTEM_HASHMAPPROCESS_H
+#define OPERATORSYSTEM_HASHMAPPROCESS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HASH_MAP_PROCESS_INIT_SIZE 16
+
+typedef struct HashNodeProcess {
+    int key;
+    void *value;
+} HashNodeProcess;
+
+// 开放寻址(线性探测), value == NULL 表示空槽
+// insertProcess 覆盖同一 key 的值; appendProcess 按多重映射使用, 同一 key 的每个值各占一个槽, 用 removeProcessValue 删除其中一个
+typedef struct HashMapProcess {
+    int size;
+    int member;
+    HashNodeProcess *table;
+} HashMapProcess;
+
+extern HashMapProcess *createHashMapProcess(int size);
+
+extern void insertProcess(HashMapProcess *map, int key, void *value);
+
+extern void appendProcess(HashMapProcess *map, int key, void *value);
+
+extern void *getProcess(HashMapProcess *map, int key);
+
+extern void *nextProcess(HashMapProcess *map, int key, void *value);
+
+extern void *removeProcess(HashMapProcess *map, int key);
+
+extern _Bool removeProcessValue(HashMapProcess *map, int key, void *value);
+
+extern void destroyHashMapProcess(HashMapProcess *map);
+
+#endif //OPERATORSYSTEM_HASHMAPPROCESS_H